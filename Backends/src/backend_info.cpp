@@ -26,6 +26,7 @@
 #include "gambit/Backends/backend_info.hpp"
 #include "gambit/Utils/util_functions.hpp"
 #include "gambit/Utils/python_interpreter.hpp"
+#include "gambit/Utils/startup_profiler.hpp"
 #include "gambit/Logs/logger.hpp"
 
 #ifdef HAVE_MATHEMATICA
@@ -311,6 +312,7 @@ namespace Gambit
   /// Attempt to load a backend library.
   int Backends::backend_info::loadLibrary(const str& be, const str& ver, const str& sv, bool with_BOSS, const str& lang)
   {
+    Utils::profile_phase phase("Backend loading: " + be + " " + ver);
     try
     {
       // Initialize variable to avoid issues later
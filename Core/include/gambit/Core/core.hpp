@@ -163,6 +163,9 @@ namespace Gambit
     /// Flag recording whether an inifile has been supplied
     bool found_inifile;
 
+    /// Flag to report the timing of the start-up phases
+    bool profile_startup;
+
     /// Command-line info function
     void bail(int mpirank = -1);
 
@@ -41,6 +41,7 @@
 
 #include "gambit/Core/core.hpp"
 #include "gambit/Core/error_handlers.hpp"
+#include "gambit/Core/resolution_cache.hpp"
 #include "gambit/Core/resolution_utilities.hpp"
 #include "gambit/Core/yaml_parser.hpp"
 #include "gambit/Printers/baseprinter.hpp"
@@ -133,6 +134,12 @@ namespace Gambit
         /// Print a single target vertex.
         void printObsLike(VertexID, const int);
 
+        /// Collect the printable functors needed to compute a list of target vertices, in order and without duplicates.
+        std::vector<functor*> getPrintList(const std::vector<VertexID>&);
+
+        /// Print the results of a list of functors obtained from getPrintList.
+        void printFunctors(const std::vector<functor*>&, const int);
+
         /// Getter for print_timing flag (used by LikelihoodContainer)
         bool printTiming();
 
@@ -169,6 +176,11 @@ namespace Gambit
         /// Reset all active functors and delete existing results.
         void resetAll();
 
+        /// Reset only the active functors downstream of the given functors (plus any that invalidated the
+        /// last point, or that must always be recomputed), keeping the results of all others and just
+        /// resetting their printing flags.
+        void resetDownstreamOf(const std::set<functor*>&);
+
         /// Check for unused rules and options
         void checkForUnusedRules();
 
@@ -236,6 +248,27 @@ namespace Gambit
         /// scanned over.
         std::vector<std::pair<VertexID,bool>> closestCandidateForModel(std::vector<std::pair<VertexID,bool>> candidates);
 
+        /// Find the functors that incremental recomputation must recompute at every point
+        void findAlwaysRecompute();
+
+        /// Hash of all inputs that the dependency resolution depends on (empty if these cannot be determined)
+        str resolutionCacheKey();
+
+        /// Obtain a cached resolution to replay, either from the cache file (MPI master process) or from
+        /// the MPI master process (all other processes, which wait for the master to resolve)
+        void loadResolutionCache(const str&);
+
+        /// Complete the recorded resolution and save it to the cache file (MPI master process only)
+        void saveResolutionCache(const str&);
+
+        /// Send the resolution of the MPI master process to the other processes waiting in
+        /// loadResolutionCache, or tell them that it failed
+        void shareResolutionRecord(bool);
+
+        /// Check that the replayed resolution is consistent with the current functors and rules, and
+        /// restore the rule matches that it contains
+        bool applyResolutionRecord();
+
         //
         // Private data members
         //
@@ -301,6 +334,21 @@ namespace Gambit
         /// Global flag for triggering printing of unitCubeParameters
         bool print_unitcube = false;
 
+        /// Choices made during resolution, recorded for or replayed from the resolution cache
+        ResolutionRecord record;
+
+        /// Flags indicating whether choices are being recorded for or replayed from the resolution cache
+        /// @{
+        bool recording = false;
+        bool replaying = false;
+        /// @}
+
+        /// Functors that incremental recomputation must recompute at every point, and whether they have been found yet
+        /// @{
+        std::set<VertexID> always_recompute;
+        bool always_recompute_found = false;
+        /// @}
+
   };
   }
 }
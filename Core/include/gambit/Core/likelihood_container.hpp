@@ -62,6 +62,10 @@ namespace Gambit
       /// Graph vertices corresponding to additional functors not in ObsLike part of yaml file
       std::vector<DRes::VertexID> aux_vertices;
 
+      /// Functors to print at each point, i.e. the printable functors that the target and
+      /// auxiliary vertices depend on, in order and without duplicates
+      std::vector<functor*> print_list;
+
       /// Bound dependency resolver object
       DRes::DependencyResolver &dependencyResolver;
 
@@ -74,6 +78,12 @@ namespace Gambit
       /// Map of scanned model names to primary model functors
       std::map<str, primary_model_functor *> functorMap;
 
+      /// Only recompute functors downstream of parameters that changed since the previous point?
+      bool incremental_recomputation;
+
+      /// Primary model functors with parameter values that changed since the previous point
+      std::set<functor*> changed_model_functors;
+
       /// Primary value of the log likelihood at which a point is considered so unlikely that it can be ruled out (invalid).
       double min_valid_lnlike;
 
@@ -0,0 +1,99 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Persistent cache of dependency resolution
+///  results.
+///
+///  The dependency resolver records the choices
+///  it makes (which functors resolve each entry
+///  in the resolution queue, which backend
+///  functions resolve each backend requirement,
+///  and which rules each functor matched), so
+///  that later runs with identical inputs (and
+///  the other MPI processes of the same run) can
+///  replay them without redoing the rule
+///  matching.  Cache files are keyed by a hash
+///  of the YAML file, the build of the
+///  executable, the models being scanned and the
+///  status of every functor.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include "gambit/Utils/util_types.hpp"
+
+namespace Gambit
+{
+
+  namespace DRes
+  {
+
+    /// Map from vertex or functor index to a list of indices
+    typedef std::map<std::size_t, std::vector<std::size_t>> index_map;
+
+    /// Record of the choices made during a dependency resolution
+    struct ResolutionRecord
+    {
+      /// Hash of the inputs that the resolution depends on
+      str key;
+
+      /// Vertices used to resolve each entry of the resolution queue, in the order that the queue was processed
+      std::vector<std::vector<std::size_t>> queue_solutions;
+
+      /// Backend functors (indices into the backend functor list of the core) used to resolve the backend
+      /// requirements of each vertex, in the order in which they were resolved
+      index_map backend_solutions;
+
+      /// Backends required to fulfil the backend requirements and class loading of all active vertices
+      std::vector<std::vector<sspair>> backends_required;
+
+      /// ObsLike entries, module rules and backend rules (indices into the lists of the ini file) matched by each vertex
+      /// @{
+      index_map matched_observables;
+      index_map matched_module_rules;
+      index_map matched_backend_rules;
+      /// @}
+
+      /// Backend rules matched by each backend functor
+      index_map backend_functor_matched_backend_rules;
+
+      /// Erase the record
+      void clear();
+
+      /// Serialise the record as YAML
+      str to_string() const;
+
+      /// Read the record from a YAML string; returns false if it could not be parsed
+      bool from_string(const str&);
+    };
+
+    /// Hash a string, returning a fixed-width hexadecimal digest
+    str resolution_hash(const str&);
+
+    /// Identify the build of the running executable
+    str build_id();
+
+    /// Path of the cache file for a given key
+    str resolution_cache_file(const str&);
+
+    /// Read the cache file for a given key into a string; returns false if there is none
+    bool read_resolution_cache(const str&, str&);
+
+    /// Write a string to the cache file for a given key
+    void write_resolution_cache(const str&, const str&);
+
+  }
+
+}
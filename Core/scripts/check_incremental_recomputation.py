@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+#
+#  GAMBIT: Global and Modular BSM Inference Tool
+#*********************************************
+#  \file
+#
+#  Regression check for the likelihood option
+#  'incremental_recomputation'. Runs the same
+#  scans with and without it, and checks that
+#  the printed output is identical.
+#
+#  usage: check_incremental_recomputation.py <gambit executable> [work directory]
+#
+#*********************************************
+#
+#  Authors (add name and date if you modify):
+#
+#  \author The GAMBIT Collaboration
+#  \date 2026 Oct
+#
+#*********************************************
+
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# A user likelihood that is a pure function of its inputs, except for the call counter it outputs
+user_lib_source = """
+static int n_calls = 0;
+double user_loglike(const int n_inputs, const double *input, const int n_outputs, double *output)
+{
+    double loglike = 0;
+    for (int i = 0; i < n_inputs; i++) loglike -= 0.5*input[i]*input[i] + 0.1*i*input[i];
+    output[0] = ++n_calls;
+    return loglike;
+}
+"""
+
+yaml_template = """
+UserModel:
+  p1:
+    name: x1
+    prior_type: flat
+    range: {range1}
+  p2:
+    name: x2
+    prior_type: flat
+    range: {range2}
+UserLogLikes:
+  loglike:
+    lang: c
+    user_lib: {user_lib}
+    func_name: user_loglike
+    input: [x1, x2]
+    output: [n_calls]
+Printer:
+  printer: ascii
+  options:
+    output_file: "results.dat"
+    delete_file_on_restart: true
+Scanner:
+  use_scanner: grid
+  scanners:
+    grid:
+      plugin: grid
+      grid_pts: [4, 4]
+Logger:
+  redirection:
+    [Default]: "default.log"
+KeyValues:
+  default_output_path: "{output_path}"
+  likelihood:
+    incremental_recomputation: {incremental}
+{extra}
+"""
+
+# Scans to check: name, parameter ranges, extra likelihood options, and whether the call counter must match.
+# The zero-width ranges make every point identical, so that after the first point the incremental runs
+# only recompute what must always be recomputed.
+scans = [
+  ("varying parameters",           "[0.0, 3.0]", "[-1.0, 1.0]", "", True),
+  ("repeated point",               "[1.0, 1.0]", "[0.5, 0.5]",  "", False),
+  ("repeated point, stateful lib", "[1.0, 1.0]", "[0.5, 0.5]",  "    always_recompute: [output]", True),
+]
+
+# Columns that differ between any two runs
+ignored_columns = ["scanID"]
+
+
+def read_ascii_output(path):
+    """Return the ascii printer output as a dict of column name -> list of values."""
+    names = []
+    with open(path + "_info") as f:
+        for line in f:
+            if line.startswith("Column"):
+                names.append(line.split(":", 1)[1].strip())
+    columns = dict((name, []) for name in names)
+    with open(path) as f:
+        for line in f:
+            values = line.split()
+            if len(values) != len(names):
+                raise RuntimeError("Unexpected number of columns in " + path)
+            for name, value in zip(names, values):
+                columns[name].append(float(value))
+    return columns
+
+
+def run_scan(gambit, workdir, name, incremental, **fields):
+    """Run one scan, returning its output."""
+    rundir = os.path.join(workdir, name.replace(" ", "_").replace(",", "") + ("_incremental" if incremental else "_full"))
+    os.makedirs(rundir)
+    yaml_file = os.path.join(rundir, "scan.yaml")
+    with open(yaml_file, "w") as f:
+        f.write(yaml_template.format(output_path=rundir, incremental=str(incremental).lower(), **fields))
+    with open(os.path.join(rundir, "gambit.log"), "w") as log:
+        status = subprocess.call([gambit, "-rf", yaml_file], stdout=log, stderr=subprocess.STDOUT)
+    if status != 0:
+        raise RuntimeError("GAMBIT failed for scan '" + name + "'; see " + os.path.join(rundir, "gambit.log"))
+    return read_ascii_output(os.path.join(rundir, "samples", "results.dat"))
+
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: check_incremental_recomputation.py <gambit executable> [work directory]")
+        return 2
+    gambit = os.path.abspath(sys.argv[1])
+    workdir = os.path.abspath(sys.argv[2]) if len(sys.argv) > 2 else tempfile.mkdtemp(prefix="gambit_incremental_check_")
+    if os.path.exists(workdir): shutil.rmtree(workdir)
+    os.makedirs(workdir)
+
+    # Build the user likelihood library
+    user_lib = os.path.join(workdir, "user_loglike.so")
+    with open(os.path.join(workdir, "user_loglike.c"), "w") as f:
+        f.write(user_lib_source)
+    subprocess.check_call([os.environ.get("CC", "cc"), "-shared", "-fPIC", "-o", user_lib, os.path.join(workdir, "user_loglike.c")])
+
+    # GAMBIT must run from its own directory
+    os.chdir(os.path.dirname(gambit))
+
+    failures = 0
+    for name, range1, range2, extra, compare_calls in scans:
+        fields = dict(range1=range1, range2=range2, user_lib=user_lib, extra=extra)
+        full = run_scan(gambit, workdir, name, False, **fields)
+        incremental = run_scan(gambit, workdir, name, True, **fields)
+
+        problems = []
+        for column in sorted(full):
+            if column in ignored_columns or (column == "output::n_calls" and not compare_calls): continue
+            if column not in incremental:
+                problems.append("column '" + column + "' is missing")
+            elif full[column] != incremental[column]:
+                problems.append("column '" + column + "' differs: " + str(full[column]) + " vs " + str(incremental[column]))
+        if not compare_calls and max(incremental["output::n_calls"]) != 1:
+            problems.append("the user likelihood was recomputed at repeated points, so the incremental path was not exercised")
+
+        if problems:
+            failures += 1
+            print("FAILED: " + name)
+            for problem in problems: print("  " + problem)
+        else:
+            print("passed: " + name + " (" + str(len(full["pointID"])) + " points)")
+
+    if failures == 0: shutil.rmtree(workdir)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -44,6 +44,7 @@
 #include "gambit/ScannerBit/plugin_loader.hpp"
 #include "gambit/Utils/stream_overloads.hpp"
 #include "gambit/Utils/util_functions.hpp"
+#include "gambit/Utils/startup_profiler.hpp"
 #include "gambit/Utils/version.hpp"
 #include "gambit/cmake/cmake_variables.hpp"
 
@@ -70,7 +71,8 @@ namespace Gambit
         outprec(8)
         /* command line flags */
         ,
-        processed_options(false), show_runorder(false), show_backends(false), resume(true), verbose_flag(false), found_inifile(false)
+        processed_options(false), show_runorder(false), show_backends(false), resume(true), verbose_flag(false), found_inifile(false),
+        profile_startup(false)
   {
   }
 
@@ -130,6 +132,7 @@ namespace Gambit
               "\n                         Default behaviour in the absence of this option is"
               "\n                         to attempt to resume the scan from any existing   "
               "\n                         output.                                           "
+              "\n   --profile-startup     Report the time spent in each phase of start-up   "
               "\n"
            << endl
            << endl;
@@ -154,7 +157,8 @@ namespace Gambit
         {"version", no_argument, 0, 1}, /*1 is just a unique integer key to identify this argument*/
         {"verbose", no_argument, 0, 'v'}, {"help", no_argument, 0, 'h'},
         {"dryrun", no_argument, 0, 'd'},  {"backends", no_argument, 0, 'b'},
-        {"restart", no_argument, 0, 'r'}, {0, 0, 0, 0},
+        {"restart", no_argument, 0, 'r'}, {"profile-startup", no_argument, 0, 2},
+        {0, 0, 0, 0},
     };
 
     // Must at least have one argument.
@@ -171,6 +175,10 @@ namespace Gambit
         logger().disable();
         throw SilentShutdownException();
       }
+      case 2:
+        // Report the time spent in each phase of start-up
+        profile_startup = true;
+        break;
       case 'v':
         // Turn on verbose mode
         verbose_flag = true;
@@ -321,6 +329,8 @@ namespace Gambit
   /// Check the capability and model databases for conflicts and missing descriptions
   void gambit_core::check_databases()
   {
+    Utils::profile_phase phase("Description database checks");
+
     // Loop through registered capabilities and try to find their descriptions (potentially from many files, but for now just checking one)
     DescriptionDatabase description_file(input_capability_descriptions); // Load descriptions file
     // std::set<str> parsed_descriptions; // Set of capabilities whose description we have parsed
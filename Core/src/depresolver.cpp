@@ -49,6 +49,8 @@
 #include "gambit/Utils/version.hpp"
 #include "gambit/Utils/bibtex_functions.hpp"
 #include "gambit/Utils/citation_keys.hpp"
+#include "gambit/Utils/startup_profiler.hpp"
+#include "gambit/Utils/mpiwrapper.hpp"
 #include "gambit/Logs/logger.hpp"
 #include "gambit/Backends/backend_singleton.hpp"
 #include "gambit/cmake/cmake_variables.hpp"
@@ -267,14 +269,54 @@ namespace Gambit
       logger() << EOM;
 
       // Activate functors compatible with model we scan over (and deactivate the rest)
-      makeFunctorsModelCompatible();
+      {
+        Utils::profile_phase phase("Model compatibility");
+        makeFunctorsModelCompatible();
+      }
+
+      // Retrieve the choices made by a previous resolution with identical inputs, if available.
+      // With MPI, only the master process resolves; the others replay its resolution.
+      const bool use_cache = boundIniFile->getValueOrDef<bool>(false, "dependency_resolution", "resolution_cache");
+      str cache_key;
+      if (use_cache)
+      {
+        Utils::profile_phase phase("Resolution cache lookup");
+        cache_key = resolutionCacheKey();
+        loadResolutionCache(cache_key);
+      }
+
+      try
+      {
+        // Generate dependency tree (the core of the dependency resolution)
+        {
+          Utils::profile_phase phase(replaying ? "Dependency tree replay" : "Dependency tree generation");
+          generateTree(resolutionQueue);
+        }
 
-      // Generate dependency tree (the core of the dependency resolution)
-      generateTree(resolutionQueue);
+        // The backends required are normally worked out during backend resolution, so copy them from the cache.
+        if (replaying) backendsRequired = record.backends_required;
+
+        // Save the choices made, for use by later runs
+        if (use_cache)
+        {
+          Utils::profile_phase phase("Resolution cache update");
+          saveResolutionCache(cache_key);
+        }
+      }
+      catch (...)
+      {
+        // Do not leave the other processes waiting for the resolution of the master process
+        if (use_cache) shareResolutionRecord(false);
+        throw;
+      }
+      if (use_cache) shareResolutionRecord(true);
 
       // Find one execution order for activated vertices that is compatible
       // with dependency structure
-      function_order = run_topological_sort();
+      {
+        Utils::profile_phase phase("Topological sort");
+        function_order = run_topological_sort();
+      }
 
       // Loop manager initialization: Notify them about their nested functions
       for (const std::pair<const VertexID, std::set<VertexID>>& keyvalpair : loopManagerMap)
@@ -293,7 +335,10 @@ namespace Gambit
       }
 
       // Initialise the printer object with a list of functors that are set to print
-      initialisePrinter();
+      {
+        Utils::profile_phase phase("Printer initialisation");
+        initialisePrinter();
+      }
 
       #ifdef HAVE_GRAPHVIZ
         // Generate graphviz plot if running in dry-run mode.
@@ -305,10 +350,13 @@ namespace Gambit
       #endif
 
       // Pre-compute the individually ordered vertex lists for each of the ObsLike entries.
-      std::vector<VertexID> order = getObsLikeOrder();
-      for(const auto& v : order)
       {
-        SortedParentVertices[v] = getSortedParentVertices(v, masterGraph, function_order);
+        Utils::profile_phase phase("ObsLike evaluation order");
+        std::vector<VertexID> order = getObsLikeOrder();
+        for(const auto& v : order)
+        {
+          SortedParentVertices[v] = getSortedParentVertices(v, masterGraph, function_order);
+        }
       }
 
       // Print list of backends required
@@ -663,6 +711,37 @@ namespace Gambit
       }
     }
 
+    /// Collect the printable functors needed to compute a list of target vertices, in order and without duplicates.
+    /// Functors with void results or nothing to print are left out, so that printing each point needs no
+    /// type comparisons or repeated visits to shared ancestors.  The printer IDs of the functors are already
+    /// bound to them by initialisePrinter.
+    std::vector<functor*> DependencyResolver::getPrintList(const std::vector<VertexID>& targets)
+    {
+      std::vector<functor*> print_list;
+      std::set<VertexID> seen;
+      for (const VertexID& target : targets)
+      {
+        if (SortedParentVertices.find(target) == SortedParentVertices.end())
+          core_error().raise(LOCAL_INFO, "Tried to print a function not in or not at top of dependency graph.");
+        for (const VertexID& v : SortedParentVertices.at(target))
+        {
+          if (not seen.insert(v).second) continue;
+          functor* f = masterGraph[v];
+          if (typeComp(f->type(), "void", *boundTEs)) continue;
+          if (not f->requiresPrinting() and not f->requiresTimingPrinting()) continue;
+          print_list.push_back(f);
+        }
+      }
+      return print_list;
+    }
+
+    /// Print the results of a list of functors obtained from getPrintList.
+    void DependencyResolver::printFunctors(const std::vector<functor*>& print_list, const int pointID)
+    {
+      // As in printObsLike, this prints the results of thread index 0 only.
+      for (functor* f : print_list) f->print(boundPrinter, pointID);
+    }
+
     /// Getter for print_timing flag (used by LikelihoodContainer)
     bool DependencyResolver::printTiming() { return print_timing; }
 
@@ -730,11 +809,81 @@ namespace Gambit
       }
     }
 
+    /// Reset only the active functors downstream of the given functors, keeping the results of all others.
+    void DependencyResolver::resetDownstreamOf(const std::set<functor*>& changed)
+    {
+      if (not always_recompute_found) findAlwaysRecompute();
+
+      // Find the vertices of the changed functors, and of those that must be recomputed at every point
+      std::set<VertexID> downstream;
+      std::queue<VertexID> to_visit;
+      graph_traits<MasterGraphType>::vertex_iterator vi, vi_end;
+      for (std::tie(vi, vi_end) = vertices(masterGraph); vi != vi_end; ++vi)
+      {
+        if (changed.find(masterGraph[*vi]) != changed.end() or always_recompute.find(*vi) != always_recompute.end())
+        {
+          downstream.insert(*vi);
+          to_visit.push(*vi);
+        }
+      }
+
+      // Collect everything that depends on them, directly or indirectly
+      graph_traits<MasterGraphType>::adjacency_iterator ai, ai_end;
+      while (not to_visit.empty())
+      {
+        VertexID v = to_visit.front();
+        to_visit.pop();
+        for (std::tie(ai, ai_end) = adjacent_vertices(v, masterGraph); ai != ai_end; ++ai)
+        {
+          if (downstream.insert(*ai).second) to_visit.push(*ai);
+        }
+      }
+
+      // Reset the downstream functors, and any functor still holding an invalid point exception from the
+      // last point, as its cached result cannot be reused. All other functors just need printing again.
+      for (std::tie(vi, vi_end) = vertices(masterGraph); vi != vi_end; ++vi)
+      {
+        functor* f = masterGraph[*vi];
+        if (not f->isActive()) continue;
+        if (downstream.find(*vi) != downstream.end() or f->retrieve_invalid_point_exception() != NULL) f->reset();
+        else f->resetPrinting();
+      }
+    }
+
 
     ////////////////////////////////////////////////////
     // Private definitions of DependencyResolver class
     ////////////////////////////////////////////////////
 
+    /// Find the active functors whose results cannot be reused at the next point even if no model
+    /// parameters upstream of them have changed, as they depend on state outside the dependency graph.
+    void DependencyResolver::findAlwaysRecompute()
+    {
+      // Functors named in the likelihood options, by capability or as module::function
+      const std::vector<str> listed = boundIniFile->getValueOrDef<std::vector<str>>(std::vector<str>(), "likelihood", "always_recompute");
+      auto is_listed = [&](functor* f)
+      {
+        return std::find(listed.begin(), listed.end(), f->capability()) != listed.end() or
+               std::find(listed.begin(), listed.end(), f->origin() + "::" + f->name()) != listed.end();
+      };
+
+      graph_traits<MasterGraphType>::vertex_iterator vi, vi_end;
+      for (std::tie(vi, vi_end) = vertices(masterGraph); vi != vi_end; ++vi)
+      {
+        functor* f = masterGraph[*vi];
+        if (not f->isActive()) continue;
+        // Backend functions keep their own state, and loop managers and nested functors are rerun
+        // within each point with results that depend on the loop iteration
+        if (not f->backendreqs().empty() or f->canBeLoopManager() or f->loopManagerCapability() != "none" or is_listed(f))
+        {
+          always_recompute.insert(*vi);
+          logger() << LogTags::dependency_resolver << LogTags::info << "Incremental recomputation: " << f->origin() << "::" << f->name()
+                   << " and everything downstream of it will be recomputed at every point." << EOM;
+        }
+      }
+      always_recompute_found = true;
+    }
+
     str DependencyResolver::printQuantityToBeResolved(const QueueEntry& entry)
     {
         str s = entry.quantity.first + " (" + entry.quantity.second + ")";
@@ -1368,10 +1517,12 @@ namespace Gambit
       if ( print_unitcube ) logger() << "Printing of unitCubeParameters will be enabled." << EOM;
 
       // Generate a list of module functors able to participate in dependency resolution.
+      // This is not needed when replaying a cached resolution.
       std::vector<VertexID> vertexCandidates;
       #pragma omp parallel for
       for (auto vi = vertices(masterGraph).first; vi != vertices(masterGraph).second; ++vi)
       {
+        if (replaying) continue;
         bool allowed = true;
 
         for (const ModuleRule& rule : module_rules)
@@ -1392,6 +1543,7 @@ namespace Gambit
       #pragma omp parallel for
       for(functor* f: boundCore->getBackendFunctors())
       {
+        if (replaying) continue;
         bool allowed = true;
 
         for (const BackendRule& rule : backend_rules)
@@ -1412,6 +1564,7 @@ namespace Gambit
       // Main loop: repeat until dependency queue is empty
       //
 
+      size_t step = 0;
       while (not resolutionQueue.empty())
       {
 
@@ -1429,7 +1582,22 @@ namespace Gambit
         #endif
 
         // Figure out how to resolve dependency
-        fromVertices = resolveDependencyFromRules(entry, vertexCandidates);
+        if (replaying)
+        {
+          if (step >= record.queue_solutions.size())
+          {
+            str errmsg = "Cached dependency resolution does not match the resolution queue.\n"
+                         "Please delete " + resolution_cache_file(record.key) + " and try again.";
+            dependency_resolver_error().raise(LOCAL_INFO, errmsg);
+          }
+          fromVertices = std::vector<VertexID>(record.queue_solutions[step].begin(), record.queue_solutions[step].end());
+        }
+        else
+        {
+          fromVertices = resolveDependencyFromRules(entry, vertexCandidates);
+          if (recording) record.queue_solutions.push_back(std::vector<std::size_t>(fromVertices.begin(), fromVertices.end()));
+        }
+        step++;
 
         // If there is more than one result, log that fact.
         if (fromVertices.size() > 1)
@@ -1665,6 +1833,17 @@ namespace Gambit
       // Get started.
       logger() << LogTags::dependency_resolver << "Doing backend function resolution..." << EOM;
 
+      // If replaying a cached resolution, just use the backend functions chosen last time.
+      if (replaying)
+      {
+        auto it = record.backend_solutions.find(vertex);
+        if (it != record.backend_solutions.end())
+        {
+          for (std::size_t i : it->second) resolveRequirement(boundCore->getBackendFunctors()[i], vertex);
+        }
+        return;
+      }
+
       // Collect the list of groups that the backend requirements of this vertex exist in.
       std::set<str> groups = masterGraph[vertex]->backendgroups();
 
@@ -2075,6 +2254,12 @@ namespace Gambit
     void DependencyResolver::resolveRequirement(functor* func, VertexID vertex)
     {
       masterGraph[vertex]->resolveBackendReq(func);
+      if (recording)
+      {
+        const std::vector<functor*>& backendFunctors = boundCore->getBackendFunctors();
+        std::size_t i = std::find(backendFunctors.begin(), backendFunctors.end(), func) - backendFunctors.begin();
+        record.backend_solutions[vertex].push_back(i);
+      }
       logger() << LogTags::dependency_resolver;
       logger() << "Resolved by: [" << func->name() << ", ";
       logger() << func->origin() << " (" << func->version() << ")]";
@@ -2398,6 +2583,194 @@ namespace Gambit
       }
     }
 
+    /// Hash of all inputs that the dependency resolution depends on (empty if these cannot be determined)
+    str DependencyResolver::resolutionCacheKey()
+    {
+      // Refuse to cache anything if the build of the executable cannot be identified
+      const str build = build_id();
+      if (build.empty()) return "";
+
+      std::ostringstream ss;
+      ss << "GAMBIT " << gambit_version() << ", build " << build << endl;
+      ss << "show_backends: " << boundCore->show_backends << endl;
+      ss << YAML::Dump(boundIniFile->getYAMLNode()) << endl;
+      for (const str& model : boundClaw->get_activemodels()) ss << "model: " << model << endl;
+
+      // Include the identity and status of every functor, so that changes in e.g. the available
+      // backends, or the functors compatible with the scanned models, invalidate the cache.
+      graph_traits<MasterGraphType>::vertex_iterator vi, vi_end;
+      for (std::tie(vi, vi_end) = vertices(masterGraph); vi != vi_end; ++vi)
+      {
+        const functor* f = masterGraph[*vi];
+        ss << f->origin() << "::" << f->name() << " " << f->capability() << " " << f->type() << " " << int(f->status()) << endl;
+      }
+      for (const functor* f : boundCore->getBackendFunctors())
+      {
+        ss << f->origin() << " " << f->version() << "::" << f->name() << " " << int(f->status()) << endl;
+      }
+      return resolution_hash(ss.str());
+    }
+
+    /// Obtain a cached resolution to replay, either from the cache file (MPI master process) or from
+    /// the MPI master process (all other processes, which wait for the master to resolve)
+    void DependencyResolver::loadResolutionCache(const str& key)
+    {
+      str contents;
+      int rank = 0;
+      #ifdef WITH_MPI
+        GMPI::Comm comm;
+        rank = comm.Get_rank();
+      #endif
+
+      if (rank == 0)
+      {
+        // Anything wrong with the cache file just means a fresh resolution
+        if (not key.empty())
+        {
+          try
+          {
+            if (not read_resolution_cache(key, contents) or not record.from_string(contents) or record.key != key) contents.clear();
+          }
+          catch (std::exception&)
+          {
+            contents.clear();
+          }
+        }
+      }
+      #ifdef WITH_MPI
+        else
+        {
+          // Wait for the master process to replay its cache file or resolve afresh (see shareResolutionRecord).
+          // The length of its resolution is sent first, or -1 if it failed.
+          int length = 0;
+          comm.Bcast_single(length, 0);
+          if (length < 0)
+          {
+            throw MPIShutdownException("The dependency resolution failed on the master process. Terminating run.");
+          }
+          std::vector<char> buffer(length);
+          if (length > 0) comm.Bcast(buffer, length, 0);
+          contents.assign(buffer.begin(), buffer.end());
+        }
+      #endif
+
+      // Each process checks the resolution against its own functors, and resolves afresh if it does not fit
+      record.clear();
+      replaying = not contents.empty() and record.from_string(contents) and record.key == key and applyResolutionRecord();
+      recording = not replaying and rank == 0;
+
+      logger() << LogTags::dependency_resolver;
+      if (replaying and rank == 0) logger() << "Replaying cached dependency resolution " << key << "." << EOM;
+      else if (replaying) logger() << "Replaying the dependency resolution of the master process." << EOM;
+      else if (rank != 0) logger() << "The dependency resolution of the master process does not fit this process; resolving afresh." << EOM;
+      else if (key.empty()) logger() << "Could not identify the GAMBIT executable; resolution cache file disabled." << EOM;
+      else logger() << "No usable cached dependency resolution found for " << key << "." << EOM;
+      if (not replaying) record.clear();
+    }
+
+    /// Complete the recorded resolution and save it to the cache file (MPI master process only)
+    void DependencyResolver::saveResolutionCache(const str& key)
+    {
+      if (not recording) return;
+
+      // Convert the rules and ObsLike entries matched by each functor into indices
+      auto fill = [](index_map& m, std::size_t i, const auto& matched, const auto& all)
+      {
+        for (const auto* x : matched) m[i].push_back(x - &all[0]);
+        if (m.find(i) != m.end()) std::sort(m[i].begin(), m[i].end());
+      };
+      graph_traits<MasterGraphType>::vertex_iterator vi, vi_end;
+      for (std::tie(vi, vi_end) = vertices(masterGraph); vi != vi_end; ++vi)
+      {
+        fill(record.matched_observables, *vi, masterGraph[*vi]->getMatchedObservables(), obslikes);
+        fill(record.matched_module_rules, *vi, masterGraph[*vi]->getMatchedModuleRules(), module_rules);
+        fill(record.matched_backend_rules, *vi, masterGraph[*vi]->getMatchedBackendRules(), backend_rules);
+      }
+      const std::vector<functor*>& backendFunctors = boundCore->getBackendFunctors();
+      for (std::size_t i = 0; i < backendFunctors.size(); ++i)
+      {
+        fill(record.backend_functor_matched_backend_rules, i, backendFunctors[i]->getMatchedBackendRules(), backend_rules);
+      }
+      record.backends_required = backendsRequired;
+      record.key = key;
+      recording = false;
+
+      // Without a key, the record can still be shared with the other processes, but not saved
+      if (key.empty()) return;
+      write_resolution_cache(key, record.to_string());
+      logger() << LogTags::dependency_resolver << "Saved dependency resolution to " << resolution_cache_file(key) << "." << EOM;
+    }
+
+    /// Send the resolution of the MPI master process to the other processes waiting in
+    /// loadResolutionCache, or tell them that it failed
+    void DependencyResolver::shareResolutionRecord(bool resolved)
+    {
+      #ifdef WITH_MPI
+        GMPI::Comm comm;
+        if (comm.Get_rank() != 0 or comm.Get_size() < 2) return;
+        const str contents = resolved ? record.to_string() : "";
+        int length = resolved ? contents.size() : -1;
+        comm.Bcast_single(length, 0);
+        if (length > 0)
+        {
+          std::vector<char> buffer(contents.begin(), contents.end());
+          comm.Bcast(buffer, length, 0);
+        }
+      #else
+        (void)resolved;
+      #endif
+    }
+
+    /// Check that the replayed resolution is consistent with the current functors and rules, and
+    /// restore the rule matches that it contains
+    bool DependencyResolver::applyResolutionRecord()
+    {
+      const std::size_t nVertices = num_vertices(masterGraph);
+      const std::vector<functor*>& backendFunctors = boundCore->getBackendFunctors();
+      auto in_range = [](const index_map& m, std::size_t nKeys, std::size_t nValues)
+      {
+        for (const auto& entry : m)
+        {
+          if (entry.first >= nKeys) return false;
+          for (std::size_t i : entry.second) if (i >= nValues) return false;
+        }
+        return true;
+      };
+
+      // Check everything before touching any of the functors
+      for (const auto& solution : record.queue_solutions)
+      {
+        for (std::size_t v : solution) if (v >= nVertices) return false;
+      }
+      if (not in_range(record.backend_solutions, nVertices, backendFunctors.size()) or
+          not in_range(record.matched_observables, nVertices, obslikes.size()) or
+          not in_range(record.matched_module_rules, nVertices, module_rules.size()) or
+          not in_range(record.matched_backend_rules, nVertices, backend_rules.size()) or
+          not in_range(record.backend_functor_matched_backend_rules, backendFunctors.size(), backend_rules.size()))
+      {
+        return false;
+      }
+
+      // Restore the rule matches
+      for (const auto& entry : record.matched_observables)
+      {
+        for (std::size_t i : entry.second) masterGraph[entry.first]->addMatchedObservable(&obslikes[i]);
+      }
+      for (const auto& entry : record.matched_module_rules)
+      {
+        for (std::size_t i : entry.second) masterGraph[entry.first]->addMatchedModuleRule(&module_rules[i]);
+      }
+      for (const auto& entry : record.matched_backend_rules)
+      {
+        for (std::size_t i : entry.second) masterGraph[entry.first]->addMatchedBackendRule(&backend_rules[i]);
+      }
+      for (const auto& entry : record.backend_functor_matched_backend_rules)
+      {
+        for (std::size_t i : entry.second) backendFunctors[entry.first]->addMatchedBackendRule(&backend_rules[i]);
+      }
+      return true;
+    }
+
   }
 
 }
@@ -18,6 +18,7 @@
 #include "gambit/Core/gambit.hpp"
 #include "gambit/Utils/mpiwrapper.hpp"
 #include "gambit/Utils/file_lock.hpp"
+#include "gambit/Utils/startup_profiler.hpp"
 
 
 using namespace Gambit;
@@ -111,7 +112,11 @@ int main(int argc, char* argv[])
     {
       // Parse command line arguments, launching into the appropriate diagnostic mode
       // if the argument passed warrants it. Otherwise just get the filename.
-      const str filename = Core().run_diagnostic(argc,argv);
+      str filename;
+      {
+        Utils::profile_phase phase("Command line processing");
+        filename = Core().run_diagnostic(argc,argv);
+      }
 
       if (rank == 0)
       {
@@ -147,7 +152,10 @@ int main(int argc, char* argv[])
 
       // Read YAML file, which also initialises the logger.
       IniParser::IniFile iniFile;
-      iniFile.readFile(filename);
+      {
+        Utils::profile_phase phase("YAML file parsing");
+        iniFile.readFile(filename);
+      }
 
       // Check if user wants to disable use of MPI_Abort (since it does not work correctly in all MPI implementations)
       #ifdef WITH_MPI
@@ -170,20 +178,27 @@ int main(int argc, char* argv[])
       Core().accountForMissingClasses();
 
       // Set up the printer manager for redirection of scan output.
+      Utils::profile_phase printer_phase("Printer setup");
       Printers::PrinterManager printerManager(iniFile.getPrinterNode(),Core().resume);
+      printer_phase.end();
 
       // Assign printer manager to a global variable from which it can be retrieved in module functions that need it
       set_global_printer_manager(&printerManager);
 
       // Set up dependency resolver
+      Utils::profile_phase resolver_phase("Dependency resolver setup");
       DRes::DependencyResolver dependencyResolver(Core(), Models::ModelDB(), iniFile, Utils::typeEquivalencies(), *(printerManager.printerptr));
+      resolver_phase.end();
 
       // Log module function info
       dependencyResolver.printFunctorList();
 
       // Do the dependency resolution
       if (rank == 0) cout << "Resolving dependencies and backend requirements.  Hang tight..." << endl;
-      dependencyResolver.doResolution();
+      {
+        Utils::profile_phase phase("Dependency resolution");
+        dependencyResolver.doResolution();
+      }
       if (rank == 0) cout << "...done!" << endl;
 
       // Print the citation keys required for the used backends
@@ -198,10 +213,14 @@ int main(int argc, char* argv[])
       // Report the proposed (output) functor evaluation order
       dependencyResolver.printFunctorEvalOrder(Core().show_runorder);
 
+      // Report the start-up timing now if just doing a dry run
+      if (Core().profile_startup and Core().show_runorder and rank == 0) cout << endl << Utils::startupProfiler().report() << endl;
+
       // If true, bail out (just wanted the run order or backend list, not a scan); otherwise, keep going.
       if (not Core().show_runorder and not Core().show_backends)
       {
         //Define the likelihood container object for the scanner
+        Utils::profile_phase scanner_phase("Scanner setup");
         Likelihood_Container_Factory factory(Core(), dependencyResolver, iniFile, *(printerManager.printerptr));
 
         //Make scanner yaml node
@@ -216,6 +235,15 @@ int main(int argc, char* argv[])
 
         //Create the master scan manager
         Scanner::Scan_Manager scan(scanner_node, &printerManager, &factory);
+        scanner_phase.end();
+
+        // Report the start-up timing
+        if (Core().profile_startup)
+        {
+          str report = Utils::startupProfiler().report();
+          logger() << core << "Start-up profile:" << endl << report << EOM;
+          if (rank == 0) cout << endl << report << endl;
+        }
 
         // Set cleanup function to call during premature shutdown
         signaldata().set_cleanup(&do_cleanup);
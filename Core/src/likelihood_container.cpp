@@ -42,6 +42,8 @@
 #include "gambit/Utils/mpiwrapper.hpp"
 #include "gambit/Utils/lnlike_modifiers.hpp"
 
+#include <boost/io/ios_state.hpp>
+
 //#define CORE_DEBUG
 
 namespace Gambit
@@ -56,6 +58,7 @@ namespace Gambit
   : dependencyResolver               (dependencyResolver),
     printer                          (printer),
     functorMap                       (functorMap),
+    incremental_recomputation        (iniFile.getValueOrDef<bool>(false, "likelihood", "incremental_recomputation")),
     min_valid_lnlike                 (iniFile.getValueOrDef<double>(0.9*std::numeric_limits<double>::lowest(), "likelihood", "model_invalid_for_lnlike_below")),
     alt_min_valid_lnlike             (iniFile.getValueOrDef<double>(0.5*min_valid_lnlike, "likelihood", "model_invalid_for_lnlike_below_alt")),
     active_min_valid_lnlike          (min_valid_lnlike), // can be switched to the alternate value by the scanner
@@ -105,6 +108,11 @@ namespace Gambit
         aux_vertices.push_back(std::move(*it));
       }
     }
+
+    // Work out once which functors will need to be printed at each point
+    std::vector<DRes::VertexID> printed_vertices(target_vertices);
+    printed_vertices.insert(printed_vertices.end(), aux_vertices.begin(), aux_vertices.end());
+    print_list = dependencyResolver.getPrintList(printed_vertices);
   }
 
   /// Work out what the scanID should be and set it
@@ -145,6 +153,10 @@ namespace Gambit
            core_error().raise(LOCAL_INFO,err.str());
         }
         parstream << "    " << *par_it << ": " << tmp_it->second << endl;
+        if (incremental_recomputation and act_it->second->getcontentsPtr()->getValue(*par_it) != tmp_it->second)
+        {
+          changed_model_functors.insert(act_it->second);
+        }
         act_it->second->getcontentsPtr()->setValue(*par_it, tmp_it->second);
       }
     }
@@ -173,6 +185,10 @@ namespace Gambit
   {
     logger() << LogTags::core << LogTags::debug << "Entered Likelihood_Container::main" << EOM;
 
+    // Don't allow module functions to change the output precision of cout. Functors taking the lean
+    // evaluation path (logging disabled) leave this to us, so it is done once per point here.
+    boost::io::ios_flags_saver ifs(cout);
+
     // Print the scanID
     if (print_scanID)
     {
@@ -220,6 +236,14 @@ namespace Gambit
       // Set the values of the parameter point in the PrimaryParameters functor, and log them to cout and/or the logs if desired.
       setParameters(in);
 
+      // If running incrementally, only reset the functors that depend on the parameters that have changed.
+      // The rest keep their results from the previous point.
+      if (incremental_recomputation)
+      {
+        dependencyResolver.resetDownstreamOf(changed_model_functors);
+        changed_model_functors.clear();
+      }
+
       // Logger debug output; things labelled 'LogTags::debug' only get logged if the logger::debug or master debug flags are true, not if only 'likelihood::debug' is true.
       logger() << LogTags::core << LogTags::debug << "Number of target vertices to calculate:    " << target_vertices.size() << endl
                                                   << "Number of auxiliary vertices to calculate: " << aux_vertices.size() << EOM;
@@ -349,10 +373,7 @@ namespace Gambit
         printer.disable();
       else
       {
-        for (auto it = target_vertices.begin(), end = target_vertices.end(); it != end; ++it)
-           dependencyResolver.printObsLike(*it,getPtID());
-        for (auto it = aux_vertices.begin(), end = aux_vertices.end(); it != end; ++it)
-           dependencyResolver.printObsLike(*it,getPtID());
+        dependencyResolver.printFunctors(print_list, getPtID());
       }
 
       // End timing of total likelihood evaluation
@@ -386,7 +407,7 @@ namespace Gambit
 
     if (debug) cout << "Total log-likelihood: " << lnlike << endl << endl;
     logger() << "Total lnL: " << lnlike << EOM;
-    dependencyResolver.resetAll();
+    if (not incremental_recomputation) dependencyResolver.resetAll();
 
     // Disable the printer so that it doesn't try to output the min_valid_lnlike as a valid likelihood value. ScannerBit will re-enable it when needed again.
     // Disable only for the next print call
@@ -0,0 +1,220 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Persistent cache of dependency resolution
+///  results.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <unistd.h>
+#ifdef __ELF__
+  #include <elf.h>
+  #include <link.h>
+#endif
+
+#include "gambit/Core/resolution_cache.hpp"
+#include "gambit/Utils/util_functions.hpp"
+
+#include "yaml-cpp/yaml.h"
+
+namespace Gambit
+{
+
+  namespace DRes
+  {
+
+    /// Helper functions for (de)serialising index maps
+    /// @{
+    void emit_index_map(YAML::Emitter& out, const str& name, const index_map& m)
+    {
+      out << YAML::Key << name << YAML::Value << YAML::BeginMap;
+      for (const auto& entry : m)
+      {
+        out << YAML::Key << entry.first << YAML::Value << YAML::Flow << entry.second;
+      }
+      out << YAML::EndMap;
+    }
+    void read_index_map(const YAML::Node& node, index_map& m)
+    {
+      m.clear();
+      if (not node) return;
+      for (const auto& entry : node)
+      {
+        m[entry.first.as<std::size_t>()] = entry.second.as<std::vector<std::size_t>>();
+      }
+    }
+    /// @}
+
+    /// Erase the record
+    void ResolutionRecord::clear()
+    {
+      key.clear();
+      queue_solutions.clear();
+      backend_solutions.clear();
+      backends_required.clear();
+      matched_observables.clear();
+      matched_module_rules.clear();
+      matched_backend_rules.clear();
+      backend_functor_matched_backend_rules.clear();
+    }
+
+    /// Serialise the record as YAML
+    str ResolutionRecord::to_string() const
+    {
+      YAML::Emitter out;
+      out << YAML::BeginMap;
+      out << YAML::Key << "key" << YAML::Value << key;
+      out << YAML::Key << "queue_solutions" << YAML::Value << YAML::BeginSeq;
+      for (const auto& solution : queue_solutions) out << YAML::Flow << solution;
+      out << YAML::EndSeq;
+      emit_index_map(out, "backend_solutions", backend_solutions);
+      out << YAML::Key << "backends_required" << YAML::Value << YAML::BeginSeq;
+      for (const auto& backends : backends_required)
+      {
+        out << YAML::Flow << YAML::BeginSeq;
+        for (const sspair& be : backends) out << YAML::Flow << YAML::BeginSeq << be.first << be.second << YAML::EndSeq;
+        out << YAML::EndSeq;
+      }
+      out << YAML::EndSeq;
+      emit_index_map(out, "matched_observables", matched_observables);
+      emit_index_map(out, "matched_module_rules", matched_module_rules);
+      emit_index_map(out, "matched_backend_rules", matched_backend_rules);
+      emit_index_map(out, "backend_functor_matched_backend_rules", backend_functor_matched_backend_rules);
+      out << YAML::EndMap;
+      return str(out.c_str()) + "\n";
+    }
+
+    /// Read the record from a YAML string; returns false if it could not be parsed
+    bool ResolutionRecord::from_string(const str& s)
+    {
+      clear();
+      try
+      {
+        YAML::Node root = YAML::Load(s);
+        key = root["key"].as<str>();
+        for (const auto& solution : root["queue_solutions"])
+        {
+          queue_solutions.push_back(solution.as<std::vector<std::size_t>>());
+        }
+        read_index_map(root["backend_solutions"], backend_solutions);
+        for (const auto& backends : root["backends_required"])
+        {
+          std::vector<sspair> v;
+          for (const auto& be : backends) v.push_back(sspair(be[0].as<str>(), be[1].as<str>()));
+          backends_required.push_back(v);
+        }
+        read_index_map(root["matched_observables"], matched_observables);
+        read_index_map(root["matched_module_rules"], matched_module_rules);
+        read_index_map(root["matched_backend_rules"], matched_backend_rules);
+        read_index_map(root["backend_functor_matched_backend_rules"], backend_functor_matched_backend_rules);
+      }
+      catch (YAML::Exception&)
+      {
+        clear();
+        return false;
+      }
+      return true;
+    }
+
+    /// Hash a string (64-bit FNV-1a), returning a fixed-width hexadecimal digest
+    str resolution_hash(const str& s)
+    {
+      std::uint64_t h = 14695981039346656037ULL;
+      for (unsigned char c : s)
+      {
+        h ^= c;
+        h *= 1099511628211ULL;
+      }
+      std::ostringstream ss;
+      ss << std::hex << std::setw(16) << std::setfill('0') << h;
+      return ss.str();
+    }
+
+    /// Identify the build of the running executable, from the build ID that the linker writes into
+    /// its NT_GNU_BUILD_ID note. This is a hash of the linked executable itself, so it is unchanged by
+    /// copying or touching the executable, and changes whenever anything linked into it changes.
+    /// Returns an empty string if the executable has no build ID.
+    str build_id()
+    {
+      str id;
+      #ifdef __ELF__
+        dl_iterate_phdr([](struct dl_phdr_info* info, std::size_t, void* data) -> int
+        {
+          str& id = *static_cast<str*>(data);
+          // The first object reported is the executable itself
+          for (int i = 0; i < info->dlpi_phnum; ++i)
+          {
+            const ElfW(Phdr)& phdr = info->dlpi_phdr[i];
+            if (phdr.p_type != PT_NOTE) continue;
+            const char* p = reinterpret_cast<const char*>(info->dlpi_addr + phdr.p_vaddr);
+            const char* end = p + phdr.p_memsz;
+            // Each note is a header, then the name and the description, both padded to 4 bytes
+            while (p + sizeof(ElfW(Nhdr)) <= end)
+            {
+              const ElfW(Nhdr)* note = reinterpret_cast<const ElfW(Nhdr)*>(p);
+              const char* name = p + sizeof(ElfW(Nhdr));
+              const unsigned char* desc = reinterpret_cast<const unsigned char*>(name + ((note->n_namesz + 3) & ~3u));
+              if (note->n_type == NT_GNU_BUILD_ID and note->n_namesz == 4 and std::memcmp(name, "GNU", 4) == 0)
+              {
+                std::ostringstream ss;
+                for (std::size_t j = 0; j < note->n_descsz; ++j) ss << std::hex << std::setw(2) << std::setfill('0') << int(desc[j]);
+                id = ss.str();
+                return 1;
+              }
+              p = reinterpret_cast<const char*>(desc) + ((note->n_descsz + 3) & ~3u);
+            }
+          }
+          return 1;
+        }, &id);
+      #endif
+      return id;
+    }
+
+    /// Path of the cache file for a given key
+    str resolution_cache_file(const str& key)
+    {
+      return Utils::GAMBIT_root_dir() + "/scratch/resolution_cache/" + key + ".yaml";
+    }
+
+    /// Read the cache file for a given key into a string; returns false if there is none
+    bool read_resolution_cache(const str& key, str& contents)
+    {
+      std::ifstream in(resolution_cache_file(key));
+      if (not in.good()) return false;
+      std::stringstream ss;
+      ss << in.rdbuf();
+      contents = ss.str();
+      return not contents.empty();
+    }
+
+    /// Write a string to the cache file for a given key.  The file is written under a temporary
+    /// name and then moved into place, so that concurrent readers never see a partial file.
+    void write_resolution_cache(const str& key, const str& contents)
+    {
+      const str filename = Utils::ensure_path_exists(resolution_cache_file(key));
+      const str tmpname = filename + "." + std::to_string(getpid()) + ".tmp";
+      {
+        std::ofstream out(tmpname);
+        out << contents;
+        if (not out.good()) return;
+      }
+      if (std::rename(tmpname.c_str(), filename.c_str()) != 0) std::remove(tmpname.c_str());
+    }
+
+  }
+
+}
@@ -57,6 +57,7 @@
 
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/io/ios_state.hpp>
+#include <boost/optional.hpp>
 
 namespace Gambit
 {
@@ -106,12 +107,18 @@ namespace Gambit
         for (auto it = missing_backends.begin(); it != missing_backends.end(); ++it) ss << endl << "  " << *it;
         backend_error().raise(LOCAL_INFO, ss.str());
       }
-      boost::io::ios_flags_saver ifs(cout);        // Don't allow module functions to change the output precision of cout
-      int thread_num = omp_get_thread_num();
-      init_memory();                               // Init memory if this is the first run through.
+      const bool lean = lean_evaluation();         // Skip the per-call guards below if they are not needed.
+      boost::optional<boost::io::ios_flags_saver> ifs;
+      if (not lean)
+      {
+        ifs.emplace(cout);                         // Don't allow module functions to change the output precision of cout
+        init_memory();                             // Init memory if this is the first run through.
+        memory_initialised.store(true, std::memory_order_release);
+      }
+      int thread_num = (lean and not iRunNested ? 0 : omp_get_thread_num());
       if (needs_recalculating[thread_num])         // Do the actual calculation if required.
       {
-        logger().entering_module(myLogTag);
+        logger().entering_module(myLogTag);        // Needed even when lean, so that the module's tag still filters its messages
         this->startTiming(thread_num);             //Begin timing function evaluation
         try
         {
@@ -179,7 +186,7 @@ namespace Gambit
                                               // In the auxilliary printing system we may tell the printer to overwrite
                                               // the output of other ranks.
           logger() << LogTags::debug << "Printing "<<myLabel<<" (vID="<<myVertexID<<", rank="<<rank<<", pID="<<pointID<<", type="<<myType<<")" << EOM;
-          printer->print(myValue[thread_num],myLabel,myVertexID,rank,pointID);
+          printer->print(myValue[thread_num],myPrintHandle,rank,pointID);
           already_printed[thread_num] = true;
         }
 
@@ -190,7 +197,7 @@ namespace Gambit
           int rank = printer->getRank();
           std::chrono::duration<double> runtime = end[thread_num] - start[thread_num];
           logger() << LogTags::debug << "Printing "<<myTimingLabel<<" (vID="<<myTimingVertexID<<", rank="<<rank<<", pID="<<pointID<<")" << EOM;
-          printer->print(runtime.count(),myTimingLabel,myTimingVertexID,rank,pointID);
+          printer->print(runtime.count(),myTimingPrintHandle,rank,pointID);
           already_printed_timing[thread_num] = true;
         }
       }
@@ -48,6 +48,7 @@
 
 #include <map>
 #include <set>
+#include <atomic>
 #include <vector>
 #include <chrono>
 #include <sstream>
@@ -60,6 +61,9 @@
 #include "gambit/Utils/model_parameters.hpp"
 #include "gambit/Logs/logger.hpp"
 #include "gambit/Logs/logmaster.hpp" // Need full declaration of LogMaster class
+#ifndef NO_PRINTERS
+  #include "gambit/Printers/basebaseprinter.hpp" // Need full declaration of print_handle class
+#endif
 
 /// Decay rate of average runtime estimate [(number of functor evaluations)^-1]
 #define FUNCTORS_FADE_RATE 0.01
@@ -154,6 +158,7 @@ namespace Gambit
       virtual void setFadeRate(double);
       virtual void notifyOfInvalidation(const str&);
       virtual void reset();
+      virtual void resetPrinting();
       /// @}
 
       /// Reset-then-recalculate method
@@ -426,6 +431,13 @@ namespace Gambit
       int myVertexID;
       /// ID assigned by printers to the timing data output stream
       int myTimingVertexID;
+
+      #ifndef NO_PRINTERS
+        /// Print handle for the functor result, rebuilt whenever the vertex ID is set
+        Printers::print_handle myPrintHandle;
+        /// Print handle for the functor timing data, rebuilt whenever the timing vertex ID is set
+        Printers::print_handle myTimingPrintHandle;
+      #endif
       /// Debug flag
       bool verbose;
 
@@ -503,6 +515,9 @@ namespace Gambit
       /// Reset functor
       void reset();
 
+      /// Reset the printing flags only, keeping the existing results
+      void resetPrinting();
+
       /// Tell the functor that it invalidated the current point in model space, pass a message explaining why, and throw an exception.
       void notifyOfInvalidation(const str&);
 
@@ -687,6 +702,13 @@ namespace Gambit
       /// Initialise the memory of this functor.
       virtual void init_memory();
 
+      /// Flag indicating whether calculate() has already been through init_memory() once.
+      /// Atomic, as it is set by whichever OpenMP thread gets there first.
+      std::atomic<bool> memory_initialised;
+
+      /// Check whether calculate() can skip its per-call guards (memory already initialised and logging disabled for this module)
+      bool lean_evaluation();
+
       /// Construct the list of known models only if it doesn't yet exist
       void fill_activeModelFlags();
 
@@ -54,6 +54,7 @@
 
 #include <boost/preprocessor/seq/for_each.hpp>
 #include <boost/io/ios_state.hpp>
+#include <boost/optional.hpp>
 
 namespace Gambit
 {
@@ -82,7 +83,12 @@ namespace Gambit
      myVertexID      (-1),       // (Note: myVertexID = -1 is intended to mean that no vertexID has been assigned)
      myTimingVertexID(-1),       // Not actually a graph vertex; ID assigned by "get_main_param_id" function.
      verbose         (false)     // For debugging.
-    {}
+    {
+      #ifndef NO_PRINTERS
+        myPrintHandle = Printers::print_handle(myLabel, myVertexID);
+        myTimingPrintHandle = Printers::print_handle(myTimingLabel, myTimingVertexID);
+      #endif
+    }
 
     /// Virtual calculate(); needs to be redefined in daughters.
     void functor::calculate() {}
@@ -96,6 +102,7 @@ namespace Gambit
     void functor::notifyOfInvalidation(const str&) {}
     void functor::reset() {}
     void functor::reset(int) {}
+    void functor::resetPrinting() {}
     /// @}
 
     /// Reset-then-recalculate method
@@ -105,10 +112,22 @@ namespace Gambit
     void functor::setPurpose(str purpose) { myPurpose = purpose; }
 
     /// Setter for vertex ID (used in printer system)
-    void functor::setVertexID(int ID) { myVertexID = ID; }
+    void functor::setVertexID(int ID)
+    {
+      myVertexID = ID;
+      #ifndef NO_PRINTERS
+        myPrintHandle = Printers::print_handle(myLabel, ID);
+      #endif
+    }
 
     /// Acquire ID for timing 'vertex' (used in printer system)
-    void functor::setTimingVertexID(int ID) { myTimingVertexID = ID; }
+    void functor::setTimingVertexID(int ID)
+    {
+      myTimingVertexID = ID;
+      #ifndef NO_PRINTERS
+        myTimingPrintHandle = Printers::print_handle(myTimingLabel, ID);
+      #endif
+    }
 
     /// Setter for status
     void functor::setStatus(FunctorStatus stat)
@@ -733,6 +752,7 @@ namespace Gambit
                                                  Models::ModelFunctorClaw &claw)
     : functor                  (func_name, func_capability, result_type, origin_name, claw),
       myTimingPrintFlag        (false),
+      memory_initialised       (false),
       start                    (NULL),
       end                      (NULL),
       point_exception_raised   (false),
@@ -812,6 +832,15 @@ namespace Gambit
       point_exception_raised = false;
     }
 
+    /// Reset the printing flags only, keeping the existing results
+    void module_functor_common::resetPrinting()
+    {
+      init_memory();
+      int n = (iRunNested ? globlMaxThreads : 1);
+      std::fill(already_printed, already_printed+n, false);
+      std::fill(already_printed_timing, already_printed_timing+n, false);
+    }
+
     /// Reset functor for one thread only
     void module_functor_common::reset(int thread_num)
     {
@@ -1797,6 +1826,13 @@ namespace Gambit
       }
     }
 
+    /// Check whether calculate() can skip its per-call guards.
+    /// The cout flags are then restored once per point by the likelihood container rather than by each functor.
+    bool module_functor_common::lean_evaluation()
+    {
+      return memory_initialised.load(std::memory_order_acquire) and logger().disabled(myLogTag);
+    }
+
     /// Do pre-calculate timing things
     void module_functor_common::startTiming(int thread_num)
     {
@@ -1851,15 +1887,21 @@ namespace Gambit
         << " cannot be used" << endl << "because it initialises a backend that you do not have installed!";
         backend_error().raise(LOCAL_INFO, ss.str());
       }
-      boost::io::ios_flags_saver ifs(cout);        // Don't allow module functions to change the output precision of cout
-      int thread_num = omp_get_thread_num();
-      fill_activeModelFlags();                     // If activeModels hasn't been populated yet, make sure it is.
-      init_memory();                               // Init memory if this is the first run through.
+      const bool lean = lean_evaluation();         // Skip the per-call guards below if they are not needed.
+      boost::optional<boost::io::ios_flags_saver> ifs;
+      if (not lean)
+      {
+        ifs.emplace(cout);                         // Don't allow module functions to change the output precision of cout
+        fill_activeModelFlags();                   // If activeModels hasn't been populated yet, make sure it is.
+        init_memory();                             // Init memory if this is the first run through.
+        memory_initialised.store(true, std::memory_order_release);
+      }
+      int thread_num = (lean and not iRunNested ? 0 : omp_get_thread_num());
       if (needs_recalculating[thread_num])
       {
         entering_multithreaded_region();
 
-        logger().entering_module(myLogTag);
+        logger().entering_module(myLogTag);        // Needed even when lean, so that the module's tag still filters its messages
         this->startTiming(thread_num);
         try
         {
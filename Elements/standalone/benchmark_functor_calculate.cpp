@@ -0,0 +1,86 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Stand-alone benchmark of the per-call
+///  overhead of module_functor::calculate(),
+///  comparing the full path (logging enabled)
+///  with the lean path that calculate() takes
+///  once logging is disabled for the module.
+///
+///  usage: benchmark_functor_calculate [calls]
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+#include "gambit/Elements/functors.hpp"
+#include "gambit/Elements/functor_definitions.hpp"
+#include "gambit/Models/models.hpp"
+#include "gambit/Logs/logger.hpp"
+
+// Annoying other things we need due to mostly unwanted dependencies
+#include "gambit/Utils/static_members.hpp"
+
+using namespace Gambit;
+
+namespace
+{
+  /// A module function that does next to nothing, so that only the overhead is timed
+  void trivial(double& result)
+  {
+    result += 1.0;
+  }
+
+  /// Time 'calls' evaluations of the functor, returning the time per call in ns
+  double time_calls(module_functor<double>& f, long calls)
+  {
+    // The first call initialises the functor's memory
+    f.reset();
+    f.calculate();
+
+    auto start = std::chrono::steady_clock::now();
+    for (long i = 0; i < calls; ++i)
+    {
+      f.reset();
+      f.calculate();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double,std::nano>(end - start).count() / calls;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const long calls = (argc > 1 ? std::atol(argv[1]) : 10000000);
+
+  Models::ModelFunctorClaw claw;
+  module_functor<double> f(&trivial, "trivial", "trivial_capability", "double", "Core", claw);
+  f.setStatus(FunctorStatus::Active);
+
+  // Full path: logging enabled, so calculate() keeps all its per-call guards
+  logger().enable();
+  const double full = time_calls(f, calls);
+
+  // Lean path: logging disabled, so calculate() skips them
+  logger().disable();
+  const double lean = time_calls(f, calls);
+
+  std::cout << std::fixed << std::setprecision(2)
+            << "module_functor<double>::calculate() overhead over " << calls << " calls" << std::endl
+            << "  full path: " << full << " ns/call" << std::endl
+            << "  lean path: " << lean << " ns/call" << std::endl
+            << "  speed-up:  " << full/lean << "x" << std::endl;
+
+  return EXIT_SUCCESS;
+}
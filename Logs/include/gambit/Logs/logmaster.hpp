@@ -79,6 +79,8 @@ namespace Gambit
         void disable();
         // Function to check if all log messages are silenced
         bool disabled();
+        // Function to check if all log messages carrying a given tag are silenced
+        bool disabled(int);
         // Turn logs back on
         void enable();
 
@@ -378,6 +378,12 @@ namespace Gambit
        return silenced;
     }
 
+    // Function to check if all log messages carrying a given tag are silenced
+    bool LogMaster::disabled(int tag)
+    {
+       return silenced or ignore.find(tag) != ignore.end();
+    }
+
     // Dump the backlog buffer to the 'finalsend' function
     void LogMaster::empty_backlog()
     {
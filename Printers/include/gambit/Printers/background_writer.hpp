@@ -0,0 +1,161 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Thread which writes printer output to disk
+///  in the background, shared by the printers
+///  that support background writes.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __background_writer_hpp__
+#define __background_writer_hpp__
+
+#include <deque>
+#include <functional>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+    /// Thread which writes jobs (e.g. the flushes of a print buffer) to disk in the
+    /// background, in the order in which they were queued. 'push' blocks while the
+    /// queue is full, so at most max_queue jobs wait in memory.
+    template<class Job>
+    class BackgroundWriter
+    {
+      public:
+
+        /// Constructor. The thread is started at the first push.
+        BackgroundWriter(const std::function<void(Job&)>& write, const std::size_t max_queue)
+          : write_job(write)
+          , max_queue(max_queue)
+          , busy(false)
+          , stop(false)
+        {}
+
+        /// Destructor; writes everything still in the queue before stopping the thread
+        ~BackgroundWriter()
+        {
+            if(thread.joinable())
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    stop = true;
+                }
+                cv.notify_all();
+                thread.join();
+            }
+        }
+
+        /// Queue a job for writing
+        void push(Job&& job)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                if(not thread.joinable()) thread = std::thread(&BackgroundWriter::run, this);
+                cv.wait(lock, [this]{ return queue.size()<max_queue or error; });
+                raise_error();
+                queue.push_back(std::move(job));
+            }
+            cv.notify_all();
+        }
+
+        /// Wait until everything in the queue has been written. Errors raised by the
+        /// thread are raised again here (and in push).
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            cv.wait(lock, [this]{ return (queue.empty() and not busy) or error; });
+            raise_error();
+        }
+
+      private:
+
+        /// Main loop of the thread
+        void run()
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            while(true)
+            {
+                cv.wait(lock, [this]{ return not queue.empty() or stop; });
+                if(queue.empty()) break; // Stopped, and nothing left to write
+
+                Job job(std::move(queue.front()));
+                queue.pop_front();
+                busy = true;
+                lock.unlock();
+                cv.notify_all(); // There is space in the queue again
+
+                std::exception_ptr e;
+                try
+                {
+                    write_job(job);
+                }
+                catch(...)
+                {
+                    e = std::current_exception();
+                }
+
+                lock.lock();
+                busy = false;
+                if(e)
+                {
+                    // Give up on the rest of the queue; the error is raised in the main thread
+                    error = e;
+                    queue.clear();
+                }
+                cv.notify_all();
+            }
+        }
+
+        /// Raise any error raised by the thread (the mutex must be held)
+        void raise_error()
+        {
+            if(error)
+            {
+                std::exception_ptr e = error;
+                error = nullptr;
+                std::rethrow_exception(e);
+            }
+        }
+
+        /// Function which writes a job to disk
+        std::function<void(Job&)> write_job;
+
+        /// Max number of jobs waiting in the queue
+        std::size_t max_queue;
+
+        /// Jobs waiting to be written
+        std::deque<Job> queue;
+
+        /// Flag to register whether the thread is writing a job
+        bool busy;
+
+        /// Flag to tell the thread to stop once the queue is empty
+        bool stop;
+
+        /// Error raised by the thread
+        std::exception_ptr error;
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        std::thread thread;
+    };
+
+  }
+}
+
+#endif
@@ -74,6 +74,60 @@ namespace Gambit
        return 0;
     }
 
+    /// Handle to a printed quantity, for printing the same label over and over
+    /// without per-print label work. The ID code of the label is looked up on
+    /// first use, and printers may cache their own output slot for the label
+    /// (e.g. a pointer to its buffer) in the handle, so that later prints
+    /// through the handle need no lookups at all.
+    class print_handle
+    {
+      public:
+        print_handle() : _vertexID(0), has_ID(false), owner(0), slot(NULL), slot_type(-1) {}
+
+        /// Handle for a label whose ID code is assigned by get_param_id (at first print)
+        explicit print_handle(const std::string& label)
+          : _label(label), _vertexID(0), has_ID(false), owner(0), slot(NULL), slot_type(-1) {}
+
+        /// Handle for a label with a known ID code
+        print_handle(const std::string& label, const int vertexID)
+          : _label(label), _vertexID(vertexID), has_ID(true), owner(0), slot(NULL), slot_type(-1) {}
+
+        const std::string& label() const { return _label; }
+
+        int vertexID()
+        {
+          if(not has_ID)
+          {
+            _vertexID = get_param_id(_label);
+            has_ID = true;
+          }
+          return _vertexID;
+        }
+
+        /// Retrieve the slot cached by a printer for values of a printer-defined type
+        /// code (NULL if that printer has not cached one yet)
+        void* get_slot(const unsigned long long printer, const int type) const
+        {
+          return (owner==printer and slot_type==type) ? slot : NULL;
+        }
+
+        /// Cache a printer slot (replaces any slot cached by another printer)
+        void set_slot(const unsigned long long printer, const int type, void* s)
+        {
+          owner = printer;
+          slot_type = type;
+          slot = s;
+        }
+
+      private:
+        std::string _label;
+        int _vertexID;
+        bool has_ID;
+        unsigned long long owner; // Serial number of the printer that owns the slot
+        void* slot;
+        int slot_type;
+    };
+
     class BaseBasePrinter
     {
       private:
@@ -83,7 +137,7 @@ namespace Gambit
         bool printUnitcube; // Flag whether unitCubeParameters should be printed.
 
       public:
-        BaseBasePrinter(): rank(0), printUnitcube(false), printer_enabled(true), printer_cooldown(-1) {}
+        BaseBasePrinter(): rank(0), printUnitcube(false), printer_enabled(true), printer_cooldown(-1), printer_serial(next_printer_serial()) {}
         virtual ~BaseBasePrinter() {}
         /// Function to signal to the printer to write buffer contents to disk
         //virtual void flush() {}; // TODO: needed?
@@ -96,6 +150,11 @@ namespace Gambit
         /// a bunch of data as a batch, to make sure it is all on disk after the batch is done.
         virtual void flush() = 0;
 
+        /// Do any printing work that waits on other processes (e.g. receiving their output).
+        /// Scanners call this while they wait for other processes, e.g. as the coordinator
+        /// of a dynamic schedule.
+        virtual void poll() {}
+
         /// Retrieve/Set MPI rank (setting is useful for e.g. the postprocessor to re-print points from other ranks)
         int  getRank() {return rank;}
         void setRank(int r) {rank = r;}
@@ -159,6 +218,17 @@ namespace Gambit
           if(!printer_cooldown) printer_enabled = true; // if cooldown has ended, re-enable printer
         }
 
+        // Overload which prints through a handle (see print_handle).
+        template<typename T>
+        void print(T const& in, print_handle& handle,
+                   const uint rank,
+                   const ulong pointID)
+        {
+          if(printer_enabled) _print(in, handle, rank, pointID);
+          if(printer_cooldown > 0) printer_cooldown--; // if there's a cooldown, reduce it afer printing
+          if(!printer_cooldown) printer_enabled = true; // if cooldown has ended, re-enable printer
+        }
+
         // Print metadata information
         void print_metadata(map_str_str datasets)
         {
@@ -172,6 +242,19 @@ namespace Gambit
         /// Counter for printer cooldown. If non-zero printer can be disabled for a fixed number of print calls
         int printer_cooldown;
 
+        /// Unique serial number of this printer, identifying the slots it caches in print handles
+        unsigned long long printer_serial;
+
+        /// Default handle _print function. Just prints by label; printers can override
+        /// the virtual versions below to use the slot cache of the handle.
+        template<typename T>
+        void _print(T const& in, print_handle& handle,
+                    const uint rank,
+                    const ulong pointID)
+        {
+          _print(in, handle.label(), handle.vertexID(), rank, pointID);
+        }
+
         /// Default _print function. Throws an error if no matching
         /// virtual function for the type of the attempted print is
         /// found.
@@ -252,6 +335,18 @@ namespace Gambit
         // retrievable types, to be overloaded in each printer.
         ADD_VIRTUAL_PRINTS(SCANNER_PRINTABLE_TYPES)
 
+        // Virtual handle print methods for the simple types, which printers
+        // may override to resolve handles to their own output slots
+        #define VPRINT_HANDLE(r,data,elem)                            \
+        virtual void _print(elem const& in, print_handle& handle,     \
+                           const uint rank, const ulong pointID)      \
+        {                                                             \
+          _print(in, handle.label(), handle.vertexID(), rank, pointID); \
+        }
+
+        BOOST_PP_SEQ_FOR_EACH(VPRINT_HANDLE, , SCANNER_SIMPLE_TYPES)
+        #undef VPRINT_HANDLE
+
     };
 
         /// @{ Printer READ interface
@@ -175,10 +175,30 @@ namespace Gambit
           print(in, label, get_param_id(label), rank, pointID);
         }
 
+        // Overload which prints through a handle (see print_handle).
+        template<typename T>
+        void print(T const& in, print_handle& handle,
+                   const uint rank,
+                   const ulong pointID)
+        {
+          if (printer_enabled) _print(in, handle, rank, pointID);
+        }
+
       protected:
         // Unhide the default function in the base class
         using BaseBasePrinter::_print;
 
+        // Default handle _print function, which can see all the label print
+        // functions of this class (the base class version only knows the
+        // ScannerBit types)
+        template<typename T>
+        void _print(T const& in, print_handle& handle,
+                    const uint rank,
+                    const ulong pointID)
+        {
+          _print(in, handle.label(), handle.vertexID(), rank, pointID);
+        }
+
         // We need to have a virtual print method for every type that we want to
         // be able to print. The list of these types is maintained in
         // "gambit/Elements/printable_types.hpp"
@@ -37,6 +37,9 @@ namespace Gambit
         /// Consolidated 'get id' function, for both main and aux
         EXPORT_SYMBOLS int get_param_id(const std::string& name, bool& is_new);
         EXPORT_SYMBOLS int get_param_id(const std::string& name);
+        /// Returns a new unique serial number for a printer object
+        EXPORT_SYMBOLS unsigned long long int next_printer_serial();
+
         /// Get names of all parameters known to printer system (vector index corresponds to ID number)
         EXPORT_SYMBOLS std::vector<std::string> get_all_params();
 
@@ -0,0 +1,202 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Minimal writer and reader for the Apache
+///  Arrow IPC streaming format, restricted to
+///  flat tables of fixed-width numeric columns.
+///  Used by the Arrow printer, so that no Arrow
+///  library is needed to build GAMBIT.
+///
+///  Format specification:
+///  https://arrow.apache.org/docs/format/Columnar.html
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __arrowipc_hpp__
+#define __arrowipc_hpp__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Gambit
+{
+  namespace Printers
+  {
+    namespace Arrow
+    {
+
+      /// Column types that can be written and read
+      enum class Type { Bool, Int32, UInt32, Int64, UInt64, Float32, Float64 };
+
+      /// Size in bytes of one value in memory. Bools take one byte in memory, but one bit on disk.
+      std::size_t type_size(Type);
+
+      /// Arrow name of a type, for messages
+      std::string type_name(Type);
+
+      /// Column type in which values of the arithmetic type T are stored
+      template<class T>
+      Type type_of()
+      {
+          static_assert(std::is_arithmetic<T>::value and (std::is_same<T,bool>::value or sizeof(T)==4 or sizeof(T)==8), "Type cannot be stored in an Arrow column");
+          if(std::is_same<T,bool>::value) return Type::Bool;
+          if(std::is_floating_point<T>::value) return sizeof(T)==4 ? Type::Float32 : Type::Float64;
+          if(sizeof(T)==4) return std::is_signed<T>::value ? Type::Int32 : Type::UInt32;
+          return std::is_signed<T>::value ? Type::Int64 : Type::UInt64;
+      }
+
+      /// One field (column) of a schema
+      struct Field
+      {
+          std::string name;
+          Type type;
+      };
+
+      /// One column of a record batch. 'values' holds type_size bytes per value (native
+      /// byte order, which must be little endian) and 'valid' one byte (0 or 1) per value.
+      struct Column
+      {
+          std::vector<unsigned char> values;
+          std::vector<unsigned char> valid;
+      };
+
+      /// A record batch: the next 'length' rows of every column of the schema
+      struct RecordBatch
+      {
+          std::size_t length;
+          std::vector<Column> columns;
+      };
+
+      /// Writes an Arrow IPC stream file: a schema message, then record batch messages, then
+      /// the end-of-stream marker. Every batch is flushed to disk as soon as it is written.
+      class StreamWriter
+      {
+        public:
+          /// Create the file, and write the schema (with optional key-value metadata)
+          StreamWriter(const std::string& path, const std::vector<Field>& schema, const std::map<std::string,std::string>& metadata = std::map<std::string,std::string>());
+
+          /// Destructor; closes the stream if that has not been done
+          ~StreamWriter();
+
+          /// Append a record batch, which must have one column per schema field
+          void write(const RecordBatch&);
+
+          /// Write the end-of-stream marker and close the file
+          void close();
+
+          const std::string& get_path() const { return path; }
+          const std::vector<Field>& get_schema() const { return schema; }
+
+        private:
+          /// Write one encapsulated message (flatbuffer metadata plus body)
+          void write_message(const std::vector<unsigned char>& metadata, const std::vector<unsigned char>& body);
+
+          std::string path;
+          std::vector<Field> schema;
+          std::ofstream out;
+      };
+
+      /// Reads an Arrow IPC stream file written by StreamWriter without loading it: the file is
+      /// memory mapped, and only the message headers are parsed when it is opened. The values are
+      /// read from the mapped file when they are asked for, so the file must not be changed while
+      /// it is open. Raises a printer error if the file cannot be read or is not in the supported
+      /// subset.
+      class StreamReader
+      {
+        public:
+          StreamReader(const std::string& path);
+          ~StreamReader();
+
+          StreamReader(const StreamReader&) = delete;
+          StreamReader& operator=(const StreamReader&) = delete;
+
+          const std::string& get_path() const { return path; }
+          const std::vector<Field>& get_schema() const { return schema; }
+          const std::map<std::string,std::string>& get_metadata() const { return metadata; }
+
+          /// False if the file ends before the end-of-stream marker (e.g. because the run was
+          /// killed while writing it); all complete batches can still be read.
+          bool is_complete() const { return complete; }
+
+          std::size_t num_batches() const { return batches.size(); }
+          std::size_t batch_length(std::size_t batch) const { return batches[batch].length; }
+
+          /// Whether the value in a row of a column of a batch is valid (not null)
+          bool is_valid(std::size_t batch, std::size_t column, std::size_t row) const
+          {
+              const unsigned char* validity = batches[batch].columns[column].validity;
+              return validity==nullptr or ((validity[row/8] >> (row%8)) & 1u);
+          }
+
+          /// The value in a row of a column of a batch, converted to T
+          template<class T>
+          T value(std::size_t batch, std::size_t column, std::size_t row) const
+          {
+              const unsigned char* values = batches[batch].columns[column].values;
+              switch(schema[column].type)
+              {
+                  case Type::Bool:    return T((values[row/8] >> (row%8)) & 1u);
+                  case Type::Int32:   return T(load<std::int32_t>(values + 4*row));
+                  case Type::UInt32:  return T(load<std::uint32_t>(values + 4*row));
+                  case Type::Int64:   return T(load<std::int64_t>(values + 8*row));
+                  case Type::UInt64:  return T(load<std::uint64_t>(values + 8*row));
+                  case Type::Float32: return T(load<float>(values + 4*row));
+                  default:            return T(load<double>(values + 8*row));
+              }
+          }
+
+        private:
+          /// The buffers of one column of a record batch, in the mapped file. Bool values are a bitmap.
+          struct ColumnBuffers
+          {
+              const unsigned char* validity; // nullptr if every value is valid
+              const unsigned char* values;
+          };
+
+          struct Batch
+          {
+              std::size_t length;
+              std::vector<ColumnBuffers> columns;
+          };
+
+          /// Read the messages of the file up to the end-of-stream marker, or the end of the file
+          void read_messages();
+
+          template<class T>
+          static T load(const unsigned char* p)
+          {
+              T x;
+              std::memcpy(&x, p, sizeof(T));
+              return x;
+          }
+
+          std::string path;
+          std::vector<Field> schema;
+          std::map<std::string,std::string> metadata;
+          std::vector<Batch> batches;
+          bool complete;
+
+          // The mapped file
+          const unsigned char* data;
+          std::size_t size;
+      };
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,187 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Arrow printer class declaration
+///
+///  Writes the output of each process to its own
+///  Apache Arrow IPC stream files, which can be
+///  read (or memory mapped) by any Arrow library,
+///  e.g. with pyarrow.ipc.open_stream.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __arrowprinter_hpp__
+#define __arrowprinter_hpp__
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Gambit
+#include "gambit/Printers/baseprinter.hpp"
+#include "gambit/Printers/printers/arrowipc.hpp"
+#include "gambit/Printers/printers/arrowtypes.hpp"
+
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+    /// Name of an Arrow printer data file: <stream>_rank<rank>_g<generation>_<index>.arrows
+    /// The stream is "primary" or the name of an auxiliary stream. The generation is raised
+    /// each time an auxiliary stream is reset, and the index counts the files of a stream
+    /// written by one process.
+    struct ArrowFileName
+    {
+        std::string stream;
+        std::size_t rank;
+        std::size_t generation;
+        std::size_t index;
+
+        std::string str() const;
+
+        /// Parse a file name (without directory). Returns false if it is not a data file name.
+        static bool parse(const std::string& filename, ArrowFileName& out);
+    };
+
+    /// All Arrow printer data files in a directory, ordered by stream, rank and index
+    std::vector<ArrowFileName> list_arrow_files(const std::string& dir);
+
+    /// The main printer class for output to Arrow IPC stream files
+    class ArrowPrinter : public BasePrinter
+    {
+      public:
+        /// Constructor (for construction via inifile options)
+        ArrowPrinter(const Options&, BasePrinter* const primary = NULL);
+
+        /// Destructor
+        ~ArrowPrinter();
+
+        /// Virtual function overloads:
+        ///@{
+
+        // Initialisation function
+        // Run by dependency resolver, which supplies the functors with a vector of VertexIDs whose requiresPrinting flags are set to true.
+        void initialise(const std::vector<int>&);
+        void flush();
+        void reset(bool force=false);
+        void finalise(bool abnormal=false);
+
+        // Get options required to construct a reader object that can read
+        // the previous output of this printer.
+        Options resume_reader_options();
+
+        ///@}
+
+        const std::string& get_output_dir();
+        std::size_t get_max_buffer_length();
+
+        ///@{ Print functions
+        using BasePrinter::_print; // Tell compiler we are using some of the base class overloads of this on purpose.
+        #define DECLARE_PRINT(r,data,i,elem) void _print(elem const&, const std::string&, const int, const unsigned int, const unsigned long);
+        BOOST_PP_SEQ_FOR_EACH_I(DECLARE_PRINT, , ARROW_TYPES)
+        #ifndef SCANNER_STANDALONE
+          BOOST_PP_SEQ_FOR_EACH_I(DECLARE_PRINT, , ARROW_BACKEND_TYPES)
+        #endif
+        #undef DECLARE_PRINT
+
+        // Print metadata info to file
+        void _print_metadata(map_str_str);
+
+        ///@}
+
+        /// Helper print function, for any type with an Arrow column type
+        template<class T>
+        void template_print(T const& value, const std::string& label, const unsigned int mpirank, const unsigned long pointID)
+        {
+            unsigned char* slot = insert_data(mpirank, pointID, label, Arrow::type_of<T>());
+            if(slot!=NULL) std::memcpy(slot, &value, sizeof(T));
+        }
+
+      private:
+
+        #ifdef WITH_MPI
+        // Gambit MPI communicator context for use within the Arrow printer system
+        GMPI::Comm myComm;
+        #endif
+
+        std::size_t mpiRank;
+
+        // Pointer to primary printer object, for retrieving setup information.
+        ArrowPrinter* primary_printer;
+
+        // Directory holding the output files of all streams and processes
+        std::string output_dir;
+
+        // Name of this stream in the output file names
+        std::string stream_name;
+
+        // Generation and index of the next output file
+        std::size_t generation;
+        std::size_t next_file_index;
+
+        // Last point ID
+        PPIDpair lastPointID;
+
+        /// @{ Buffer variables. The buffer holds whole columns; the first two
+        /// are always MPIrank and pointID, which identify the rows.
+
+        std::size_t max_buffer_length;
+
+        // Fields of the buffer columns, in the order in which they were first printed
+        std::vector<Arrow::Field> fields;
+        std::vector<Arrow::Column> columns;
+        std::map<std::string,std::size_t> column_index;
+
+        // Buffer row of each point
+        std::map<PPIDpair,std::size_t> buffer_rows;
+
+        /// @}
+
+        // Stream file currently being written. A new file is started whenever
+        // the buffer has gained columns that are not in its schema.
+        std::unique_ptr<Arrow::StreamWriter> writer;
+
+        /// @{ Metadata (rank 0 of the primary printer only)
+        map_str_str metadata;
+        std::string metadata_file;
+        /// @}
+
+        // Return the value slot of the given point and column in the buffer (adding
+        // them if needed), marked as valid. Returns NULL for the row key labels.
+        unsigned char* insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& label, const Arrow::Type type);
+
+        // Add a column to the buffer
+        std::size_t add_column(const std::string& label, const Arrow::Type type);
+
+        // Write the buffer to the current stream file, and clear it
+        void dump_buffer();
+
+        // Close the current stream file, if any
+        void close_file();
+
+        // Write the metadata file
+        void write_metadata();
+
+        // Highest pointID of this process in the existing primary output (for resuming)
+        unsigned long long find_highest_pointID();
+    };
+
+    // Register printer so it can be constructed via inifile instructions
+    // First argument is string label for inifile access, second is class from which to construct printer
+    LOAD_PRINTER(arrow, ArrowPrinter)
+
+  }
+}
+#endif
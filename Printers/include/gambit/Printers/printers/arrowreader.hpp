@@ -0,0 +1,148 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Arrow printer retriever class definitions
+///  This is a class accompanying the ArrowPrinter
+///  which takes care of *reading* from output
+///  created by the ArrowPrinter.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __arrow_reader_hpp__
+#define __arrow_reader_hpp__
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gambit/Printers/baseprinter.hpp"
+#include "gambit/Printers/printers/arrowipc.hpp"
+#include "gambit/Printers/printers/arrowtypes.hpp"
+
+#include <boost/preprocessor/seq/for_each_i.hpp>
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+    /// Reads all output of an ArrowPrinter (i.e. the files of all processes and streams), merged
+    /// into one entry per point. The points are ordered as in the primary output. The files are
+    /// memory mapped and only indexed when the reader is constructed; values are read from the
+    /// files when they are retrieved.
+    class ArrowReader : public BaseReader
+    {
+      public:
+        ArrowReader(const Options& options);
+        ~ArrowReader();
+
+        /// @{ Base class virtual interface functions
+        virtual void reset(); // Reset 'read head' position to first entry
+        virtual ulong get_dataset_length(); // Get length of input dataset
+        virtual PPIDpair get_next_point(); // Get next rank/ptID pair in data file
+        virtual PPIDpair get_current_point(); // Get current rank/ptID pair in data file
+        virtual ulong    get_current_index(); // Get a linear index which corresponds to the current rank/ptID pair in the iterative sense
+        virtual bool eoi(); // Check if 'current point' is past the end of the data file (and thus invalid!)
+        /// Get type information for a data entry, i.e. defines the C++ type which this should be
+        /// retrieved as, not what it is necessarily literally stored as in the output.
+        virtual std::size_t get_type(const std::string& label);
+        virtual std::set<std::string> get_all_labels(); // Get all dataset labels
+        /// @}
+
+        /// Retrieve functions
+        using BaseReader::_retrieve; // Tell compiler we are using some of the base class overloads of this on purpose.
+        #define DECLARE_RETRIEVE(r,data,i,elem) bool _retrieve(elem&, const std::string&, const uint, const ulong);
+        BOOST_PP_SEQ_FOR_EACH_I(DECLARE_RETRIEVE, , ARROW_TYPES)
+        #ifndef SCANNER_STANDALONE
+          BOOST_PP_SEQ_FOR_EACH_I(DECLARE_RETRIEVE, , ARROW_BACKEND_TYPES)
+        #endif
+        #undef DECLARE_RETRIEVE
+
+      private:
+
+        // Directory holding the output files
+        std::string output_dir;
+
+        // The stream files of the output
+        std::vector<std::unique_ptr<Arrow::StreamReader>> files;
+
+        /// A row of a batch of one of the files
+        struct Location
+        {
+            uint file;
+            uint batch;
+            uint row;
+        };
+
+        // All points, and their position in that list
+        std::vector<PPIDpair> points;
+        std::map<PPIDpair,std::size_t> point_index;
+
+        // The rows of each point, in the order they were read (e.g. the primary stream, then
+        // the auxiliary streams that printed further values for the same point)
+        std::vector<std::vector<Location>> point_rows;
+
+        // Type of every label, and its column in each file (-1 if the file does not have it)
+        std::map<std::string,Arrow::Field> fields;
+        std::map<std::string,std::vector<long>> columns;
+
+        // Index of the point at the current read-head position
+        ulong current_dataset_index;
+
+        // Map a stream file, and index its rows
+        void load_file(const std::string& path);
+
+        /// "Master" templated retrieve function.
+        /// All other retrieve functions should ultimately call this one
+        template<class T>
+        bool _retrieve_template(T& out, const std::string& label, const uint rank, const ulong pointID)
+        {
+            auto col_it = columns.find(label);
+            if(col_it==columns.end())
+            {
+                std::stringstream err;
+                err<<"Attempted to retrieve data for label '"<<label<<"' using ArrowReader, however this label does not exist in the output in '"<<output_dir<<"'!";
+                printer_error().raise(LOCAL_INFO, err.str());
+            }
+            auto pt_it = point_index.find(PPIDpair(pointID,rank));
+            if(pt_it==point_index.end())
+            {
+                std::stringstream err;
+                err<<"Attempted to retrieve '"<<label<<"' from point ("<<rank<<", "<<pointID<<") using ArrowReader, however this point does not exist in the output in '"<<output_dir<<"'!";
+                printer_error().raise(LOCAL_INFO, err.str());
+            }
+
+            // The last valid value printed for the point wins; missing values never replace existing ones
+            const std::vector<long>& column_in_file = col_it->second;
+            const std::vector<Location>& rows = point_rows[pt_it->second];
+            for(auto it = rows.rbegin(); it != rows.rend(); ++it)
+            {
+                const long c = column_in_file[it->file];
+                if(c < 0) continue;
+                const Arrow::StreamReader& file = *files[it->file];
+                if(not file.is_valid(it->batch, c, it->row)) continue;
+                out = file.value<T>(it->batch, c, it->row);
+                return true;
+            }
+            return false;
+        }
+
+    };
+
+    // Register reader so it can be constructed via inifile instructions
+    // First argument is string label for inifile access, second is class from which to construct printer
+    LOAD_READER(arrow, ArrowReader)
+
+  }
+}
+
+#endif
@@ -0,0 +1,47 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Sequence of all types printable by the Arrow
+///  printer.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __ARROWTYPES__
+#define __ARROWTYPES__
+
+#define ARROW_TYPES         \
+  (int)                     \
+  (uint)                    \
+  (long)                    \
+  (ulong)                   \
+  (longlong)                \
+  (ulonglong)               \
+  (float)                   \
+  (double)                  \
+  (std::vector<double>)     \
+  (bool)                    \
+  (map_str_dbl)             \
+  (map_str_str)             \
+  (ModelParameters)         \
+  (triplet<double>)         \
+  (map_intpair_dbl)         \
+
+
+#ifdef GAMBIT_LIGHT
+  #define ARROW_BACKEND_TYPES
+#else
+  #define ARROW_BACKEND_TYPES           \
+    (DM_nucleon_couplings)              \
+    (BBN_container)
+#endif
+
+
+#endif
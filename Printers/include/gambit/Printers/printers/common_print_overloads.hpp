@@ -43,11 +43,14 @@ namespace Gambit
     template<typename P>
     void _common_print(P& printer, std::vector<double> const& value, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "[";
+      const std::string::size_type prefix = name.size();
       for(unsigned int i=0;i<value.size();i++)
       {
-        std::stringstream ss;
-        ss<<label<<"["<<i<<"]";
-        printer._print(value[i],ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += std::to_string(i);
+        name += "]";
+        printer._print(value[i],name,vID,mpirank,pointID);
       }
     }
 
@@ -55,23 +58,27 @@ namespace Gambit
     template<typename P>
     void _common_print(P& printer, const map_const_str_dbl& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "::";
+      const std::string::size_type prefix = name.size();
       for (map_const_str_dbl::const_iterator
            it = map.begin(); it != map.end(); it++)
       {
-        std::stringstream ss;
-        ss<<label<<"::"<<it->first;
-        printer._print(it->second,ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += it->first;
+        printer._print(it->second,name,vID,mpirank,pointID);
       }
     }
     template<typename P>
     void _common_print(P& printer, const map_str_dbl& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "::";
+      const std::string::size_type prefix = name.size();
       for (map_str_dbl::const_iterator
            it = map.begin(); it != map.end(); it++)
       {
-        std::stringstream ss;
-        ss<<label<<"::"<<it->first;
-        printer._print(it->second,ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += it->first;
+        printer._print(it->second,name,vID,mpirank,pointID);
       }
     }
 
@@ -79,23 +86,27 @@ namespace Gambit
     template<typename P>
     void _common_print(P& printer, const map_const_str_map_const_str_dbl& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "::";
+      const std::string::size_type prefix = name.size();
       for (map_const_str_map_const_str_dbl::const_iterator
            it = map.begin(); it != map.end(); it++)
       {
-        std::stringstream ss;
-        ss<<label<<"::"<<it->first;
-        printer._print(it->second,ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += it->first;
+        printer._print(it->second,name,vID,mpirank,pointID);
       }
     }
     template<typename P>
     void _common_print(P& printer, const map_str_map_str_dbl& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "::";
+      const std::string::size_type prefix = name.size();
       for (map_str_map_str_dbl::const_iterator
            it = map.begin(); it != map.end(); it++)
       {
-        std::stringstream ss;
-        ss<<label<<"::"<<it->first;
-        printer._print(it->second,ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += it->first;
+        printer._print(it->second,name,vID,mpirank,pointID);
       }
     }
 
@@ -103,12 +114,16 @@ namespace Gambit
     template<typename P>
     void _common_print(P& printer, const map_str_str& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
     {
+      std::string name = label + "::";
+      const std::string::size_type prefix = name.size();
       for (std::map<std::string, std::string>::const_iterator
            it = map.begin(); it != map.end(); it++)
       {
-        std::stringstream ss;
-        ss<<label<<"::"<<it->first<<":"<<it->second;
-        printer._print(0,ss.str(),vID,mpirank,pointID);
+        name.resize(prefix);
+        name += it->first;
+        name += ":";
+        name += it->second;
+        printer._print(0,name,vID,mpirank,pointID);
       }
     }
 
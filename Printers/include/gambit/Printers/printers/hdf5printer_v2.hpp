@@ -37,14 +37,26 @@
 #define __hdf5printer_v2_hpp__
 
 #include <algorithm>
+#include <cstring>
 #include <set>
+#include <regex>
+#include <unordered_map>
+#include <vector>
 #include <iterator>
 #include <string>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 // BOOST_PP
 #include <boost/preprocessor/seq/for_each_i.hpp>
 
 // GAMBIT
+#include "gambit/Printers/background_writer.hpp"
 #include "gambit/Utils/file_lock.hpp"
 #include "gambit/Utils/new_mpi_datatypes.hpp"
 #include "gambit/Utils/yaml_options.hpp"
@@ -58,6 +70,11 @@
 // Activate extra debug logging (warning, LOTS of output)
 //#define HDF5PRINTER2_DEBUG
 
+// Collective (MPI-IO) writes need MPI, and a HDF5 library built with parallel support
+#if defined(WITH_MPI) && defined(H5_HAVE_PARALLEL)
+  #define HDF5PRINTER2_COLLECTIVE
+#endif
+
 namespace Gambit
 {
   namespace Printers
@@ -72,8 +89,8 @@ namespace Gambit
     //static int recv_counter;
     //static int send_counter;
 
-    /// Length of chunks in chunked HDF5 dataset. Affects write/retrieval performance for blocks of data of various sizes.
-    /// It is set to an "intermediate" sort of size since that seems to work well enough.
+    /// Default length of chunks in chunked HDF5 dataset. Affects write/retrieval performance for blocks of data of various sizes.
+    /// It is set to an "intermediate" sort of size since that seems to work well enough (see the 'chunk_length' printer option).
     static const std::size_t HDF5_CHUNKLENGTH = 100;
 
     /// Dimension of output dataset. We are only using 1D datasets for simplicity.
@@ -95,6 +112,9 @@ namespace Gambit
     const int h5v2_BLOCK(30);
     // "Begin sending data" tag
     const int h5v2_BEGIN(31);
+    // Packed flush of the sync buffers, sent to the aggregating rank 0 during the scan
+    // (an empty message means "there are no more flushes from this process")
+    const int h5v2_AGGREGATE(32);
 
     // The 'h5v2_bufdata_type' messages send an integer encoding
     // the datatype for the h5v2_bufdata_values messages
@@ -110,6 +130,68 @@ namespace Gambit
         return result;
     }
 
+    /// Storage settings for an output dataset. The chunking and filters are fixed when the
+    /// dataset is created; only the chunk cache applies to datasets that already exist.
+    struct HDF5DataSetSettings
+    {
+        HDF5DataSetSettings();
+
+        /// Number of records per chunk
+        std::size_t chunk_length;
+
+        /// Deflate (gzip) compression level 1-9, or 0 for no compression
+        int deflate_level;
+
+        /// Apply the byte shuffle filter before compressing
+        bool shuffle;
+
+        /// Size of the chunk cache of each open dataset in bytes (0 keeps the HDF5 default)
+        std::size_t chunk_cache_bytes;
+
+        /// Store 0/1 flags with one bit per entry (only set for the validity flag datasets)
+        bool packed_flags;
+    };
+
+    /// HDF5 type of bit-packed flag datasets: an unsigned char with a precision of one bit,
+    /// stored through the N-bit filter. HDF5 converts it to and from any integer type on
+    /// reading and writing, so readers see the usual 0/1 values.
+    hid_t packed_flag_type();
+
+    /// Dataset storage settings for a printer, chosen by matching the dataset names
+    /// against regular expressions. The first matching pattern is used, and datasets
+    /// matching no pattern get the default settings.
+    class HDF5DataSetOptions
+    {
+      public:
+        HDF5DataSetOptions();
+
+        /// Read the settings from the printer options
+        HDF5DataSetOptions(const Options& options);
+
+        /// Settings for the dataset with the given name
+        const HDF5DataSetSettings& get(const std::string& dset_name) const;
+
+        /// Settings for the validity flag dataset with the given name
+        HDF5DataSetSettings get_flags(const std::string& dset_name) const;
+
+        /// Check whether any dataset may be compressed
+        bool any_compressed() const;
+
+        /// Check whether the validity flags are written bit-packed
+        bool packs_flags() const;
+
+      private:
+
+        /// Read settings from a block of options, starting from 'base'
+        static HDF5DataSetSettings read_settings(const Options& options, const HDF5DataSetSettings& base);
+
+        HDF5DataSetSettings defaults;
+        std::vector<std::pair<std::regex,HDF5DataSetSettings>> patterns;
+
+        /// Write the validity flags bit-packed, rather than as one int per entry
+        bool pack_flags;
+    };
+
     /// Base class for interfacing to a HDF5 dataset
     class HDF5DataSetBase
     {
@@ -124,6 +206,14 @@ namespace Gambit
          /// Close dataset on disk and release handles
          void close_dataset();
 
+         /// Leave the dataset open when 'close_dataset' is called, so that the handles can
+         /// be reused by the next 'open_dataset'. Calling this with 'false' closes it.
+         void keep_open(const bool keep);
+
+         /// Set the chunking, filters and chunk cache used for this dataset
+         void set_settings(const HDF5DataSetSettings& new_settings);
+         const HDF5DataSetSettings& get_settings() const;
+
          /// Create a new dataset at the specified location
          /// (implemented in derived class since need to know the type)
          virtual void create_dataset(hid_t location_id) = 0;
@@ -149,6 +239,13 @@ namespace Gambit
          /// Retrieve the HDF5 type ID for this dataset
          hid_t get_hdftype_id() const;
 
+         /// HDF5 type with which new datasets are created (differs from the type of
+         /// the data in memory for bit-packed flags)
+         hid_t get_file_type_id() const;
+
+         /// Check that an existing dataset was stored with a type that we can write
+         bool stored_type_ok(const hid_t dtype) const;
+
          /// Variable tracking whether the dataset is known to exist in the output file yet
          bool get_exists_on_disk() const;
          void set_exists_on_disk();
@@ -170,6 +267,12 @@ namespace Gambit
          /// Flag to let us known if the dataset is open
          bool is_open;
 
+         /// Flag to keep the dataset open between accesses
+         bool stay_open;
+
+         /// Storage settings for the dataset
+         HDF5DataSetSettings settings;
+
          /// Variable tracking whether the dataset is known to exist in the output file yet
          bool exists_on_disk;
 
@@ -270,6 +373,64 @@ namespace Gambit
              return new_dset_size;
          }
 
+         /// Write a contiguous column of data to disk at the target position,
+         /// with a single H5Dwrite. The memory type U may differ from the type
+         /// of the dataset, in which case HDF5 converts the values (e.g. the
+         /// unsigned char validity flags of the buffers into int).
+         template<class U>
+         std::size_t write_column(const hid_t loc_id, const U* data, const std::size_t length, const std::size_t target_pos, const bool force=false)
+         {
+             open_dataset(loc_id);
+             write_array(data,length,target_pos,force);
+             std::size_t new_dset_size = get_dset_length();
+             close_dataset();
+
+             // Report new size of the dataset so that we can check that all datasets are the same length
+             return new_dset_size;
+         }
+
+#ifdef HDF5PRINTER2_COLLECTIVE
+         /// Write a contiguous column of data inside the current extents of the dataset,
+         /// with a collective MPI-IO write. Every process that opened the file must call
+         /// this together (with length zero if it has nothing to write).
+         template<class U>
+         void write_column_collective(const hid_t loc_id, const U* data, const std::size_t length, const std::size_t target_pos)
+         {
+             open_dataset(loc_id);
+
+             hid_t memspace_id, dspace_id;
+             if(length>0)
+             {
+                 std::pair<hid_t,hid_t> selection_ids = select_hyperslab(target_pos,length);
+                 memspace_id = selection_ids.first;
+                 dspace_id   = selection_ids.second;
+             }
+             else
+             {
+                 hsize_t one[DSETRANK] = {1};
+                 memspace_id = H5Screate_simple(DSETRANK, one, NULL);
+                 dspace_id   = H5Dget_space(get_dset_id());
+                 H5Sselect_none(memspace_id);
+                 H5Sselect_none(dspace_id);
+             }
+
+             hid_t dxpl_id = H5Pcreate(H5P_DATASET_XFER);
+             H5Pset_dxpl_mpio(dxpl_id, H5FD_MPIO_COLLECTIVE);
+             herr_t status = H5Dwrite(get_dset_id(), get_hdf5_data_type<U>::type(), memspace_id, dspace_id, dxpl_id, data);
+             if(status<0)
+             {
+                std::ostringstream errmsg;
+                errmsg << "Error writing new chunk to dataset (with name=\""<<myname()<<"\") in HDF5 file. Collective H5Dwrite failed." << std::endl;
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+             }
+
+             H5Pclose(dxpl_id);
+             H5Sclose(dspace_id);
+             H5Sclose(memspace_id);
+             close_dataset();
+         }
+#endif
+
          /// Write a block of data to disk at the end of the dataset
          /// This is the lower-level function. There is a fixed-size
          /// buffer that cannot be exceeded. If more data than
@@ -284,6 +445,15 @@ namespace Gambit
                  errmsg << "Error! Received buffer with length ("<<length<<") greater than MAX_BUFFER_SIZE ("<<MAX_BUFFER_SIZE<<") while tring to perform block write for dataset (name="<<myname()<<"). The input to this function is therefore invalid.";
                  printer_error().raise(LOCAL_INFO, errmsg.str());
              }
+             write_array(buffer,length,target_pos,force);
+         }
+
+         /// Write an array of data of any length to disk at the target position
+         /// (dataset must already be open). If force=true then target_pos can be
+         /// used to overwrite data.
+         template<class U>
+         void write_array(const U* data, const std::size_t length, const std::size_t target_pos, const bool force=false)
+         {
              if(length==0)
              {
                  std::ostringstream errmsg;
@@ -291,23 +461,18 @@ namespace Gambit
                  printer_error().raise(LOCAL_INFO, errmsg.str());
              }
 
-             // DEBUG dump whole buffer up to length to check it
-             //for(std::size_t i=0;i<length;++i)
-             //{
-             //    std::cout<<"    buffer["<<i<<"] = "<<buffer[i]<<std::endl;
-             //}
-
              ensure_dataset_is_open();
 
              // Get the C interface identifier for the type of the output dataset
              hid_t expected_dtype = get_hdftype_id();
              hid_t dtype = H5Dget_type(get_dset_id()); // type with which the dset was created
-             if(not H5Tequal(dtype, expected_dtype))
+             if(not stored_type_ok(dtype))
              {
                  std::ostringstream errmsg;
                  errmsg << "Error! Tried to write to dataset (name="<<myname()<<") with type id "<<dtype<<" but expected it to have type id "<<expected_dtype<<". This is a bug, please report it.";
                  printer_error().raise(LOCAL_INFO, errmsg.str());
              }
+             H5Tclose(dtype);
 
              std::size_t required_size = target_pos+length;
              // Check that target position is allowed
@@ -341,8 +506,8 @@ namespace Gambit
              hid_t memspace_id = selection_ids.first;
              hid_t dspace_id   = selection_ids.second;
 
-             // Write the data to the hyperslab.
-             herr_t status = H5Dwrite(get_dset_id(), get_hdftype_id(), memspace_id, dspace_id, H5P_DEFAULT, buffer);
+             // Write the data to the hyperslab (converting from the memory type if needed).
+             herr_t status = H5Dwrite(get_dset_id(), get_hdf5_data_type<U>::type(), memspace_id, dspace_id, H5P_DEFAULT, data);
              if(status<0)
              {
                 std::ostringstream errmsg;
@@ -353,8 +518,6 @@ namespace Gambit
              // Release the hyperslab IDs
              H5Sclose(dspace_id);
              H5Sclose(memspace_id);
-
-             //std::cout<<"write_buffer finished; new dataset size is: "<<get_dset_length()<<std::endl;
          }
 
          /// Write data to disk at specified positions
@@ -436,7 +599,7 @@ namespace Gambit
              // Get the C interface identifier for the type of the output dataset
              hid_t expected_dtype = get_hdftype_id();
              hid_t dtype = H5Dget_type(get_dset_id()); // type with which the dset was created
-             if(not H5Tequal(dtype, expected_dtype))
+             if(not stored_type_ok(dtype))
              {
                  std::ostringstream errmsg;
                  errmsg << "Error! Tried to write to dataset (name="<<myname()<<") with type id "<<dtype<<" but expected it to have type id "<<expected_dtype<<". This is a bug, please report it.";
@@ -446,7 +609,7 @@ namespace Gambit
              // Write data to selected points
              // (H5P_DEFAULT specifies some transfer properties for the I/O
              //  operation. These are the default values, probably are ok.)
-             hid_t errflag2 = H5Dwrite(get_dset_id(), dtype, dspace, dspace_id, H5P_DEFAULT, buffer);
+             hid_t errflag2 = H5Dwrite(get_dset_id(), expected_dtype, dspace, dspace_id, H5P_DEFAULT, buffer);
 
              if(errflag2<0) error_occurred = true;
 
@@ -550,7 +713,7 @@ namespace Gambit
         // Compute initial dataspace and chunk dimensions
         dims[0] = 0; // Empty to start
         maxdims[0] = H5S_UNLIMITED; // No upper limit on number of records allowed in dataset
-        chunkdims[0] = HDF5_CHUNKLENGTH;
+        chunkdims[0] = get_settings().chunk_length;
         //slicedims[0] = 1; // Dimensions of a single record in the data space
 
         // Create the data space
@@ -579,6 +742,30 @@ namespace Gambit
             printer_error().raise(LOCAL_INFO, errmsg.str());
         }
 
+        // Filter pipeline. Bit-packing and shuffling must come before the compression
+        // (shuffling does nothing to the single byte elements of packed flags).
+        if(get_settings().packed_flags)
+        {
+            status = H5Pset_nbit(cparms_id);
+            if(status<0)
+            {
+                std::ostringstream errmsg;
+                errmsg << "Error creating dataset (with name=\""<<myname()<<"\") in HDF5 file. H5Pset_nbit failed.";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+        }
+        if(get_settings().deflate_level>0)
+        {
+            if(get_settings().shuffle and not get_settings().packed_flags) status = H5Pset_shuffle(cparms_id);
+            if(status>=0) status = H5Pset_deflate(cparms_id, get_settings().deflate_level);
+            if(status<0)
+            {
+                std::ostringstream errmsg;
+                errmsg << "Error creating dataset (with name=\""<<myname()<<"\") in HDF5 file. Failed to set up the compression filters.";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+        }
+
         // Check if location id is invalid
         if(location_id==-1)
         {
@@ -588,7 +775,7 @@ namespace Gambit
         }
 
         // Create the dataset
-        hid_t dset_id = H5Dcreate2(location_id, myname().c_str(), get_hdftype_id(), dspace_id, H5P_DEFAULT, cparms_id, H5P_DEFAULT);
+        hid_t dset_id = H5Dcreate2(location_id, myname().c_str(), get_file_type_id(), dspace_id, H5P_DEFAULT, cparms_id, H5P_DEFAULT);
         if(dset_id<0)
         {
             std::ostringstream errmsg;
@@ -606,6 +793,161 @@ namespace Gambit
     }
 
 
+    /// Index of the points currently held in a set of buffers
+    /// Every point is given a slot, in order of arrival. The slot is the position
+    /// of the point in the data columns of all the buffers that share the index,
+    /// and also the order in which synchronised points are written to disk.
+    class HDF5PointIndex
+    {
+      public:
+
+        /// Slot returned by 'find' for points that are not in the index
+        static const std::size_t npos;
+
+        /// Get the slot of a point, adding the point in a new slot if it is not already known
+        std::size_t insert(const PPIDpair& ppid);
+
+        /// Get the slot of a point (npos if the point is not in the index)
+        std::size_t find(const PPIDpair& ppid) const;
+
+        /// Report the number of points in the index
+        std::size_t size() const;
+
+        /// Retrieve all points in the index, in slot order
+        const std::vector<PPIDpair>& points() const;
+
+        /// Remove a set of points from the index. The remaining points keep their order,
+        /// but move down to fill the freed slots. Returns the old slots of the remaining
+        /// points, in their new order, so that buffers can compact their data to match.
+        std::vector<std::size_t> erase(const std::set<PPIDpair>& removed_points);
+
+        /// Remove all points from the index
+        void clear();
+
+      private:
+
+        /// Points in slot order
+        std::vector<PPIDpair> _points;
+
+        /// Slot of each point
+        std::unordered_map<PPIDpair,std::size_t,PPIDHash,PPIDEqual> slots;
+    };
+
+    /// Validity flags of a data column, packed one bit per slot
+    /// (bit i%8 of byte i/8 is the flag of slot i)
+    class HDF5ValidityMask
+    {
+      public:
+
+        HDF5ValidityMask()
+          : bytes()
+          , nbits(0)
+        {}
+
+        std::size_t size() const { return nbits; }
+
+        bool operator[](const std::size_t i) const { return (bytes[i>>3]>>(i&7)) & 1u; }
+
+        void set(const std::size_t i, const bool flag)
+        {
+            if(flag) bytes[i>>3] |=  (1u<<(i&7));
+            else     bytes[i>>3] &= ~(1u<<(i&7));
+        }
+
+        /// Change the number of flags; new flags are 'invalid'
+        void resize(const std::size_t n)
+        {
+            if(n<nbits and (n&7)!=0)
+            {
+                // Clear the dropped bits of the last byte, so that they read as 'invalid' if regrown
+                bytes[n>>3] &= (1u<<(n&7))-1u;
+            }
+            bytes.resize((n+7)>>3, 0);
+            nbits = n;
+        }
+
+        void reserve(const std::size_t n) { bytes.reserve((n+7)>>3); }
+
+        void clear()
+        {
+            bytes.clear();
+            nbits = 0;
+        }
+
+        void swap(HDF5ValidityMask& other)
+        {
+            bytes.swap(other.bytes);
+            std::swap(nbits, other.nbits);
+        }
+
+        /// Packed flags, for sending between processes
+        std::size_t nbytes() const { return bytes.size(); }
+        const unsigned char* data() const { return bytes.data(); }
+        unsigned char* data() { return bytes.data(); }
+
+        /// One flag (0 or 1) per slot, for writing to disk
+        std::vector<unsigned char> unpack() const
+        {
+            std::vector<unsigned char> out(nbits);
+            for(std::size_t i=0; i<nbits; ++i) out[i] = (*this)[i];
+            return out;
+        }
+
+      private:
+
+        std::vector<unsigned char> bytes;
+        std::size_t nbits;
+    };
+
+    /// Append raw bytes to a byte stream
+    inline void pack_bytes(std::vector<char>& out, const void* data, const std::size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+        out.insert(out.end(), bytes, bytes+size);
+    }
+
+    /// Copy raw bytes out of a byte stream, and move the read position past them
+    inline void unpack_bytes(const char*& in, void* data, const std::size_t size)
+    {
+        std::memcpy(data, in, size);
+        in += size;
+    }
+
+    /// Mutex held by whichever thread has an output HDF5 file open. The state of the
+    /// output datasets is only touched while it is held, since the background writers
+    /// use it too.
+    std::recursive_mutex& hdf5_file_mutex();
+
+    /// Data columns detached from a synchronised buffer, to be written to disk as
+    /// a block while the buffer collects new points
+    class HDF5BlockBase
+    {
+      public:
+
+        virtual ~HDF5BlockBase() {}
+
+        /// Make sure the datasets exist on disk with length target_pos, and write the block there
+        /// (the output file must be open, so the caller holds hdf5_file_mutex)
+        virtual void write(const hid_t loc_id, const std::size_t target_pos) = 0;
+
+        /// Append the type ID, dataset name and columns of the block to a byte stream
+        virtual void pack(std::vector<char>& out) const = 0;
+
+#ifdef HDF5PRINTER2_COLLECTIVE
+        /// Write the block into the existing datasets with a collective write
+        /// (see HDF5DataSet<T>::write_column_collective)
+        virtual void write_collective(const hid_t loc_id, const std::size_t target_pos) = 0;
+#endif
+    };
+
+    /// The blocks of all buffers of a master buffer, from one flush
+    typedef std::vector<std::unique_ptr<HDF5BlockBase>> HDF5BlockSet;
+
+    /// Thread which writes the flushes of a master buffer to disk in the background
+    typedef BackgroundWriter<HDF5BlockSet> HDF5BackgroundWriter;
+
+    template<class T> class HDF5Block;
+
     /// Base class for buffers
     class HDF5BufferBase
     {
@@ -623,16 +965,24 @@ namespace Gambit
         /// Report whether the dataset for which we are the buffer is known to exist on disk yet
         virtual bool exists_on_disk() const = 0;
 
-        /// Make sure buffer includes the input point (data will be set as 'invalid' unless given elsewhere)
-        virtual void update(const PPIDpair& ppid) = 0;
+        /// Empty buffer to disk as a block (in slot order) into the target position
+        virtual void block_flush(const hid_t loc_id, const std::size_t target_pos) = 0;
 
-        /// Empty buffer to disk as a block
-        virtual void block_flush(const hid_t loc_id, const std::vector<PPIDpair>& order, const std::size_t target_pos) = 0;
+        /// Detach the data as a block to be written to disk later, in slot order
+        /// (the buffer is left empty)
+        virtual std::unique_ptr<HDF5BlockBase> detach_block() = 0;
 
-        /// Empty buffer to disk as arbitrarily positioned data
+        /// Write buffer data to disk at arbitrary pre-existing positions
         virtual void random_flush(const hid_t loc_id, const std::map<PPIDpair,std::size_t>& position_map) = 0;
 
-        // Retrieve buffer data in specified order (leaving it empty!) along with type ID in
+        /// Keep only the data in the given (old) slots, in the given order
+        /// (called after points have been erased from the point index)
+        virtual void retain(const std::vector<std::size_t>& kept_slots) = 0;
+
+        /// Discard all data in the buffer (called when the point index is cleared)
+        virtual void clear() = 0;
+
+        // Retrieve buffer data in specified order along with type ID in
         // As a double.
         virtual std::pair<std::vector<double>,std::vector<int>> flush_to_vector_dbl(const std::vector<PPIDpair>& order) = 0;
         // int version
@@ -650,15 +1000,18 @@ namespace Gambit
         /// Clear all data in memory ***and on disk*** for this buffer
         virtual void reset(hid_t loc_id) = 0;
 
+        /// Keep the output datasets open between accesses (or close them, if 'false')
+        virtual void keep_datasets_open(const bool keep) = 0;
+
+        /// Set the storage settings of the output datasets (data values and validity flags)
+        virtual void set_dataset_settings(const HDF5DataSetOptions& options) = 0;
+
         // Report whether this buffer is synchronised
         bool is_synchronised() const;
 
         // Report the number of items currently in the buffer;
         virtual std::size_t N_items_in_buffer() = 0;
 
-        /// Report all the points in this buffer
-        std::set<PPIDpair> get_points_set() const;
-
         /// Retrieve the integer type ID for this dataset
         virtual int get_type_id() const = 0;
 
@@ -671,23 +1024,19 @@ namespace Gambit
         /// to the output dataset, or look up and overwrite existing points.
         bool synchronised;
 
-      protected:
-
-        /// Set detailing what points are in the buffer
-        std::set<PPIDpair> buffer_set;
-
-        /// Buffer specifying whether the data in the primary buffer is "valid".
-        std::map<PPIDpair,int> buffer_valid;
     };
 
     /// Class to manage buffer for a single output label
+    /// The data is stored in contiguous columns indexed by the slots of a point
+    /// index shared with the other buffers of the same master buffer, so every
+    /// buffer holds every buffered point (as 'invalid' data unless it was set).
     template<class T>
     class HDF5Buffer: public HDF5BufferBase
     {
       public:
 
         /// Constructor
-        HDF5Buffer(const std::string& name, const bool sync, const std::vector<PPIDpair>& buffered_points
+        HDF5Buffer(const std::string& name, const bool sync, HDF5PointIndex& buffered_points
 #ifdef WITH_MPI
           // Gambit MPI communicator context for use within the hdf5 printer system
         , GMPI::Comm& comm
@@ -696,161 +1045,147 @@ namespace Gambit
           : HDF5BufferBase(name,sync)
           , my_dataset(name)
           , my_dataset_valid(name+"_isvalid")
+          , points(buffered_points)
 #ifdef WITH_MPI
           , myComm(comm)
 #endif
-        {
-           // Add points known to other buffers (as 'invalid' data, for synchronisation purposes)
-           for(auto it=buffered_points.begin(); it!=buffered_points.end(); ++it)
-           {
-              update(*it);
-           }
-        }
+        {}
 
         /// Make sure buffer includes the specified point (data will be set as 'invalid' unless given elsewhere)
         void update(const PPIDpair& ppid)
         {
-            buffer[ppid]; // Create point with default value if it doesn't exist
-            buffer_set.insert(ppid);
-            auto it = buffer_valid.find(ppid);
-            // If point not already in the buffer, set it as invalid
-            if(it==buffer_valid.end())
-            {
-                buffer_valid[ppid] = 0;
-                // DEBUG
-                //std::cout<<"Set point "<<ppid<<" to 'invalid' for buffer "<<dset_name()<<std::endl;
-            }
+            points.insert(ppid);
         }
 
         /// Insert data to print buffer at the specified point (overwrite if it already exists in the buffer)
         void append(T const& value, const PPIDpair& ppid)
         {
-            buffer      [ppid] = value;
-            buffer_valid[ppid] = 1;
-            buffer_set.insert(ppid);
-            //logger()<<" ***Added valid data "<<value<<" to point "<<ppid<<" in buffer "<<dset_name()<<std::endl;
+            append_to_slot(value, points.insert(ppid));
         }
 
-        /// Empty the buffer to disk as block with the specified order into the target position
-        /// (only allowed if target_pos is beyond the current end of the dataset!)
-        void block_flush(const hid_t loc_id, const std::vector<PPIDpair>& order, const std::size_t target_pos)
+        /// Insert data to print buffer at a known slot of the point index
+        void append_to_slot(T const& value, const std::size_t slot)
         {
-            // Make sure output order is same size as the buffer to be output
-            if(order.size() != buffer.size())
-            {
-                std::ostringstream errmsg;
-                errmsg << "Supplied buffer ordering vector is not the same size as the buffer (buffer.size()="<<buffer.size()<<", order.size()="<<order.size()<<"; dset_name()="<<dset_name()<<"). This is a bug, please report it." <<std::endl;
-                errmsg << "Extra debug information:" << std::endl;
-                errmsg << "  buffer.size()       = "<<buffer.size()<<std::endl;
-                errmsg << "  buffer_valid.size() = "<<buffer_valid.size()<<std::endl;
-                errmsg << "  buffer_set.size() = "<<buffer_set.size()<<std::endl;
-                printer_error().raise(LOCAL_INFO, errmsg.str());
-            }
-
-            // Need to keep track of whether buffer points have been added to the ordered output
-            std::set<PPIDpair> done;
-
-            // Create a vector version of the buffer in the specified order
-            std::vector<T> ordered_buffer;
-            std::vector<int> ordered_buffer_valid;
-            for(auto ppid_it=order.begin(); ppid_it!=order.end(); ++ppid_it)
-            {
-                if(done.count(*ppid_it)!=0)
-                {
-                    std::ostringstream errmsg;
-                    errmsg << "Supplied buffer ordering vector contains a duplicate PPIDpair! This is a bug, please report it.";
-                    printer_error().raise(LOCAL_INFO, errmsg.str());
-                }
-                ordered_buffer      .push_back(buffer      .at(*ppid_it));
-                ordered_buffer_valid.push_back(buffer_valid.at(*ppid_it));
-                done.insert(*ppid_it);
-            }
-
-            // Check if any points were not added to the ordered buffer
-            std::set<PPIDpair> not_done = set_diff(buffer_set,done);
-
-            if(not_done.size()>0)
-            {
-                std::ostringstream errmsg;
-                errmsg << "Supplied buffer ordering vector does not specify order positions for all points in the buffer! This is a bug, please report it.";
-                printer_error().raise(LOCAL_INFO, errmsg.str());
-            }
+            fit();
+            values[slot] = value;
+            valid.set(slot,true);
+        }
 
-            if(ordered_buffer.size() != buffer.size())
-            {
-                std::ostringstream errmsg;
-                errmsg << "The ordered buffer we just constructed is not the same size as the original buffer! This is a bug, please report it.";
-                printer_error().raise(LOCAL_INFO, errmsg.str());
-            }
+        /// Empty the buffer to disk as block, in slot order, into the target position
+        /// (only allowed if target_pos is beyond the current end of the dataset!)
+        void block_flush(const hid_t loc_id, const std::size_t target_pos)
+        {
+            fit();
 
             // Perform dataset writes
         #ifdef HDF5PRINTER2_DEBUG
             logger()<<LogTags::printers<<LogTags::debug;
             logger()<<"Writing block of data to disk for dataset "<<dset_name()<<std::endl;
             logger()<<" Data to write (to target_pos="<<target_pos<<"):"<<std::endl;
-            for(auto it=ordered_buffer.begin(); it!=ordered_buffer.end(); ++it)
+            for(auto it=values.begin(); it!=values.end(); ++it)
             {
                 logger()<<"   "<<*it<<std::endl;
             }
             logger()<<EOM;
             #endif
 
-            std::size_t newsize   = my_dataset      .write_vector(loc_id,ordered_buffer      ,target_pos);
-            std::size_t newsize_v = my_dataset_valid.write_vector(loc_id,ordered_buffer_valid,target_pos);
+            write_columns(loc_id,target_pos,values,valid);
+
+            // Clear buffer variables (keeping the allocated columns for the next block)
+            clear();
+        }
+
+        /// Detach the data columns as a block to be written to disk later
+        std::unique_ptr<HDF5BlockBase> detach_block()
+        {
+            fit();
+            HDF5Block<T>* block = new HDF5Block<T>(*this);
+            block->values.swap(values);
+            block->valid .swap(valid);
+            values.reserve(block->values.size());
+            valid .reserve(block->valid .size());
+            return std::unique_ptr<HDF5BlockBase>(block);
+        }
+
+        /// Write data columns to disk as a block into the target position
+        void write_columns(const hid_t loc_id, const std::size_t target_pos, const std::vector<T>& column, const HDF5ValidityMask& mask)
+        {
+            const std::vector<unsigned char> column_valid(mask.unpack());
+            std::size_t newsize   = my_dataset      .write_column(loc_id,column      .data(),column      .size(),target_pos);
+            std::size_t newsize_v = my_dataset_valid.write_column(loc_id,column_valid.data(),column_valid.size(),target_pos);
             if(newsize!=newsize_v)
             {
                 std::ostringstream errmsg;
                 errmsg<<"Inconsistent dataset sizes detected after buffer flush! (newsize="<<newsize<<", newsize_v="<<newsize_v<<")";
                 printer_error().raise(LOCAL_INFO, errmsg.str());
             }
+        }
 
-            // Clear buffer variables
-            buffer      .clear();
-            buffer_valid.clear();
-            buffer_set.clear();
+#ifdef HDF5PRINTER2_COLLECTIVE
+        /// Write data columns into the existing datasets with collective writes
+        void write_columns_collective(const hid_t loc_id, const std::size_t target_pos, const std::vector<T>& column, const HDF5ValidityMask& mask)
+        {
+            const std::vector<unsigned char> column_valid(mask.unpack());
+            my_dataset      .write_column_collective(loc_id,column      .data(),column      .size(),target_pos);
+            my_dataset_valid.write_column_collective(loc_id,column_valid.data(),column_valid.size(),target_pos);
         }
+#endif
 
-        /// Empty the buffer to disk as "random access" data at pre-existing positions matching the point IDs
-        /// May not completely empty the buffer; points will be removed from the buffer if they are included
-        /// in the supplied position map.
+        /// Write the buffer to disk as "random access" data at pre-existing positions matching the point IDs
+        /// The points are left in the buffer; the master buffer erases the ones that were written
+        /// from the point index, and then calls 'retain' to drop them from the buffer.
         void random_flush(const hid_t loc_id, const std::map<PPIDpair,std::size_t>& position_map)
         {
+            fit();
             std::map<std::size_t,T> pos_buffer;
             std::map<std::size_t,int> pos_buffer_valid;
 
-            // DEBUG inspect buffer
-            //for(auto it=buffer.begin(); it!=buffer.end(); ++it)
-            //{
-            //    std::cout<<"buffer["<<it->first<<"] = "<<it->second<<std::endl;
-            //}
-
             for(auto it=position_map.begin(); it!=position_map.end(); ++it)
             {
                 const PPIDpair& ppid = it->first;
                 const std::size_t& position = it->second;
-                auto bit = buffer      .find(ppid);
-                auto vit = buffer_valid.find(ppid);
-                if(bit==buffer.end() or vit==buffer_valid.end())
+                std::size_t slot = points.find(ppid);
+                if(slot==HDF5PointIndex::npos)
                 {
                     std::ostringstream errmsg;
                     errmsg<<"Could not find point "<<ppid<<" in buffer! This is a bug, please report it."<<std::endl;
                     printer_error().raise(LOCAL_INFO, errmsg.str());
                 }
-                if(vit->second) // I think there is no reason to write the RA data to disk if it is invalid. Buffers should have been reset if need to clear points.
+                if(valid[slot]) // I think there is no reason to write the RA data to disk if it is invalid. Buffers should have been reset if need to clear points.
                 {
-                    pos_buffer      [position] = bit->second;
-                    pos_buffer_valid[position] = vit->second;
+                    pos_buffer      [position] = values[slot];
+                    pos_buffer_valid[position] = 1;
                 }
-                // Erase point from buffer
-                buffer      .erase(bit);
-                buffer_valid.erase(vit);
-                buffer_set.erase(ppid);
             }
             // Perform dataset writes
             my_dataset      .write_random(loc_id, pos_buffer      );
             my_dataset_valid.write_random(loc_id, pos_buffer_valid);
         }
 
+        /// Keep only the data in the given (old) slots, in the given order
+        void retain(const std::vector<std::size_t>& kept_slots)
+        {
+            // The point index has already been compacted, so the columns must cover the old slots
+            fit(kept_slots.empty() ? 0 : kept_slots.back()+1);
+
+            // Slots are kept in increasing order, so the data can be moved down in place
+            std::size_t j = 0;
+            for(auto it=kept_slots.begin(); it!=kept_slots.end(); ++it, ++j)
+            {
+                values[j] = values[*it];
+                valid.set(j,valid[*it]);
+            }
+            values.resize(j);
+            valid .resize(j);
+        }
+
+        /// Discard all data in the buffer
+        void clear()
+        {
+            values.clear();
+            valid .clear();
+        }
+
         /// Clear all data in the buffer ***and on disk***
         /// Only allowed for "random access" buffers
         void reset(hid_t loc_id)
@@ -860,9 +1195,7 @@ namespace Gambit
                 // Only need to clear the "validity" dataset
                 // Doesn't matter what values are in the main datasets
                 // once they are marked as 'invalid'.
-                buffer      .clear();
-                buffer_valid.clear();
-                buffer_set.clear();
+                clear();
                 //my_dataset      .reset(loc_id);
                 my_dataset_valid.reset(loc_id);
             }
@@ -884,6 +1217,7 @@ namespace Gambit
         /// Report whether the dataset for which we are the buffer exists on disk yet
         bool exists_on_disk() const
         {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_file_mutex());
             return my_dataset.get_exists_on_disk();
             // TODO: Should make sure that 'valid' dataset also exists on disk
         }
@@ -892,49 +1226,47 @@ namespace Gambit
         std::size_t N_items_in_buffer()
         {
             /// Might as well check the internal consistency of this buffer while we are at it
-            if( buffer.size()!=buffer_set.size()
-             or buffer.size()!=buffer_valid.size())
+            if(values.size()!=valid.size() or values.size()>points.size())
             {
                 std::ostringstream errmsg;
-                errmsg<<"Internal inconsistency detected in buffer for dataset "<<dset_name()<<"; the following variables should all be the same size, but are not:"<<std::endl;
-                errmsg<<"  buffer      .size() = "<<buffer      .size()<<std::endl;
-                errmsg<<"  buffer_valid.size() = "<<buffer_valid.size()<<std::endl;
-                errmsg<<"  buffer_set  .size() = "<<buffer_set  .size()<<std::endl;
+                errmsg<<"Internal inconsistency detected in buffer for dataset "<<dset_name()<<"; the data columns do not match the point index:"<<std::endl;
+                errmsg<<"  values.size() = "<<values.size()<<std::endl;
+                errmsg<<"  valid .size() = "<<valid .size()<<std::endl;
+                errmsg<<"  points.size() = "<<points.size()<<std::endl;
                 printer_error().raise(LOCAL_INFO, errmsg.str());
             }
-            return buffer.size();
+            return points.size();
         }
 
 #ifdef WITH_MPI
         // Send buffer contents to a different process
         void MPI_flush_to_rank(const unsigned int r)
         {
-            if(buffer.size()>0)
+            if(points.size()>0)
             {
+                fit();
                 // Get name of the dataset this buffer is associated with
                 std::string namebuf = dset_name();
-                // Copy point data and values into MPI send buffer
+                // Copy point data into MPI send buffers; the values and validity flags (we have to
+                // send the invalid points too, to maintain buffer synchronicity) are sent directly
+                // from the columns.
                 std::vector<unsigned long> pointIDs;
                 std::vector<unsigned int> ranks; // Will assume all PPIDpairs are valid. I think this is fine to do...
-                std::vector<int> valid; // We have to send the invalid points too, to maintain buffer synchronicity
-                std::vector<T> values;
                 int type(h5v2_type<T>()); // Get integer identifying the type of the data values
                 int more_buffers = 1; // Flag indicating that there is a block of data to receive
-                for(auto it=buffer.begin(); it!=buffer.end(); ++it)
+                for(auto it=points.points().begin(); it!=points.points().end(); ++it)
                 {
-                    pointIDs.push_back(it->first.pointID);
-                    ranks   .push_back(it->first.rank);
-                    valid   .push_back(buffer_valid.at(it->first));
-                    values  .push_back(it->second);
+                    pointIDs.push_back(it->pointID);
+                    ranks   .push_back(it->rank);
                 }
 
                 // Debug info
         #ifdef HDF5PRINTER2_DEBUG
                 logger()<<LogTags::printers<<LogTags::debug<<"Sending points for buffer "<<dset_name()<<std::endl
                                                            <<" (more_buffers: "<<more_buffers<<")"<<std::endl;
-                for(std::size_t i=0; i<buffer.size(); ++i)
+                for(std::size_t i=0; i<values.size(); ++i)
                 {
-                    logger()<<"   Sending point ("<<ranks.at(i)<<", "<<pointIDs.at(i)<<")="<<values.at(i)<<" (valid="<<valid.at(i)<<")"<<std::endl;
+                    logger()<<"   Sending point ("<<ranks.at(i)<<", "<<pointIDs.at(i)<<")="<<values.at(i)<<" (valid="<<(int)valid[i]<<")"<<std::endl;
                 }
                 logger()<<EOM;
                 #endif
@@ -946,15 +1278,13 @@ namespace Gambit
                 //send_counter+=1;
                 myComm.Send(&namebuf[0] , namebuf.size(), MPI_CHAR, r, h5v2_bufname);
                 myComm.Send(&type       , 1      , r, h5v2_bufdata_type);
-                myComm.Send(&values[0]  , Npoints, r, h5v2_bufdata_values);
+                myComm.Send(values.data(), Npoints, r, h5v2_bufdata_values);
                 myComm.Send(&pointIDs[0], Npoints, r, h5v2_bufdata_points);
                 myComm.Send(&ranks[0]   , Npoints, r, h5v2_bufdata_ranks);
-                myComm.Send(&valid[0]   , Npoints, r, h5v2_bufdata_valid);
+                myComm.Send(valid.data(), valid.nbytes(), r, h5v2_bufdata_valid);
 
-                // Clear buffer variables
-                buffer      .clear();
-                buffer_valid.clear();
-                buffer_set  .clear();
+                // Clear buffer variables (the master buffer clears the point index)
+                clear();
             }
         }
 
@@ -967,32 +1297,37 @@ namespace Gambit
             /// MPI buffers
             std::vector<unsigned long> pointIDs(Npoints);
             std::vector<unsigned int> ranks(Npoints);
-            std::vector<int> valid(Npoints);
-            std::vector<T> values(Npoints);
+            HDF5ValidityMask valid_in;
+            valid_in.resize(Npoints);
+            std::vector<T> values_in(Npoints);
 
             // Receive buffer data
-            myComm.Recv(&values[0]  , Npoints, r, h5v2_bufdata_values);
-            myComm.Recv(&pointIDs[0], Npoints, r, h5v2_bufdata_points);
-            myComm.Recv(&ranks[0]   , Npoints, r, h5v2_bufdata_ranks);
-            myComm.Recv(&valid[0]   , Npoints, r, h5v2_bufdata_valid);
+            myComm.Recv(&values_in[0], Npoints, r, h5v2_bufdata_values);
+            myComm.Recv(&pointIDs[0] , Npoints, r, h5v2_bufdata_points);
+            myComm.Recv(&ranks[0]    , Npoints, r, h5v2_bufdata_ranks);
+            myComm.Recv(valid_in.data(), valid_in.nbytes(), r, h5v2_bufdata_valid);
 
             // Pack it into this buffer
         #ifdef HDF5PRINTER2_DEBUG
             logger()<<LogTags::printers<<LogTags::debug<<"Adding points to buffer "<<dset_name()<<std::endl;
+            #endif
             for(std::size_t i=0; i<Npoints; ++i)
             {
                 // Extra Debug
-                logger()<<"   Adding received point ("<<ranks.at(i)<<", "<<pointIDs.at(i)<<")="<<values.at(i)<<" (valid="<<valid.at(i)<<")"<<std::endl;
+        #ifdef HDF5PRINTER2_DEBUG
+                logger()<<"   Adding received point ("<<ranks.at(i)<<", "<<pointIDs.at(i)<<")="<<values_in.at(i)<<" (valid="<<(int)valid_in[i]<<")"<<std::endl;
+                #endif
                 PPIDpair ppid(pointIDs.at(i), ranks.at(i));
-                if(valid.at(i))
+                if(valid_in[i])
                 {
-                    append(values.at(i), ppid);
+                    append(values_in.at(i), ppid);
                 }
                 else
                 {
                     update(ppid);
                 }
             }
+        #ifdef HDF5PRINTER2_DEBUG
             logger()<<EOM;
             #endif
 
@@ -1073,50 +1408,61 @@ namespace Gambit
 
         }
 
-        // Retrieve buffer data in specified order (removing the points specified in 'order' from the buffer)
+        // Retrieve buffer data in specified order
         // Points not in the buffer are returned as "invalid"
+        // (the points are not removed; the master buffer untracks them afterwards)
         // As a double.
         std::pair<std::vector<double>,std::vector<int>> flush_to_vector_dbl(const std::vector<PPIDpair>& order)
         {
-            std::vector<double> out_values;
-            std::vector<int> out_valid;
-            for(auto it=order.begin(); it!=order.end(); ++it)
-            {
-                if(buffer_set.find(*it)!=buffer_set.end())
-                {
-                    // Add to output vector
-                    out_values.push_back((double)buffer.at(*it));
-                    out_valid .push_back(buffer_valid.at(*it));
-                    // Remove from buffer
-                    buffer_set  .erase(*it);
-                    buffer      .erase(*it);
-                    buffer_valid.erase(*it);
-                }
-                else
-                {
-                    out_values.push_back(0);
-                    out_valid .push_back(0);
-                }
-            }
-            return std::make_pair(out_values,out_valid);
+            return flush_to_vector<double>(order);
         }
 
         // int version
         std::pair<std::vector<long>,std::vector<int>> flush_to_vector_int(const std::vector<PPIDpair>& order)
         {
-            std::vector<long> out_values;
+            return flush_to_vector<long>(order);
+        }
+
+        /// Retrieve the integer type ID for the buffered dataset
+        int get_type_id() const
+        {
+            return my_dataset.get_type_id();
+        }
+
+        /// Keep the output datasets open between accesses (or close them, if 'false')
+        void keep_datasets_open(const bool keep)
+        {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_file_mutex());
+            my_dataset      .keep_open(keep);
+            my_dataset_valid.keep_open(keep);
+        }
+
+        /// Set the storage settings of the output datasets (data values and validity flags)
+        void set_dataset_settings(const HDF5DataSetOptions& options)
+        {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_file_mutex());
+            my_dataset      .set_settings(options.get(my_dataset      .myname()));
+            my_dataset_valid.set_settings(options.get_flags(my_dataset_valid.myname()));
+        }
+
+      private:
+
+        /// Retrieve buffer data in specified order, converted to type U
+        template<class U>
+        std::pair<std::vector<U>,std::vector<int>> flush_to_vector(const std::vector<PPIDpair>& order)
+        {
+            fit();
+            std::vector<U> out_values;
             std::vector<int> out_valid;
+            out_values.reserve(order.size());
+            out_valid .reserve(order.size());
             for(auto it=order.begin(); it!=order.end(); ++it)
             {
-                if(buffer_set.find(*it)!=buffer_set.end())
+                std::size_t slot = points.find(*it);
+                if(slot!=HDF5PointIndex::npos)
                 {
-                    // Add to output vector
-                    out_values.push_back((long)buffer.at(*it));
-                    out_valid .push_back(buffer_valid.at(*it));
-                    // Remove from buffer
-                    buffer_set  .erase(*it);
-                    buffer      .erase(*it);
-                    buffer_valid.erase(*it);
+                    out_values.push_back((U)values[slot]);
+                    out_valid .push_back(valid[slot]);
                 }
                 else
                 {
@@ -1127,20 +1473,34 @@ namespace Gambit
             return std::make_pair(out_values,out_valid);
         }
 
-        /// Retrieve the integer type ID for the buffered dataset
-        int get_type_id() const
+        /// Extend the data columns to cover all slots of the point index
+        /// (new slots are 'invalid' until data is appended to them)
+        void fit()
         {
-            return my_dataset.get_type_id();
+            fit(points.size());
         }
 
-      private:
+        /// Extend the data columns to cover the first n slots
+        void fit(const std::size_t n)
+        {
+            if(values.size()<n)
+            {
+                values.resize(n);
+                valid .resize(n);
+            }
+        }
 
         /// Object that provides an interface to the output HDF5 dataset matching this buffer
         HDF5DataSet<T> my_dataset;
         HDF5DataSet<int> my_dataset_valid;
 
-        /// Buffer containing points to be written to disk upon "flush"
-        std::map<PPIDpair,T> buffer;
+        /// Index of the buffered points, shared with the other buffers of the master buffer
+        HDF5PointIndex& points;
+
+        /// Data columns, indexed by slot in the point index. They may be shorter than the
+        /// index, in which case the missing slots are 'invalid'.
+        std::vector<T> values;
+        HDF5ValidityMask valid;
 
 #ifdef WITH_MPI
         // Gambit MPI communicator context for use within the hdf5 printer system
@@ -1148,6 +1508,54 @@ namespace Gambit
 #endif
     };
 
+    /// Data columns detached from a HDF5Buffer<T>. The block writes to the datasets
+    /// of the buffer, so it must be written before the buffer is destroyed.
+    template<class T>
+    class HDF5Block: public HDF5BlockBase
+    {
+      public:
+
+        HDF5Block(HDF5Buffer<T>& buff)
+          : buffer(buff)
+        {}
+
+        void write(const hid_t loc_id, const std::size_t target_pos)
+        {
+            buffer.ensure_dataset_exists(loc_id,target_pos);
+            buffer.write_columns(loc_id,target_pos,values,valid);
+        }
+
+        /// The columns follow their length; see HDF5MasterBuffer::unpack_block
+        void pack(std::vector<char>& out) const
+        {
+            const int type(h5v2_type<T>());
+            const std::string name(buffer.dset_name());
+            const std::size_t name_length(name.size());
+            const std::size_t length(values.size());
+            pack_bytes(out, &type, sizeof(type));
+            pack_bytes(out, &name_length, sizeof(name_length));
+            pack_bytes(out, name.data(), name_length);
+            pack_bytes(out, &length, sizeof(length));
+            pack_bytes(out, values.data(), length*sizeof(T));
+            pack_bytes(out, valid.data(), valid.nbytes());
+        }
+
+#ifdef HDF5PRINTER2_COLLECTIVE
+        void write_collective(const hid_t loc_id, const std::size_t target_pos)
+        {
+            buffer.write_columns_collective(loc_id,target_pos,values,valid);
+        }
+#endif
+
+        /// Detached data columns, in slot order
+        std::vector<T> values;
+        HDF5ValidityMask valid;
+
+      private:
+
+        HDF5Buffer<T>& buffer;
+    };
+
     /// Class to manage a set of buffers for a single output type
     template<class T>
     class HDF5MasterBufferT
@@ -1155,25 +1563,25 @@ namespace Gambit
       public:
 
         /// Constructor
-        HDF5MasterBufferT(bool sync
+        HDF5MasterBufferT(bool sync, HDF5PointIndex& buffered_points
 #ifdef WITH_MPI
           , GMPI::Comm& comm
 #endif
           ) : synchronised(sync)
+            , points(buffered_points)
 #ifdef WITH_MPI
             , myComm(comm)
 #endif
         {}
 
         /// Retrieve buffer of our type for a given label
-        // Currently buffered points need to be supplied in case we have to create and fill a new buffer
-        HDF5Buffer<T>& get_buffer(const std::string& label, const std::vector<PPIDpair>& buffered_points)
+        HDF5Buffer<T>& get_buffer(const std::string& label)
         {
             auto it=my_buffers.find(label);
             if(it==my_buffers.end())
             {
                 // No buffer with this name. Need to create one!
-                my_buffers.emplace(label,HDF5Buffer<T>(label,synchronised,buffered_points
+                my_buffers.emplace(label,HDF5Buffer<T>(label,synchronised,points
 #ifdef WITH_MPI
                  , myComm
 #endif
@@ -1187,6 +1595,8 @@ namespace Gambit
 
         std::map<std::string,HDF5Buffer<T>> my_buffers;
         bool synchronised;
+        /// Point index shared by all buffers of the master buffer
+        HDF5PointIndex& points;
 #ifdef WITH_MPI
         // Gambit MPI communicator context for use within the hdf5 printer system
         GMPI::Comm& myComm;
@@ -1213,19 +1623,23 @@ namespace Gambit
         /// Queue up data to be written to disk when buffers are full
         template<class T>
         void schedule_print(T const& value, const std::string& label, const unsigned int mpirank, const unsigned long pointID)
+        {
+            schedule_print(value,get_buffer<T>(label),mpirank,pointID);
+        }
+
+        /// Queue up data for a buffer that has already been looked up (see get_print_buffer)
+        template<class T>
+        void schedule_print(T const& value, HDF5Buffer<T>& buffer, const unsigned int mpirank, const unsigned long pointID)
         {
             /// Check if the point is known to be in the buffers already
             PPIDpair thispoint(pointID,mpirank);
-            auto it = buffered_points_set.find(thispoint);
-            if(it==buffered_points_set.end())
+            std::size_t slot = buffered_points.find(thispoint);
+            if(slot==HDF5PointIndex::npos)
             {
-                /// While we are here, check that buffered_points and buffered_points_set are the same size
-                if(buffered_points.size() != buffered_points_set.size())
-                {
-                    std::stringstream msg;
-                    msg<<"Inconsistency detected between buffered_points and buffered_points_set sizes ("<<buffered_points.size()<<" vs "<<buffered_points_set.size()<<")! This is a bug, please report it."<<std::endl;
-                    printer_error().raise(LOCAL_INFO,msg.str());
-                }
+                #ifdef WITH_MPI
+                /// Write what the other processes have sent since we last looked (on rank 0)
+                if(aggregating and hold_file) poll_aggregator();
+                #endif
 
                 /// This is a new point! See if buffers are full and need to be flushed
                 if(is_synchronised() and buffered_points.size()>get_buffer_length())
@@ -1240,7 +1654,7 @@ namespace Gambit
                     // Buffer full, flush it out
                     flush();
                 }
-                else if(not is_synchronised() and buffered_points.size()>get_buffer_length())
+                else if(not is_synchronised() and not file_elsewhere and buffered_points.size()>get_buffer_length())
                 {
                     /// RA buffers may not have been able to fully flush, so check their length and report if it is getting big.
 
@@ -1255,21 +1669,47 @@ namespace Gambit
                     }
                 }
 
-                // Inform all buffers of this new point
-                update_all_buffers(thispoint);
-                // DEBUG
-                //std::cout<<"Adding point to buffered_points list: "<<thispoint<<std::endl;
-                buffered_points.push_back(thispoint);
-                buffered_points_set.insert(thispoint);
+                // Give the new point a slot in all buffers
+                slot = buffered_points.insert(thispoint);
             }
 
             // Add the new data to the buffer
-            get_buffer<T>(label,buffered_points).append(value,thispoint);
+            buffer.append_to_slot(value,slot);
+        }
+
+        /// Retrieve the buffer for a given output label (creating it if needed), for
+        /// printing to it repeatedly. Buffers are never destroyed before this object is.
+        template<class T>
+        HDF5Buffer<T>& get_print_buffer(const std::string& label)
+        {
+            return get_buffer<T>(label);
         }
 
         /// Empty all buffers to disk
+        /// (or hand them to the background writer, if there is one)
         void flush();
 
+        /// Write the flushes of synchronised buffers to disk from a background thread,
+        /// with at most max_queue flushes waiting to be written
+        void enable_background_writes(const std::size_t max_queue);
+
+        /// Wait until the background writer (if any) has written all queued flushes
+        void finish_background_writes();
+
+        /// Keep the output file, and the datasets of all buffers, open between accesses
+        /// (or close them, if 'false'). Other processes must not access the file meanwhile.
+        void hold_file_open(const bool hold);
+
+        /// Set the storage settings (chunking, compression) of the datasets of this buffer manager.
+        /// Applies to buffers created after the call.
+        void set_dataset_options(const HDF5DataSetOptions& options);
+        const HDF5DataSetOptions& get_dataset_options() const;
+
+        /// Keep away from the output file while another process holds it open: reset only
+        /// clears the buffers, and flushes leave the data in the buffers (or, when aggregating,
+        /// send it to rank 0) until this is called with 'false'
+        void leave_file_to_aggregator(const bool leave);
+
         /// Print metadata directly to disk
         void print_metadata(std::map<std::string,std::string>, bool);
 
@@ -1300,7 +1740,7 @@ namespace Gambit
                 msg<<"Error from MPI_Get_count while attempting to receive buffer data from rank "<<r<<" for dataset "<<dset_name<<"!";
                 printer_error().raise(LOCAL_INFO,msg.str());
             }
-            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name, buffered_points);
+            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name);
             //std::cout<<"(rank "<<myComm.Get_rank()<<") Npoints: "<<Npoints<<std::endl;
             buffer.MPI_recv_from_rank(r, Npoints);
             logger()<< LogTags::printers << LogTags::debug << "Received "<<Npoints<<" points from rank "<<r<<"'s buffers (for dataset: "<<dset_name<<")"<<EOM;
@@ -1312,20 +1752,46 @@ namespace Gambit
         template<class T>
         void MPI_add_int_block_to_buffer(const HDF5bufferchunk& chunk, const std::string& dset_name, const std::size_t dset_index)
         {
-            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name, buffered_points);
+            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name);
             buffer.add_int_block(chunk,dset_index);
         }
 
         template<class T>
         void MPI_add_float_block_to_buffer(const HDF5bufferchunk& chunk, const std::string& dset_name, const std::size_t dset_index)
         {
-            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name, buffered_points);
+            HDF5Buffer<T>& buffer = get_buffer<T>(dset_name);
             buffer.add_float_block(chunk,dset_index);
         }
 
         // Add a vector of buffer chunk data to the buffers managed by this object
         void add_to_buffers(const std::vector<HDF5bufferchunk>& blocks, const std::vector<std::pair<std::string,int>>& buf_types);
 
+        /// Send the flushes of these (synchronised) buffers to rank 0 during the scan, where
+        /// they are written to the output file, which rank 0 holds open until finish_aggregation.
+        /// Each process waits for rank 0 to receive its flushes once max_sends are outstanding
+        /// (0: never).
+        void enable_aggregation(const std::size_t max_sends);
+
+        /// On rank 0, receive and write the flushes still to come from the other processes,
+        /// and close the output file. On the other ranks, tell rank 0 that no more flushes
+        /// will come (the data still in the buffers is left for the final gather).
+        void finish_aggregation();
+
+        /// Wait until rank 0 has received all flushes sent by this process
+        void finish_aggregator_sends();
+
+        /// On rank 0 (while aggregating), receive and write all flushes that have arrived
+        /// from other processes
+        void poll_aggregator();
+
+        /// Write the buffers of all processes to the output file at once, each process
+        /// writing its own rows with collective parallel HDF5 (MPI-IO) writes. All processes
+        /// must call this together, with the same list of all datasets (names and types).
+        void write_collective(const std::vector<std::pair<std::string,int>>& dsets);
+
+        /// Report whether collective writes are possible in this build (MPI and parallel HDF5)
+        static bool collective_writes_available();
+
         #endif
 
         /// Clear all data in buffers ***and on disk*** for this printer
@@ -1365,6 +1831,7 @@ namespace Gambit
         std::map<ulong, ulong> get_highest_PPIDs(const int mpisize);
 
         /// Open (and lock) output HDF5 file and obtain HDF5 handles
+        /// (after waiting for any background writes to finish)
         void lock_and_open_file(const char access_type='w'); // read/write allowed by default
 
         /// Close (and unlock) output HDF5 file and release HDF5 handles
@@ -1395,7 +1862,7 @@ namespace Gambit
         const std::map<std::string,HDF5BufferBase*>& get_all_buffers();
 
         /// Retrieve set containing all points currently known to be in these buffers
-        const std::set<PPIDpair>& get_all_points();
+        std::set<PPIDpair> get_all_points();
 
         /// Remove points from buffer tracking
         // (only intended to be used when points have been removed from buffers by e.g. MPI-related
@@ -1407,15 +1874,14 @@ namespace Gambit
         /// Map containing pointers to all buffers managed by this object;
         std::map<std::string,HDF5BufferBase*> all_buffers;
 
-        /// Vector of PPIDpairs that are currently stored in the printer buffers
-        /// This also defines the order in which points should ultimately be
-        /// written to disk (we will tell the buffers what order to print stuff,
-        /// they don't track the ordering themselves).
-        std::vector<PPIDpair> buffered_points;
+        /// Storage settings for the output datasets
+        HDF5DataSetOptions dset_options;
 
-        /// We also need a set of the buffered points, so we can do fast lookup of
-        /// whether a point is in the buffer or not.
-        std::set<PPIDpair> buffered_points_set;
+        /// Index of the PPIDpairs that are currently stored in the printer buffers
+        /// The slots of the index give the position of each point in the data
+        /// columns of all buffers, and also define the order in which points
+        /// should ultimately be written to disk.
+        HDF5PointIndex buffered_points;
 
         /// Flag to specify what sort of buffer this manager is supposed to be managing
         bool synchronised;
@@ -1425,19 +1891,102 @@ namespace Gambit
 
         /// Retrieve the buffer for a given output label (and type)
         template<class T>
-        HDF5Buffer<T>& get_buffer(const std::string& label, const std::vector<PPIDpair>& buffered_points);
+        HDF5Buffer<T>& get_buffer(const std::string& label);
 
         /// Add base class pointer for a buffer to master buffer map
         void update_buffer_map(const std::string& label, HDF5BufferBase& buff);
 
-        /// Inform all buffers that data has been written to certain mpirank/pointID pair
-        /// They will make sure that they have an output slot for this pair, so that all the
-        /// buffers for this printer stay "synchronised".
-        void update_all_buffers(const PPIDpair& ppid);
+        /// Erase points from the point index, and drop their data from all buffers
+        void erase_points(const std::set<PPIDpair>& removed_points);
+
+        /// Clear the point index, and all data in the buffers
+        void clear_points();
 
         /// Obtain positions in output datasets for a buffer of points
         std::map<PPIDpair,std::size_t> get_position_map(const std::vector<PPIDpair>& buffer) const;
 
+        /// Open (and lock) output HDF5 file, without waiting for the background writer
+        void lock_and_open_file_now(const char access_type='w');
+
+        /// Release the output file after an error, without raising another one: close
+        /// whatever is open (unless it is held open), and give up the file lock and mutex
+        void abandon_file();
+
+        /// Releases the open output file on every way out of a scope: normally by
+        /// 'close', or by abandon_file if an error is raised first
+        class OpenFileGuard
+        {
+          public:
+            OpenFileGuard(HDF5MasterBuffer& master) : master(master), open(true) {}
+            OpenFileGuard(const OpenFileGuard&) = delete;
+            OpenFileGuard& operator=(const OpenFileGuard&) = delete;
+            ~OpenFileGuard() { if(open) master.abandon_file(); }
+
+            /// Close (and unlock) the file
+            void close()
+            {
+                open = false;
+                master.close_and_unlock_file();
+            }
+
+          private:
+            HDF5MasterBuffer& master;
+            bool open;
+        };
+
+        /// Write the blocks of a synchronised flush to the end of the output datasets
+        void write_blocks(HDF5BlockSet& blocks);
+
+        /// Flag to keep the output file open between accesses
+        bool hold_file;
+
+        /// Flag to keep away from the output file, which another process holds open
+        bool file_elsewhere;
+
+        /// Flag to aggregate the flushes of all processes on rank 0
+        bool aggregating;
+
+        /// Flag to register that the file was opened by all processes together (not locked)
+        bool file_collective;
+
+#ifdef HDF5PRINTER2_COLLECTIVE
+        /// Open the output file for collective MPI-IO access by all processes
+        void open_file_collective();
+#endif
+
+#ifdef WITH_MPI
+        /// Number of processes that have told rank 0 that they have no more flushes to send
+        int aggregator_ends;
+
+        /// Max number of flushes sent to rank 0 that it has not received yet (0: no limit)
+        std::size_t max_aggregator_sends;
+
+        /// Packed flushes sent to rank 0, kept until the sends have completed
+        std::deque<std::pair<MPI_Request,std::vector<char>>> aggregator_sends;
+
+        /// Pack the blocks of a flush and send them to rank 0, without waiting
+        void send_to_aggregator(HDF5BlockSet& blocks);
+
+        /// Receive a (probed) flush from another process and write it. Returns false if
+        /// the message instead said that there are no more flushes from that process.
+        bool recv_aggregated(const MPI_Status& status);
+
+        /// Rebuild a block packed by HDF5Block<T>::pack, from the point after its name,
+        /// for the buffer with the same name
+        template<class T>
+        std::unique_ptr<HDF5BlockBase> unpack_block(const std::string& label, const char*& in)
+        {
+            std::size_t length;
+            unpack_bytes(in, &length, sizeof(length));
+            HDF5Block<T>* block = new HDF5Block<T>(get_buffer<T>(label));
+            block->values.resize(length);
+            block->valid .resize(length);
+            unpack_bytes(in, block->values.data(), length*sizeof(T));
+            unpack_bytes(in, block->valid .data(), block->valid.nbytes());
+            return std::unique_ptr<HDF5BlockBase>(block);
+        }
+#endif
+
         /// Output file variales
         std::string file;  // Output HDF5 file
         std::string group; // HDF5 group location to store datasets
@@ -1481,17 +2030,20 @@ namespace Gambit
         GMPI::Comm& myComm;
 #endif
 
+        /// Thread writing synchronised flushes to disk (null if writes are done directly)
+        std::unique_ptr<HDF5BackgroundWriter> writer;
+
     };
 
     /// Specialisation declarations for 'get_buffer' function for each buffer type
-    template<> HDF5Buffer<int      >& HDF5MasterBuffer::get_buffer<int      >(const std::string& label, const std::vector<PPIDpair>&);
-    template<> HDF5Buffer<uint     >& HDF5MasterBuffer::get_buffer<uint     >(const std::string& label, const std::vector<PPIDpair>&);
-    template<> HDF5Buffer<long     >& HDF5MasterBuffer::get_buffer<long     >(const std::string& label, const std::vector<PPIDpair>&);
-    template<> HDF5Buffer<ulong    >& HDF5MasterBuffer::get_buffer<ulong    >(const std::string& label, const std::vector<PPIDpair>&);
-    //template<> HDF5Buffer<longlong >& HDF5MasterBuffer::get_buffer<longlong >(const std::string& label, const std::vector<PPIDpair>&);
-    //template<> HDF5Buffer<ulonglong>& HDF5MasterBuffer::get_buffer<ulonglong>(const std::string& label, const std::vector<PPIDpair>&);
-    template<> HDF5Buffer<float    >& HDF5MasterBuffer::get_buffer<float    >(const std::string& label, const std::vector<PPIDpair>&);
-    template<> HDF5Buffer<double   >& HDF5MasterBuffer::get_buffer<double   >(const std::string& label, const std::vector<PPIDpair>&);
+    template<> HDF5Buffer<int      >& HDF5MasterBuffer::get_buffer<int      >(const std::string& label);
+    template<> HDF5Buffer<uint     >& HDF5MasterBuffer::get_buffer<uint     >(const std::string& label);
+    template<> HDF5Buffer<long     >& HDF5MasterBuffer::get_buffer<long     >(const std::string& label);
+    template<> HDF5Buffer<ulong    >& HDF5MasterBuffer::get_buffer<ulong    >(const std::string& label);
+    //template<> HDF5Buffer<longlong >& HDF5MasterBuffer::get_buffer<longlong >(const std::string& label);
+    //template<> HDF5Buffer<ulonglong>& HDF5MasterBuffer::get_buffer<ulonglong>(const std::string& label);
+    template<> HDF5Buffer<float    >& HDF5MasterBuffer::get_buffer<float    >(const std::string& label);
+    template<> HDF5Buffer<double   >& HDF5MasterBuffer::get_buffer<double   >(const std::string& label);
 
     /// The main printer class for output to HDF5 format
     class HDF5Printer2: public BasePrinter
@@ -1523,6 +2075,7 @@ namespace Gambit
         // Run by dependency resolver, which supplies the functors with a vector of VertexIDs whose requiresPrinting flags are set to true.
         void initialise(const std::vector<int>&);
         void flush();
+        void poll();
         void reset(bool force=false);
         void finalise(bool abnormal=false);
 
@@ -1541,6 +2094,11 @@ namespace Gambit
         #endif
         #undef DECLARE_PRINT
 
+        // Handle print functions for the types with their own buffers
+        #define DECLARE_HANDLE_PRINT(r,data,elem) void _print(elem const&, print_handle&, const uint, const ulong);
+        BOOST_PP_SEQ_FOR_EACH(DECLARE_HANDLE_PRINT, , (int)(uint)(long)(ulong)(longlong)(ulonglong)(float)(double)(bool))
+        #undef DECLARE_HANDLE_PRINT
+
         // Print metadata info to file
         void _print_metadata(map_str_str);
 
@@ -1553,6 +2111,12 @@ namespace Gambit
         /// (get_primary_printer returns a pointer-to-base)
         HDF5Printer2* get_HDF5_primary_printer();
 
+        /// Report whether the sync buffer flushes are aggregated on rank 0
+        bool get_aggregate_output();
+
+        /// Retrieve the dataset storage settings (used by auxilliary printers)
+        const HDF5DataSetOptions& get_dataset_options() const;
+
 #ifdef WITH_MPI
         /// Get reference to Comm object
         GMPI::Comm& get_Comm();
@@ -1575,6 +2139,12 @@ namespace Gambit
         /// True if metadata is being printed
         bool use_metadata;
 
+        /// True if the sync buffer flushes of all processes are written by rank 0 during the scan
+        bool aggregate_output;
+
+        /// True if the sync buffers of all processes are written with collective writes at the end
+        bool collective_output;
+
 #ifdef WITH_MPI
         /// Gambit MPI communicator context for use within the hdf5 printer system
         GMPI::Comm myComm; // initially attaches to MPI_COMM_WORLD
@@ -1582,6 +2152,9 @@ namespace Gambit
         /// Determine ID codes to use for buffer transmission
         std::pair<std::map<std::string,int>,std::vector<std::pair<std::string,int>>> get_buffer_idcodes(const std::vector<HDF5MasterBuffer*>& masterbuffers);
 
+        /// Agree on the names and types of all datasets written by the given buffers on any process
+        std::vector<std::pair<std::string,int>> get_all_dset_defs(const std::vector<HDF5MasterBuffer*>& masterbuffers);
+
         /// Gather buffer data from all processes via MPI and print it on rank 0
         void gather_and_print(HDF5MasterBuffer& out_printbuffer, const std::vector<HDF5MasterBuffer*>& masterbuffers, bool sync);
 
@@ -1637,26 +2210,20 @@ namespace Gambit
             lastPointID = PPIDpair(pointID, mpirank);
         }
 
-        template<typename T>
-        void print_map_str_dbl(const T& map, const std::string& label, const unsigned int mpirank, const unsigned long pointID)
+        template<class T>
+        void handle_print(T const& value, print_handle& handle, const unsigned int mpirank, const unsigned long pointID)
         {
-          for (typename T::const_iterator it = map.begin(); it != map.end(); it++)
-          {
-            std::stringstream ss;
-            ss<<label<<"::"<<it->first;
-            basic_print(it->second,ss.str(),mpirank,pointID);
-          }
-        }
+            // Look up the buffer only on the first print through this handle
+            HDF5Buffer<T>* buffer = static_cast<HDF5Buffer<T>*>(handle.get_slot(printer_serial, h5v2_type<T>()));
+            if(buffer==NULL)
+            {
+                buffer = &buffermaster.get_print_buffer<T>(handle.label());
+                handle.set_slot(printer_serial, h5v2_type<T>(), buffer);
+            }
+            buffermaster.schedule_print<T>(value,*buffer,mpirank,pointID);
 
-        template<typename T>
-        void print_map_str_map_str_dbl(const T& map, const std::string& label, const int vID, const unsigned int mpirank, const unsigned long pointID)
-        {
-          for (typename T::const_iterator it = map.begin(); it != map.end(); it++)
-          {
-            std::stringstream ss;
-            ss<<label<<"::"<<it->first;
-            _print(it->second,ss.str(),vID,mpirank,pointID);
-          }
+            // Update the last printed point ID
+            lastPointID = PPIDpair(pointID, mpirank);
         }
 
         /// @}
@@ -130,6 +130,10 @@ namespace Gambit
         // (Output is a map from names to types)
         std::map<std::string, std::string, Utils::ci_less> get_column_info();
 
+        // Prepare and step SQL statements, waiting while the database is locked by a writer
+        int prepare_sql(const std::string& sqlstr, sqlite3_stmt** stmt);
+        int step_sql(sqlite3_stmt* stmt);
+
         // Submit an SQL statement to the database
         int submit_sql(const std::string& local_info, const std::string& sqlstr, bool allow_fail=false, sql_callback_fptr callback=NULL, void* data=NULL, char **zErrMsg=NULL);
 
@@ -19,12 +19,15 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 #include <string>
 #include <limits>
+#include <type_traits>
 #include <sqlite3.h> // SQLite3 C interface
 
 // Gambit
 #include "gambit/Printers/baseprinter.hpp"
+#include "gambit/Printers/background_writer.hpp"
 #include "gambit/Printers/printers/sqlitebase.hpp"
 #include "gambit/Printers/printers/sqlitetypes.hpp"
 #include "gambit/Utils/util_functions.hpp" // Need Utils::ci_less to make map find() functions case-insensitive, since SQLite is case insensitive
@@ -35,6 +38,55 @@ namespace Gambit
   namespace Printers
   {
 
+    /// One value in the SQLitePrinter buffer. Values are kept in their native
+    /// type until they are bound to the prepared statement that writes them.
+    struct SQLiteCell
+    {
+        enum Kind { null_cell, integer_cell, real_cell };
+
+        Kind kind;
+        llint i;
+        double r;
+
+        SQLiteCell() : kind(null_cell), i(0), r(0) {}
+        explicit SQLiteCell(llint x) : kind(integer_cell), i(x), r(0) {}
+        explicit SQLiteCell(double x) : kind(real_cell), i(0), r(x) {}
+
+        template<class T>
+        static SQLiteCell from(T x)
+        {
+            return std::is_integral<T>::value ? SQLiteCell(llint(x)) : SQLiteCell(double(x));
+        }
+
+        /// SQLite integers are signed 64 bit, so larger unsigned values are stored as reals
+        /// (as SQLite itself does for integer literals that do not fit)
+        static SQLiteCell from(unsigned long long x)
+        {
+            if(x > (unsigned long long)std::numeric_limits<llint>::max()) return SQLiteCell(double(x));
+            return SQLiteCell(llint(x));
+        }
+        static SQLiteCell from(unsigned long x) { return from((unsigned long long)x); }
+    };
+
+    /// One row of the SQLitePrinter buffer
+    struct SQLiteRow
+    {
+        unsigned int mpirank;
+        unsigned long pointID;
+        std::vector<SQLiteCell> cells;
+    };
+
+    /// The contents of the SQLitePrinter buffer at a flush, written to the table as one transaction
+    struct SQLiteBatch
+    {
+        /// Buffer rows, keyed by pairID
+        std::map<std::size_t,SQLiteRow> rows;
+
+        /// Names and SQL types of the row columns
+        std::vector<std::string> header;
+        std::vector<std::string> types;
+    };
+
     /// The main printer class for output to SQLite database
     class SQLitePrinter : public BasePrinter, SQLiteBase
     {
@@ -43,7 +95,7 @@ namespace Gambit
         SQLitePrinter(const Options&, BasePrinter* const primary = NULL);
 
         /// Destructor
-        ~SQLitePrinter() {}
+        ~SQLitePrinter();
 
         /// Virtual function overloads:
         ///@{
@@ -62,6 +114,10 @@ namespace Gambit
         ///@}
 
        std::size_t get_max_buffer_length();
+       std::string get_journal_mode();
+       std::string get_synchronous();
+       std::size_t get_flush_queue_length();
+       bool get_use_upsert();
 
         ///@{ Print functions
         using BasePrinter::_print; // Tell compiler we are using some of the base class overloads of this on purpose.
@@ -84,11 +140,7 @@ namespace Gambit
         template<class T>
         void template_print(T const& value, const std::string& label, const int /*IDcode*/, const unsigned int mpirank, const unsigned long pointID, const std::string& col_type)
         {
-            typedef std::numeric_limits<T> lims;
-            std::stringstream sdata;
-            sdata.precision(lims::max_digits10);
-            sdata<<value;
-            insert_data(mpirank, pointID, label, col_type, sdata.str());
+            insert_data(mpirank, pointID, label, col_type, SQLiteCell::from(value));
         }
 
      private:
@@ -123,15 +175,38 @@ namespace Gambit
         // "Header" vector for buffer, recording column names for each vector position
         std::vector<std::string> buffer_header;
 
-        // Buffer for SQLite insertions. Kind of a 2D "array" of column data
-        // to be transformed into one big INSERT operation once full.
-        std::map<std::size_t,std::vector<std::string>> transaction_data_buffer;
+        // Buffer for SQLite insertions, keyed by pairID. Each row is written with
+        // the cached row statement, all of them in one transaction, once full.
+        std::map<std::size_t,SQLiteRow> transaction_data_buffer;
 
         /// @}
 
         // Determines whether output is new row insertions, or updates previously existing rows
         bool synchronised;
 
+        // Whether the SQLite library supports UPSERT (INSERT ... ON CONFLICT DO UPDATE, SQLite >= 3.24)
+        bool use_upsert;
+
+        // Journal mode and synchronous setting of the database connection ("" leaves the SQLite default)
+        std::string journal_mode;
+        std::string synchronous;
+
+        // Max number of flushed buffers waiting for the writer thread (0 if there is no writer thread)
+        std::size_t flush_queue_length;
+
+        // Thread writing the flushed buffers, if background flushes are enabled
+        std::unique_ptr<BackgroundWriter<SQLiteBatch>> writer;
+
+        /// @{ Cached prepared statement that writes one buffer row
+        sqlite3_stmt* row_stmt;
+
+        // Number of buffer_header columns when row_stmt was prepared
+        std::size_t row_stmt_ncols;
+
+        // buffer_header indices of the columns bound to row_stmt, from parameter ?4 on
+        std::vector<std::size_t> row_stmt_cols;
+        /// @}
+
         // Create results table
         void make_table(const std::string&);
         void make_metadata_table(const std::string&);
@@ -139,17 +214,28 @@ namespace Gambit
         // Check that a table column exists, and create it if needed
         void ensure_column_exists(const std::string&, const std::string&, const std::string&);
 
-        // Create an SQL table insert operation for the current transaction_data_buffer
-        // Modifies 'sql' stringstream in-place
-        void turn_buffer_into_insert(std::stringstream& sql, const std::string& table);
+        // Run a PRAGMA that sets a connection option, checking the value against the allowed ones
+        void set_pragma(const std::string& name, const std::string& value, const std::vector<std::string>& allowed);
 
         // Queue a table insert operation, and submit the queue if it is filled
-        void insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& col_name, const std::string& col_type, const std::string& data);
+        void insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& col_name, const std::string& col_type, const SQLiteCell& data);
+
+        // (Re)prepare row_stmt for the given columns, if needed
+        int prepare_row_statement(const std::vector<std::string>& header);
+        void finalize_row_statement();
 
-        // Submit and clear insert operation queue
+        // Bind and step row_stmt for every row of a batch. Returns an SQLite error code.
+        int write_batch_rows(const SQLiteBatch&);
+
+        // Create any new columns of a batch, then write its rows in one transaction
+        void write_batch(SQLiteBatch&);
+
+        // Submit and clear insert operation queue (in the background, if there is a writer thread)
         void dump_buffer();
-        void dump_buffer_as_INSERT();
-        void dump_buffer_as_UPDATE();
+
+        // Wait until the writer thread (if any) has written all flushed buffers. Must be called
+        // before this printer uses its database connection from the main thread.
+        void finish_background_writes();
 
         // Delete all buffer data and reset all buffer variables
         void clear_buffer();
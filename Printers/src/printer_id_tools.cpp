@@ -71,6 +71,12 @@ namespace Gambit
             }
         }
 
+        unsigned long long int next_printer_serial()
+        {
+            static unsigned long long int serial = 0;
+            return ++serial;
+        }
+
         int get_param_id(const std::string &name)
         {
             bool is_new; // Dummy for optional return argument
@@ -0,0 +1,732 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Minimal Arrow IPC stream writer and reader
+///  function definitions.
+///
+///  The metadata of each message is a flatbuffer
+///  (see Schema.fbs and Message.fbs in the Arrow
+///  format specification), which is encoded and
+///  decoded here by hand.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "gambit/Printers/printers/arrowipc.hpp"
+#include "gambit/Utils/standalone_error_handlers.hpp"
+#include "gambit/Utils/local_info.hpp"
+
+namespace Gambit
+{
+  namespace Printers
+  {
+    namespace Arrow
+    {
+
+      namespace
+      {
+        /// @{ Constants from the Arrow format flatbuffer schemas
+        const std::uint32_t continuation_marker = 0xFFFFFFFF;
+        const std::uint64_t metadata_version_V5 = 4;
+        const std::uint64_t header_Schema = 1;
+        const std::uint64_t header_DictionaryBatch = 2;
+        const std::uint64_t header_RecordBatch = 3;
+        const std::uint64_t type_Int = 2;
+        const std::uint64_t type_FloatingPoint = 3;
+        const std::uint64_t type_Bool = 6;
+        const std::uint64_t precision_SINGLE = 1;
+        const std::uint64_t precision_DOUBLE = 2;
+        /// @}
+
+        bool host_is_little_endian()
+        {
+            const std::uint16_t one = 1;
+            unsigned char first;
+            std::memcpy(&first, &one, 1);
+            return first==1;
+        }
+
+        /// Error in the layout of a stream file, raised as a printer error by read_stream
+        struct malformed_stream : public std::runtime_error
+        {
+            malformed_stream(const std::string& what) : std::runtime_error(what) {}
+        };
+
+        template<class T>
+        T load(const unsigned char* p)
+        {
+            T x;
+            std::memcpy(&x, p, sizeof(T));
+            return x;
+        }
+
+        /// Builds a flatbuffer front to back. Every object is written before the objects that
+        /// it refers to, so that all offsets point forwards as flatbuffers require; the offset
+        /// slots are filled in by link() once their targets have been written.
+        class FlatBuilder
+        {
+          public:
+            /// A table field: a scalar of 'size' bytes, or (size 4, value 0) an offset slot
+            struct Slot
+            {
+                int id;
+                std::size_t size;
+                std::uint64_t value;
+            };
+            static Slot offset(int id) { return Slot{id, 4, 0}; }
+
+            /// Position of a table, and of each of its fields (in the order they were given)
+            struct TableRef
+            {
+                std::size_t pos;
+                std::vector<std::size_t> fields;
+            };
+
+            /// The buffer starts with the offset of the root table
+            FlatBuilder() : buf(4, 0) {}
+
+            TableRef table(const std::vector<Slot>& slots)
+            {
+                int nslots = 0;
+                std::size_t max_size = 4;
+                for(const auto& s : slots)
+                {
+                    nslots = std::max(nslots, s.id+1);
+                    max_size = std::max(max_size, s.size);
+                }
+
+                // The vtable comes first, then the table, whose fields are ordered by decreasing size
+                align(2);
+                const std::size_t vt = buf.size();
+                buf.resize(vt + 4 + 2*nslots, 0);
+                align(max_size);
+                TableRef ref;
+                ref.pos = buf.size();
+                ref.fields.resize(slots.size());
+                append(ref.pos - vt, 4); // soffset to the vtable, which is 'soffset' bytes before the table
+
+                std::vector<std::size_t> order(slots.size());
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){ return slots[a].size > slots[b].size; });
+                for(std::size_t k : order)
+                {
+                    align(slots[k].size);
+                    ref.fields[k] = buf.size();
+                    append(slots[k].value, slots[k].size);
+                    store(vt + 4 + 2*slots[k].id, ref.fields[k] - ref.pos, 2);
+                }
+                store(vt, 4 + 2*nslots, 2);
+                store(vt + 2, buf.size() - ref.pos, 2);
+                return ref;
+            }
+
+            /// Vector of n offsets; returns its position. Slot i is at position + 4 + 4*i.
+            std::size_t offset_vector(std::size_t n)
+            {
+                align(4);
+                const std::size_t pos = buf.size();
+                append(n, 4);
+                buf.resize(buf.size() + 4*n, 0);
+                return pos;
+            }
+
+            /// Vector of structs made of 8-byte words, 'words_per_struct' each; returns its position
+            std::size_t struct_vector(const std::vector<std::uint64_t>& words, std::size_t words_per_struct)
+            {
+                // The elements must be 8-byte aligned, so the length goes just before an 8-byte boundary
+                while((buf.size()+4)%8 != 0) buf.push_back(0);
+                const std::size_t pos = buf.size();
+                append(words.size()/words_per_struct, 4);
+                for(std::uint64_t w : words) append(w, 8);
+                return pos;
+            }
+
+            std::size_t string(const std::string& s)
+            {
+                align(4);
+                const std::size_t pos = buf.size();
+                append(s.size(), 4);
+                buf.insert(buf.end(), s.begin(), s.end());
+                buf.push_back(0);
+                return pos;
+            }
+
+            /// Point the offset slot at 'slot' to the object at 'target'
+            void link(std::size_t slot, std::size_t target)
+            {
+                store(slot, target - slot, 4);
+            }
+
+            /// Set the root table, and return the buffer padded to a multiple of 8 bytes
+            std::vector<unsigned char>& finish(std::size_t root)
+            {
+                link(0, root);
+                align(8);
+                return buf;
+            }
+
+          private:
+            void align(std::size_t n)
+            {
+                while(buf.size()%n != 0) buf.push_back(0);
+            }
+
+            /// Write the lowest 'size' bytes of x in little endian order
+            void store(std::size_t pos, std::uint64_t x, std::size_t size)
+            {
+                for(std::size_t i=0; i<size; ++i) buf[pos+i] = (x >> (8*i)) & 0xFF;
+            }
+
+            void append(std::uint64_t x, std::size_t size)
+            {
+                buf.resize(buf.size() + size);
+                store(buf.size() - size, x, size);
+            }
+
+            std::vector<unsigned char> buf;
+        };
+
+        /// Read access to a flatbuffer table, with bounds checks on every access
+        class FlatTable
+        {
+          public:
+            FlatTable(const unsigned char* buf, std::size_t size, std::size_t pos)
+              : buf(buf), size(size), pos(pos)
+            {
+                check(pos, 4);
+                const long long vt = (long long)pos - load<std::int32_t>(buf+pos);
+                if(vt < 0) throw malformed_stream("table has an invalid vtable offset");
+                vtable = vt;
+                check(vtable, 4);
+                vtable_size = load<std::uint16_t>(buf+vtable);
+                check(vtable, vtable_size);
+            }
+
+            bool has(int id) const { return field(id) != 0; }
+
+            template<class T>
+            T scalar(int id, T def) const
+            {
+                const std::size_t f = field(id);
+                if(f==0) return def;
+                check(pos+f, sizeof(T));
+                return load<T>(buf+pos+f);
+            }
+
+            FlatTable table(int id) const
+            {
+                return FlatTable(buf, size, deref(field_pos(id)));
+            }
+
+            /// Number of elements of a vector field, each of 'elem_size' bytes. 'first' is set
+            /// to the position of the first element.
+            std::size_t vector(int id, std::size_t elem_size, std::size_t& first) const
+            {
+                const std::size_t v = deref(field_pos(id));
+                check(v, 4);
+                const std::size_t n = load<std::uint32_t>(buf+v);
+                first = v + 4;
+                if(elem_size > 0 and n > size/elem_size) throw malformed_stream("vector is longer than the buffer");
+                check(first, n*elem_size);
+                return n;
+            }
+
+            /// Table pointed to by element i of a vector of tables
+            FlatTable vector_table(std::size_t first, std::size_t i) const
+            {
+                return FlatTable(buf, size, deref(first + 4*i));
+            }
+
+            std::string string(int id) const
+            {
+                const std::size_t s = deref(field_pos(id));
+                check(s, 4);
+                const std::size_t n = load<std::uint32_t>(buf+s);
+                check(s+4, n);
+                return std::string(reinterpret_cast<const char*>(buf+s+4), n);
+            }
+
+            /// Read a little endian scalar at an absolute position, e.g. in a vector of structs
+            template<class T>
+            T at(std::size_t p) const
+            {
+                check(p, sizeof(T));
+                return load<T>(buf+p);
+            }
+
+          private:
+            std::size_t field(int id) const
+            {
+                if(4 + 2*(std::size_t)id + 2 > vtable_size) return 0;
+                return load<std::uint16_t>(buf + vtable + 4 + 2*id);
+            }
+
+            std::size_t field_pos(int id) const
+            {
+                const std::size_t f = field(id);
+                if(f==0) throw malformed_stream("required field is missing");
+                return pos + f;
+            }
+
+            /// Follow the uoffset stored at p
+            std::size_t deref(std::size_t p) const
+            {
+                check(p, 4);
+                return p + load<std::uint32_t>(buf+p);
+            }
+
+            void check(std::size_t p, std::size_t n) const
+            {
+                if(p > size or n > size - p) throw malformed_stream("offset out of bounds");
+            }
+
+            const unsigned char* buf;
+            std::size_t size;
+            std::size_t pos;
+            std::size_t vtable;
+            std::size_t vtable_size;
+        };
+
+        /// Pack one byte per value into an Arrow bitmap (least significant bit first)
+        void pack_bits(const std::vector<unsigned char>& bytes, std::size_t n, std::vector<unsigned char>& out)
+        {
+            const std::size_t start = out.size();
+            out.resize(start + (n+7)/8, 0);
+            for(std::size_t i=0; i<n; ++i)
+            {
+                if(bytes[i]) out[start + i/8] |= (unsigned char)(1u << (i%8));
+            }
+        }
+
+        void pad_to_8(std::vector<unsigned char>& body)
+        {
+            while(body.size()%8 != 0) body.push_back(0);
+        }
+
+        /// Add the custom_metadata field (a vector of KeyValue tables) to the table slot at 'slot'
+        void build_metadata(FlatBuilder& fb, std::size_t slot, const std::map<std::string,std::string>& metadata)
+        {
+            const std::size_t v = fb.offset_vector(metadata.size());
+            fb.link(slot, v);
+            std::size_t i = 0;
+            for(const auto& kv : metadata)
+            {
+                FlatBuilder::TableRef entry = fb.table({FlatBuilder::offset(0), FlatBuilder::offset(1)});
+                fb.link(v + 4 + 4*i++, entry.pos);
+                fb.link(entry.fields[0], fb.string(kv.first));
+                fb.link(entry.fields[1], fb.string(kv.second));
+            }
+        }
+
+        std::vector<unsigned char> schema_message(const std::vector<Field>& schema, const std::map<std::string,std::string>& metadata)
+        {
+            FlatBuilder fb;
+            FlatBuilder::TableRef msg = fb.table({{0,2,metadata_version_V5}, {1,1,header_Schema}, FlatBuilder::offset(2), {3,8,0}});
+            FlatBuilder::TableRef sch = fb.table(metadata.empty() ? std::vector<FlatBuilder::Slot>{{0,2,0}, FlatBuilder::offset(1)}
+                                                                  : std::vector<FlatBuilder::Slot>{{0,2,0}, FlatBuilder::offset(1), FlatBuilder::offset(2)});
+            fb.link(msg.fields[2], sch.pos);
+
+            const std::size_t fields = fb.offset_vector(schema.size());
+            fb.link(sch.fields[1], fields);
+            for(std::size_t i=0; i<schema.size(); ++i)
+            {
+                const Type t = schema[i].type;
+                const std::uint64_t type_type = t==Type::Bool ? type_Bool : (t==Type::Float32 or t==Type::Float64) ? type_FloatingPoint : type_Int;
+
+                // Field: name, nullable, type_type, type, children (required even though empty)
+                FlatBuilder::TableRef fld = fb.table({FlatBuilder::offset(0), {1,1,1}, {2,1,type_type}, FlatBuilder::offset(3), FlatBuilder::offset(5)});
+                fb.link(fields + 4 + 4*i, fld.pos);
+                fb.link(fld.fields[0], fb.string(schema[i].name));
+
+                FlatBuilder::TableRef type;
+                if(type_type==type_Int)
+                {
+                    const bool is_signed = t==Type::Int32 or t==Type::Int64;
+                    type = fb.table({{0,4,8*type_size(t)}, {1,1,is_signed}});
+                }
+                else if(type_type==type_FloatingPoint)
+                {
+                    type = fb.table({{0,2,t==Type::Float32 ? precision_SINGLE : precision_DOUBLE}});
+                }
+                else
+                {
+                    type = fb.table({});
+                }
+                fb.link(fld.fields[3], type.pos);
+                fb.link(fld.fields[4], fb.offset_vector(0));
+            }
+
+            if(not metadata.empty()) build_metadata(fb, sch.fields[2], metadata);
+            return fb.finish(msg.pos);
+        }
+
+        std::vector<unsigned char> record_batch_message(const std::vector<Field>& schema, const RecordBatch& batch, std::vector<unsigned char>& body)
+        {
+            const std::size_t n = batch.length;
+            std::vector<std::uint64_t> nodes;   // FieldNode {length, null_count}
+            std::vector<std::uint64_t> buffers; // Buffer {offset, length}; validity then values for each column
+            body.clear();
+            for(std::size_t i=0; i<schema.size(); ++i)
+            {
+                const Column& col = batch.columns[i];
+                const std::size_t size = type_size(schema[i].type);
+                if(col.valid.size()!=n or col.values.size()!=n*size)
+                {
+                    std::ostringstream err;
+                    err << "Column '" << schema[i].name << "' of an Arrow record batch has the wrong size (" << col.values.size()
+                        << " bytes of values and " << col.valid.size() << " validity flags, for " << n << " rows). This is a bug, please report it.";
+                    printer_error().raise(LOCAL_INFO, err.str());
+                }
+                const std::size_t null_count = n - std::count(col.valid.begin(), col.valid.end(), 1);
+                nodes.push_back(n);
+                nodes.push_back(null_count);
+
+                // The validity bitmap may be left out if there are no nulls
+                buffers.push_back(body.size());
+                if(null_count > 0) pack_bits(col.valid, n, body);
+                buffers.push_back(body.size() - buffers.back());
+                pad_to_8(body);
+
+                buffers.push_back(body.size());
+                if(schema[i].type==Type::Bool) pack_bits(col.values, n, body);
+                else body.insert(body.end(), col.values.begin(), col.values.end());
+                buffers.push_back(body.size() - buffers.back());
+                pad_to_8(body);
+            }
+
+            FlatBuilder fb;
+            FlatBuilder::TableRef msg = fb.table({{0,2,metadata_version_V5}, {1,1,header_RecordBatch}, FlatBuilder::offset(2), {3,8,body.size()}});
+            FlatBuilder::TableRef rb = fb.table({{0,8,n}, FlatBuilder::offset(1), FlatBuilder::offset(2)});
+            fb.link(msg.fields[2], rb.pos);
+            fb.link(rb.fields[1], fb.struct_vector(nodes, 2));
+            fb.link(rb.fields[2], fb.struct_vector(buffers, 2));
+            return fb.finish(msg.pos);
+        }
+
+        Type parse_type(const FlatTable& field)
+        {
+            const unsigned char type_type = field.scalar<unsigned char>(2, 0);
+            if(type_type==type_Bool) return Type::Bool;
+
+            const FlatTable type = field.table(3);
+            if(type_type==type_Int)
+            {
+                const std::int32_t bits = type.scalar<std::int32_t>(0, 0);
+                const bool is_signed = type.scalar<unsigned char>(1, 0);
+                if(bits==32) return is_signed ? Type::Int32 : Type::UInt32;
+                if(bits==64) return is_signed ? Type::Int64 : Type::UInt64;
+            }
+            else if(type_type==type_FloatingPoint)
+            {
+                const std::int16_t precision = type.scalar<std::int16_t>(0, 0);
+                if(precision==(std::int16_t)precision_SINGLE) return Type::Float32;
+                if(precision==(std::int16_t)precision_DOUBLE) return Type::Float64;
+            }
+            throw malformed_stream("column type is not supported (only bool, 32 and 64 bit integers and floating point numbers are)");
+        }
+
+        void parse_schema(const FlatTable& sch, std::vector<Field>& schema, std::map<std::string,std::string>& metadata)
+        {
+            if(sch.scalar<std::int16_t>(0, 0) != 0) throw malformed_stream("big endian data is not supported");
+
+            std::size_t first;
+            const std::size_t nfields = sch.has(1) ? sch.vector(1, 4, first) : 0;
+            for(std::size_t i=0; i<nfields; ++i)
+            {
+                const FlatTable fld = sch.vector_table(first, i);
+                std::size_t c;
+                if(fld.has(4)) throw malformed_stream("dictionary-encoded columns are not supported");
+                if(fld.has(5) and fld.vector(5, 4, c) > 0) throw malformed_stream("nested columns are not supported");
+                schema.push_back(Field{fld.string(0), parse_type(fld)});
+            }
+
+            const std::size_t nmeta = sch.has(2) ? sch.vector(2, 4, first) : 0;
+            for(std::size_t i=0; i<nmeta; ++i)
+            {
+                const FlatTable kv = sch.vector_table(first, i);
+                metadata[kv.string(0)] = kv.has(1) ? kv.string(1) : "";
+            }
+        }
+
+        /// Check the layout of a record batch against the schema, and find its buffers in the
+        /// message body: the validity bitmap (nullptr if every value is valid) and the values of
+        /// each column, in that order. Returns the number of rows.
+        std::size_t parse_record_batch(const FlatTable& rb, const std::vector<Field>& schema, const unsigned char* body, std::size_t body_length, std::vector<const unsigned char*>& column_buffers)
+        {
+            if(rb.has(3)) throw malformed_stream("compressed record batches are not supported");
+
+            const long long length = rb.scalar<std::int64_t>(0, 0);
+            if(length < 0) throw malformed_stream("record batch has a negative length");
+            const std::size_t n = length;
+
+            std::size_t nodes, buffers;
+            if(rb.vector(1, 16, nodes) != schema.size() or rb.vector(2, 16, buffers) != 2*schema.size())
+            {
+                throw malformed_stream("record batch does not match the schema");
+            }
+
+            column_buffers.assign(2*schema.size(), nullptr);
+            for(std::size_t i=0; i<schema.size(); ++i)
+            {
+                if(rb.at<std::int64_t>(nodes + 16*i) != length) throw malformed_stream("column length differs from the record batch length");
+                const std::int64_t null_count = rb.at<std::int64_t>(nodes + 16*i + 8);
+
+                // Buffer i: validity bitmap at 2*i, values at 2*i+1
+                std::uint64_t off[2], len[2];
+                for(int b=0; b<2; ++b)
+                {
+                    off[b] = rb.at<std::uint64_t>(buffers + 32*i + 16*b);
+                    len[b] = rb.at<std::uint64_t>(buffers + 32*i + 16*b + 8);
+                    if(off[b] > body_length or len[b] > body_length - off[b]) throw malformed_stream("buffer lies outside the message body");
+                }
+
+                const std::size_t bitmap_bytes = (n+7)/8;
+                if(not (null_count==0 and len[0]==0))
+                {
+                    if(len[0] < bitmap_bytes) throw malformed_stream("validity bitmap is too short");
+                    column_buffers[2*i] = body + off[0];
+                }
+
+                const Type t = schema[i].type;
+                if(t==Type::Bool)
+                {
+                    if(len[1] < bitmap_bytes) throw malformed_stream("value bitmap is too short");
+                }
+                else
+                {
+                    if(n > 0 and len[1]/type_size(t) < n) throw malformed_stream("value buffer is too short");
+                }
+                column_buffers[2*i+1] = body + off[1];
+            }
+            return n;
+        }
+
+      }
+
+      std::size_t type_size(Type t)
+      {
+          switch(t)
+          {
+              case Type::Bool:    return 1;
+              case Type::Int32:
+              case Type::UInt32:
+              case Type::Float32: return 4;
+              default:            return 8;
+          }
+      }
+
+      std::string type_name(Type t)
+      {
+          switch(t)
+          {
+              case Type::Bool:    return "bool";
+              case Type::Int32:   return "int32";
+              case Type::UInt32:  return "uint32";
+              case Type::Int64:   return "int64";
+              case Type::UInt64:  return "uint64";
+              case Type::Float32: return "float";
+              default:            return "double";
+          }
+      }
+
+      StreamWriter::StreamWriter(const std::string& path, const std::vector<Field>& schema, const std::map<std::string,std::string>& metadata)
+        : path(path)
+        , schema(schema)
+        , out(path, std::ios::binary | std::ios::trunc)
+      {
+          if(not host_is_little_endian())
+          {
+              printer_error().raise(LOCAL_INFO, "The Arrow printer only supports little endian machines.");
+          }
+          if(not out)
+          {
+              printer_error().raise(LOCAL_INFO, "Failed to create Arrow stream file '"+path+"'.");
+          }
+          write_message(schema_message(schema, metadata), std::vector<unsigned char>());
+      }
+
+      StreamWriter::~StreamWriter()
+      {
+          if(out.is_open())
+          {
+              try { close(); }
+              catch(...) {} // Destructors must not throw; the error was already raised (or will be) elsewhere
+          }
+      }
+
+      void StreamWriter::write(const RecordBatch& batch)
+      {
+          if(batch.columns.size()!=schema.size())
+          {
+              std::ostringstream err;
+              err << "Tried to write a record batch with " << batch.columns.size() << " columns to the Arrow stream '" << path
+                  << "', whose schema has " << schema.size() << " fields. This is a bug, please report it.";
+              printer_error().raise(LOCAL_INFO, err.str());
+          }
+          std::vector<unsigned char> body;
+          std::vector<unsigned char> metadata = record_batch_message(schema, batch, body);
+          write_message(metadata, body);
+      }
+
+      void StreamWriter::close()
+      {
+          if(not out.is_open()) return;
+          const std::uint32_t eos[2] = {continuation_marker, 0};
+          out.write(reinterpret_cast<const char*>(eos), sizeof(eos));
+          out.close();
+          if(out.fail())
+          {
+              printer_error().raise(LOCAL_INFO, "Failed to close Arrow stream file '"+path+"'.");
+          }
+      }
+
+      void StreamWriter::write_message(const std::vector<unsigned char>& metadata, const std::vector<unsigned char>& body)
+      {
+          // Continuation marker and metadata length; the metadata is padded so that the body is 8-byte aligned
+          const std::uint32_t prefix[2] = {continuation_marker, (std::uint32_t)metadata.size()};
+          out.write(reinterpret_cast<const char*>(prefix), sizeof(prefix));
+          out.write(reinterpret_cast<const char*>(metadata.data()), metadata.size());
+          out.write(reinterpret_cast<const char*>(body.data()), body.size());
+          out.flush();
+          if(not out)
+          {
+              printer_error().raise(LOCAL_INFO, "Failed to write to Arrow stream file '"+path+"'.");
+          }
+      }
+
+      StreamReader::StreamReader(const std::string& path)
+        : path(path)
+        , schema()
+        , metadata()
+        , batches()
+        , complete(false)
+        , data(nullptr)
+        , size(0)
+      {
+          if(not host_is_little_endian())
+          {
+              printer_error().raise(LOCAL_INFO, "Arrow stream files can only be read on little endian machines.");
+          }
+
+          const int fd = open(path.c_str(), O_RDONLY);
+          struct stat st;
+          if(fd < 0 or fstat(fd, &st) != 0)
+          {
+              if(fd >= 0) ::close(fd);
+              printer_error().raise(LOCAL_INFO, "Failed to open Arrow stream file '"+path+"' for reading.");
+          }
+          size = st.st_size;
+          if(size > 0)
+          {
+              void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+              if(mapped == MAP_FAILED)
+              {
+                  ::close(fd);
+                  printer_error().raise(LOCAL_INFO, "Failed to map Arrow stream file '"+path+"' into memory.");
+              }
+              data = static_cast<const unsigned char*>(mapped);
+          }
+          // The mapping stays valid after the file is closed
+          ::close(fd);
+
+          try
+          {
+              read_messages();
+          }
+          catch(...)
+          {
+              if(data != nullptr) munmap(const_cast<unsigned char*>(data), size);
+              throw;
+          }
+      }
+
+      StreamReader::~StreamReader()
+      {
+          if(data != nullptr) munmap(const_cast<unsigned char*>(data), size);
+      }
+
+      void StreamReader::read_messages()
+      {
+          bool have_schema = false;
+          std::size_t pos = 0;
+          std::vector<const unsigned char*> column_buffers;
+          try
+          {
+              while(true)
+              {
+                  if(size - pos < 8) return;
+                  if(load<std::uint32_t>(data+pos) != continuation_marker) throw malformed_stream("message does not start with the continuation marker");
+                  const std::int32_t meta_length = load<std::int32_t>(data+pos+4);
+                  if(meta_length==0) // End of stream
+                  {
+                      complete = true;
+                      return;
+                  }
+                  if(meta_length < 4) throw malformed_stream("message has an invalid metadata length");
+                  if(size - pos - 8 < (std::size_t)meta_length) return;
+
+                  const unsigned char* meta = data+pos+8;
+                  const FlatTable msg(meta, meta_length, load<std::uint32_t>(meta));
+                  if(msg.scalar<std::int16_t>(0, 0) < (std::int16_t)metadata_version_V5) throw malformed_stream("metadata version is older than V5");
+                  const long long body_length = msg.scalar<std::int64_t>(3, 0);
+                  const std::size_t body_pos = pos + 8 + meta_length;
+                  if(body_length < 0) throw malformed_stream("message has a negative body length");
+                  if(size - body_pos < (unsigned long long)body_length) return;
+
+                  const unsigned char header_type = msg.scalar<unsigned char>(1, 0);
+                  if(header_type==header_Schema and not have_schema)
+                  {
+                      parse_schema(msg.table(2), schema, metadata);
+                      have_schema = true;
+                  }
+                  else if(header_type==header_RecordBatch and have_schema)
+                  {
+                      Batch batch;
+                      batch.length = parse_record_batch(msg.table(2), schema, data + body_pos, body_length, column_buffers);
+                      for(std::size_t i=0; i<schema.size(); ++i)
+                      {
+                          batch.columns.push_back(ColumnBuffers{column_buffers[2*i], column_buffers[2*i+1]});
+                      }
+                      batches.push_back(std::move(batch));
+                  }
+                  else if(header_type==header_DictionaryBatch)
+                  {
+                      throw malformed_stream("dictionary batches are not supported");
+                  }
+                  else
+                  {
+                      throw malformed_stream("unexpected message type");
+                  }
+                  pos = body_pos + body_length;
+              }
+          }
+          catch(const malformed_stream& e)
+          {
+              std::ostringstream err;
+              err << "Failed to read Arrow stream file '" << path << "': the message at byte " << pos << " is malformed or unsupported (" << e.what() << ").";
+              printer_error().raise(LOCAL_INFO, err.str());
+          }
+      }
+
+    }
+  }
+}
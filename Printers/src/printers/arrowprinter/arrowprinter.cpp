@@ -0,0 +1,443 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Arrow printer class member function definitions
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+// Gambit
+#include "gambit/Printers/printers/arrowprinter.hpp"
+#include "gambit/Utils/util_functions.hpp"
+#include "gambit/Logs/logger.hpp"
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+    std::string ArrowFileName::str() const
+    {
+        std::ostringstream name;
+        name << stream << "_rank" << rank << "_g" << generation << "_" << index << ".arrows";
+        return name.str();
+    }
+
+    bool ArrowFileName::parse(const std::string& filename, ArrowFileName& out)
+    {
+        const std::string ext = ".arrows";
+        if(not Utils::endsWith(filename, ext)) return false;
+
+        // Split off the last three parts; the stream name itself may contain underscores
+        std::vector<std::string> parts = Utils::split(filename.substr(0, filename.size()-ext.size()), "_");
+        if(parts.size() < 4) return false;
+        const std::string& rank = parts[parts.size()-3];
+        const std::string& gen = parts[parts.size()-2];
+        const std::string& index = parts[parts.size()-1];
+        auto is_number = [](const std::string& s){ return not s.empty() and s.find_first_not_of("0123456789")==std::string::npos; };
+        if(rank.compare(0,4,"rank")!=0 or gen.compare(0,1,"g")!=0 or not is_number(rank.substr(4)) or not is_number(gen.substr(1)) or not is_number(index))
+        {
+            return false;
+        }
+
+        out.stream = parts[0];
+        for(std::size_t i=1; i+3<parts.size(); ++i) out.stream += "_" + parts[i];
+        out.rank = std::stoul(rank.substr(4));
+        out.generation = std::stoul(gen.substr(1));
+        out.index = std::stoul(index);
+        return true;
+    }
+
+    std::vector<ArrowFileName> list_arrow_files(const std::string& dir)
+    {
+        std::vector<ArrowFileName> files;
+        for(const std::string& name : Utils::ls_dir(dir))
+        {
+            ArrowFileName f;
+            if(ArrowFileName::parse(name, f)) files.push_back(f);
+        }
+        std::sort(files.begin(), files.end(), [](const ArrowFileName& a, const ArrowFileName& b)
+        {
+            if(a.stream!=b.stream) return a.stream < b.stream;
+            if(a.rank!=b.rank) return a.rank < b.rank;
+            return a.index < b.index;
+        });
+        return files;
+    }
+
+    // Constructor
+    ArrowPrinter::ArrowPrinter(const Options& options, BasePrinter* const primary)
+    : BasePrinter(primary,options.getValueOrDef<bool>(false,"auxilliary"))
+#ifdef WITH_MPI
+    , myComm() // initially attaches to MPI_COMM_WORLD
+#endif
+    , mpiRank(0)
+    , primary_printer(NULL)
+    , output_dir()
+    , stream_name("primary")
+    , generation(0)
+    , next_file_index(0)
+    , lastPointID(nullpoint)
+    , max_buffer_length(options.getValueOrDef<std::size_t>(1000,"buffer_length"))
+    , fields()
+    , columns()
+    , column_index()
+    , buffer_rows()
+    , writer()
+    , metadata()
+    , metadata_file()
+    {
+#ifdef WITH_MPI
+        mpiRank = myComm.Get_rank();
+#endif
+
+        if(is_auxilliary_printer())
+        {
+            // If this is an "auxilliary" printer then we need to get some
+            // of our options from the primary printer
+            primary_printer   = dynamic_cast<ArrowPrinter*>(this->get_primary_printer());
+            output_dir        = primary_printer->get_output_dir();
+            max_buffer_length = options.getValueOrDef<std::size_t>(primary_printer->get_max_buffer_length(),"buffer_length");
+            stream_name       = options.getValue<std::string>("name");
+            if(stream_name.find('/')!=std::string::npos)
+            {
+                printer_error().raise(LOCAL_INFO, "Arrow printer stream names may not contain '/' (stream name was '"+stream_name+"').");
+            }
+        }
+        else
+        {
+#ifdef WITH_MPI
+            this->setRank(mpiRank); // tells base class about rank
+#endif
+
+            // Tell scannerbit if we are resuming
+            set_resume(options.getValue<bool>("resume"));
+
+            // Get path of the directory where the output files should end up
+            std::ostringstream ff;
+            if(options.hasKey("output_path"))
+            {
+                ff << options.getValue<std::string>("output_path") << "/";
+            }
+            else
+            {
+                ff << options.getValue<std::string>("default_output_path") << "/";
+            }
+
+            if(options.hasKey("output_file"))
+            {
+                ff << options.getValue<std::string>("output_file");
+            }
+            else
+            {
+                printer_error().raise(LOCAL_INFO, "No 'output_file' entry specified in the options section of the Printer category of the input YAML file. Please add a name there for the directory in which the arrow printer should write the output files of the scan.");
+            }
+            output_dir = ff.str();
+
+            // Delete old output files if we are restarting the run? Mostly for convenience during testing.
+            // Recommend to use 'false' for serious runs to avoid accidentally deleting valuable output.
+            bool overwrite_files = options.getValueOrDef<bool>(false,"delete_file_on_restart");
+
+            if(getRank()==0)
+            {
+                Utils::ensure_path_exists(output_dir+"/");
+
+                // Note: "not resume" means "start or restart"
+                if(not get_resume())
+                {
+                    std::vector<std::string> old_files;
+                    for(const std::string& name : Utils::ls_dir(output_dir))
+                    {
+                        if(Utils::endsWith(name, ".arrows")) old_files.push_back(output_dir+"/"+name);
+                    }
+
+                    if(not old_files.empty() and not overwrite_files)
+                    {
+                        std::ostringstream errmsg;
+                        errmsg << "The output directory '"<<output_dir<<"' of the arrow printer already contains output files (e.g. "<<old_files[0]<<")! Please take one of the following actions:"<<std::endl;
+                        errmsg << "  1. Choose a new directory via the 'output_file' option in the Printer section of your input YAML file;"<<std::endl;
+                        errmsg << "  2. Delete the existing *.arrows files, or set 'delete_file_on_restart: true' in your input YAML file to give GAMBIT permission to automatically delete them (applies when -r/--restart flag used);"<<std::endl;
+                        errmsg << "  3. Resume the previous scan instead."<<std::endl;
+                        printer_error().raise(LOCAL_INFO, errmsg.str());
+                    }
+
+                    for(const std::string& file : old_files)
+                    {
+                        logger() << LogTags::printers << LogTags::info << "Deleting old output file " << file << EOM;
+                        if(std::remove(file.c_str())!=0)
+                        {
+                            printer_error().raise(LOCAL_INFO, "Error deleting existing output file '"+file+"' (requested by 'delete_file_on_restart' printer option)!");
+                        }
+                    }
+                }
+            }
+
+#ifdef WITH_MPI
+            // Make sure no processes look for old files until we are sure they won't be deleted
+            myComm.Barrier();
+#endif
+        }
+
+        // Continue the numbering of existing files of this stream (when resuming). All processes use
+        // the latest generation of the stream, since readers ignore the earlier ones.
+        for(const ArrowFileName& f : list_arrow_files(output_dir))
+        {
+            if(f.stream!=stream_name) continue;
+            generation = std::max(generation, f.generation);
+            if(f.rank==mpiRank) next_file_index = std::max(next_file_index, f.index+1);
+        }
+
+        // The MPIrank and pointID columns identify the rows
+        add_column("MPIrank", Arrow::type_of<int>());
+        add_column("pointID", Arrow::type_of<unsigned long long>());
+
+        // If we are resuming and this is the primary printer, need to find the previous
+        // highest pointID number used for this rank
+        if(not is_auxilliary_printer() and get_resume())
+        {
+            get_point_id() = find_highest_pointID();
+        }
+    }
+
+    ArrowPrinter::~ArrowPrinter()
+    {
+        // The writer closes its file, if that has not been done already
+    }
+
+    const std::string& ArrowPrinter::get_output_dir() {return output_dir;}
+    std::size_t ArrowPrinter::get_max_buffer_length() {return max_buffer_length;}
+
+    void ArrowPrinter::initialise(const std::vector<int>&)
+    {
+        // Don't need to initialise anything for this printer
+    }
+
+    void ArrowPrinter::reset(bool force)
+    {
+        // This is needed by e.g. MultiNest to delete old weights and replace them
+        // with new ones.
+        lastPointID = nullpoint;
+        if(not is_auxilliary_printer())
+        {
+            // Primary printers aren't allowed to delete stuff unless 'force' is set to true
+            if(force) printer_error().raise(LOCAL_INFO, "Forced reset of the primary output stream is not supported by the arrow printer.");
+            return;
+        }
+
+        // Everything printed so far is discarded: the buffer is cleared and this process deletes its
+        // files of the stream. The next output starts a new generation, so readers also ignore the
+        // files of the stream that other processes wrote before their own reset.
+        close_file();
+        buffer_rows.clear();
+        fields.resize(2);
+        columns.clear();
+        columns.resize(2);
+        column_index.clear();
+        column_index["MPIrank"] = 0;
+        column_index["pointID"] = 1;
+
+        for(const ArrowFileName& f : list_arrow_files(output_dir))
+        {
+            if(f.stream==stream_name and f.rank==mpiRank)
+            {
+                const std::string file = output_dir+"/"+f.str();
+                if(std::remove(file.c_str())!=0)
+                {
+                    printer_error().raise(LOCAL_INFO, "Error deleting output file '"+file+"' while resetting arrow printer stream '"+stream_name+"'!");
+                }
+            }
+        }
+        ++generation;
+    }
+
+    // Print metadata info to file
+    void ArrowPrinter::_print_metadata(map_str_str datasets)
+    {
+        // Only print from rank 0
+        if(mpiRank!=0 or is_auxilliary_printer()) return;
+
+        for(const auto& kv : datasets) metadata[kv.first] = kv.second;
+        write_metadata();
+    }
+
+    // The metadata goes into the schema of a stream file without any columns. A new file is used for
+    // each run, so that resumed runs keep the metadata of the earlier ones.
+    void ArrowPrinter::write_metadata()
+    {
+        if(metadata_file.empty())
+        {
+            std::size_t n = 0;
+            while(Utils::file_exists(output_dir+"/metadata_"+std::to_string(n)+".arrows")) ++n;
+            metadata_file = output_dir+"/metadata_"+std::to_string(n)+".arrows";
+        }
+        Arrow::StreamWriter(metadata_file, std::vector<Arrow::Field>(), metadata).close();
+    }
+
+    void ArrowPrinter::finalise(bool /*abnormal*/)
+    {
+        // Dump buffer to disk. Nothing special needed for early shutdown.
+        dump_buffer();
+        close_file();
+
+        // Add last point ID to metadata
+        if(not is_auxilliary_printer() and mpiRank==0 and get_output_metadata() and not metadata_file.empty())
+        {
+            std::stringstream ssPPID;
+            ssPPID << lastPointID;
+            metadata["lastPointID"] = ssPPID.str();
+            write_metadata();
+        }
+    }
+
+    void ArrowPrinter::flush()
+    {
+        dump_buffer();
+    }
+
+    // Reader construction options for constructing a reader
+    // object that can read the output we are printing
+    Options ArrowPrinter::resume_reader_options()
+    {
+        Options options;
+        // Set options that we need later to construct a reader object for
+        // previous output, if required.
+        options.setValue("type", "arrow");
+        options.setValue("file", output_dir);
+        return options;
+    }
+
+    std::size_t ArrowPrinter::add_column(const std::string& label, const Arrow::Type type)
+    {
+        const std::size_t i = fields.size();
+        fields.push_back(Arrow::Field{label, type});
+        columns.emplace_back();
+        columns[i].values.resize(buffer_rows.size()*Arrow::type_size(type), 0);
+        columns[i].valid.resize(buffer_rows.size(), 0);
+        column_index[label] = i;
+        return i;
+    }
+
+    unsigned char* ArrowPrinter::insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& label, const Arrow::Type type)
+    {
+        const PPIDpair ppid(pointID,mpirank);
+        lastPointID = ppid;
+
+        // Check if a row for this point exists in the buffer
+        auto row_it = buffer_rows.find(ppid);
+        if(row_it==buffer_rows.end())
+        {
+            // The primary stream prints points one after another, so a point is complete
+            // once the next one begins. Write the buffer first if it is full.
+            if(buffer_rows.size()>=max_buffer_length) dump_buffer();
+
+            const std::size_t row = buffer_rows.size();
+            row_it = buffer_rows.emplace(ppid, row).first;
+            for(std::size_t i=0; i<columns.size(); ++i)
+            {
+                columns[i].values.resize((row+1)*Arrow::type_size(fields[i].type), 0);
+                columns[i].valid.push_back(0);
+            }
+            const int r = mpirank;
+            const unsigned long long p = pointID;
+            std::memcpy(&columns[0].values[row*sizeof(int)], &r, sizeof(int));
+            std::memcpy(&columns[1].values[row*sizeof(p)], &p, sizeof(p));
+            columns[0].valid[row] = 1;
+            columns[1].valid[row] = 1;
+        }
+
+        // The row keys are already set
+        if(label=="MPIrank" or label=="pointID") return NULL;
+
+        auto col_it = column_index.find(label);
+        std::size_t col;
+        if(col_it==column_index.end())
+        {
+            col = add_column(label, type);
+        }
+        else
+        {
+            col = col_it->second;
+            if(fields[col].type!=type)
+            {
+                std::stringstream err;
+                err<<"Attempted to print data for column '"<<label<<"' with the arrow printer as type "<<Arrow::type_name(type)<<", but this column was already printed with type "<<Arrow::type_name(fields[col].type)<<".";
+                printer_error().raise(LOCAL_INFO,err.str());
+            }
+        }
+
+        const std::size_t row = row_it->second;
+        columns[col].valid[row] = 1;
+        return &columns[col].values[row*Arrow::type_size(type)];
+    }
+
+    void ArrowPrinter::dump_buffer()
+    {
+        if(buffer_rows.empty()) return;
+
+        // Columns are only ever added to the buffer, so its schema only changes when it has more fields
+        if(writer==nullptr or writer->get_schema().size()!=fields.size())
+        {
+            close_file();
+            ArrowFileName name{stream_name, mpiRank, generation, next_file_index++};
+            writer.reset(new Arrow::StreamWriter(output_dir+"/"+name.str(), fields));
+        }
+
+        Arrow::RecordBatch batch;
+        batch.length = buffer_rows.size();
+        batch.columns.resize(columns.size());
+        for(std::size_t i=0; i<columns.size(); ++i)
+        {
+            batch.columns[i].values.swap(columns[i].values);
+            batch.columns[i].valid.swap(columns[i].valid);
+        }
+        buffer_rows.clear();
+        writer->write(batch);
+    }
+
+    void ArrowPrinter::close_file()
+    {
+        if(writer!=nullptr)
+        {
+            writer->close();
+            writer.reset();
+        }
+    }
+
+    unsigned long long ArrowPrinter::find_highest_pointID()
+    {
+        unsigned long long highest = 0;
+        for(const ArrowFileName& f : list_arrow_files(output_dir))
+        {
+            if(f.stream!=stream_name or f.rank!=mpiRank) continue;
+
+            const Arrow::StreamReader file(output_dir+"/"+f.str());
+            const std::vector<Arrow::Field>& schema = file.get_schema();
+            if(schema.size()<2 or schema[1].name!="pointID" or schema[1].type!=Arrow::Type::UInt64)
+            {
+                printer_error().raise(LOCAL_INFO, "Arrow printer output file '"+output_dir+"/"+f.str()+"' does not have the expected pointID column!");
+            }
+            for(std::size_t b=0; b<file.num_batches(); ++b)
+            {
+                // pointID is always the second column
+                for(std::size_t row=0; row<file.batch_length(b); ++row)
+                {
+                    highest = std::max(highest, file.value<unsigned long long>(b, 1, row));
+                }
+            }
+        }
+        return highest;
+    }
+
+  }
+}
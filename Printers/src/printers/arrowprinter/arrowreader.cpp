@@ -0,0 +1,227 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Arrow printer retriever class definitions
+///  This is a class accompanying the ArrowPrinter
+///  which takes care of *reading* from output
+///  created by the ArrowPrinter.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <algorithm>
+
+#include "gambit/Printers/printers/arrowreader.hpp"
+#include "gambit/Printers/printers/arrowprinter.hpp"
+#include "gambit/Utils/util_functions.hpp"
+#include "gambit/Logs/logger.hpp"
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+     ArrowReader::ArrowReader(const Options& options)
+     : BaseReader()
+     , output_dir(options.getValue<std::string>("file"))
+     , files()
+     , points()
+     , point_index()
+     , point_rows()
+     , fields()
+     , columns()
+     , current_dataset_index(0)
+     {
+        if(not Utils::file_exists(output_dir))
+        {
+            printer_error().raise(LOCAL_INFO, "The arrow printer output directory '"+output_dir+"' does not exist!");
+        }
+
+        // Only the latest generation of each stream is valid; earlier ones were reset
+        const std::vector<ArrowFileName> file_names = list_arrow_files(output_dir);
+        std::map<std::string,std::size_t> latest;
+        for(const ArrowFileName& f : file_names)
+        {
+            latest[f.stream] = std::max(latest[f.stream], f.generation);
+        }
+
+        // Read the primary stream first, so that the points are in the order of the primary output.
+        // Values printed later for the same point (e.g. by auxiliary streams) are merged into it.
+        for(const bool primary : {true, false})
+        {
+            for(const ArrowFileName& f : file_names)
+            {
+                if((f.stream=="primary")==primary and f.generation==latest.at(f.stream))
+                {
+                    load_file(output_dir+"/"+f.str());
+                }
+            }
+        }
+
+        // Labels are absent from the files read after the last one that had them
+        for(auto& col : columns)
+        {
+            col.second.resize(files.size(), -1);
+        }
+
+        // Set up the reader loop
+        reset();
+     }
+
+     ArrowReader::~ArrowReader()
+     {}
+
+     void ArrowReader::load_file(const std::string& path)
+     {
+         files.emplace_back(new Arrow::StreamReader(path));
+         const Arrow::StreamReader& file = *files.back();
+         const uint f = files.size()-1;
+         if(not file.is_complete())
+         {
+             logger() << LogTags::printers << LogTags::warn << "Arrow printer output file " << path << " is incomplete (e.g. because the run that wrote it was killed). Reading the " << file.num_batches() << " complete batches in it." << EOM;
+         }
+
+         const std::vector<Arrow::Field>& schema = file.get_schema();
+         if(schema.size()<2 or schema[0].name!="MPIrank" or schema[0].type!=Arrow::Type::Int32 or schema[1].name!="pointID" or schema[1].type!=Arrow::Type::UInt64)
+         {
+             std::stringstream err;
+             err<<"Arrow printer output file '"<<path<<"' does not start with the MPIrank and pointID columns! It was probably not written by the arrow printer.";
+             printer_error().raise(LOCAL_INFO, err.str());
+         }
+
+         // The column of each field in this file
+         for(std::size_t c=0; c<schema.size(); ++c)
+         {
+             const Arrow::Field& field = schema[c];
+             auto it = fields.find(field.name);
+             if(it==fields.end())
+             {
+                 fields[field.name] = field;
+             }
+             else if(it->second.type!=field.type)
+             {
+                 std::stringstream err;
+                 err<<"Column '"<<field.name<<"' has type "<<Arrow::type_name(field.type)<<" in arrow printer output file '"<<path<<"', but type "<<Arrow::type_name(it->second.type)<<" in other files of the same output!";
+                 printer_error().raise(LOCAL_INFO, err.str());
+             }
+             std::vector<long>& column_in_file = columns[field.name];
+             column_in_file.resize(files.size(), -1);
+             column_in_file[f] = c;
+         }
+
+         // Index the rows of the points
+         for(uint b=0; b<file.num_batches(); ++b)
+         {
+             for(uint row=0; row<file.batch_length(b); ++row)
+             {
+                 const PPIDpair ppid(file.value<unsigned long long>(b, 1, row), file.value<int>(b, 0, row));
+                 auto pt_it = point_index.find(ppid);
+                 if(pt_it==point_index.end())
+                 {
+                     pt_it = point_index.emplace(ppid, points.size()).first;
+                     points.push_back(ppid);
+                     point_rows.emplace_back();
+                 }
+                 point_rows[pt_it->second].push_back(Location{f, b, row});
+             }
+         }
+     }
+
+     /// @{ Base class virtual interface functions
+
+     /// Reset 'read head' position to first entry
+     void ArrowReader::reset()
+     {
+         current_dataset_index = 0;
+     }
+
+     /// Get length of input dataset
+     ulong ArrowReader::get_dataset_length()
+     {
+         return points.size();
+     }
+
+     /// Get next rank/ptID pair in data file
+     PPIDpair ArrowReader::get_next_point()
+     {
+        if(eoi())
+        {
+            std::stringstream err;
+            err<<"Attempted to move ArrowReader to the next point, but eoi() has been reached! This should have been checked by whatever code called this function!";
+            printer_error().raise(LOCAL_INFO, err.str());
+        }
+        ++current_dataset_index;
+        return get_current_point();
+     }
+
+     /// Get current rank/ptID pair in data file
+     PPIDpair ArrowReader::get_current_point()
+     {
+        if(eoi())
+        {
+          // End of data, return nullpoint;
+          return nullpoint;
+        }
+        return points[current_dataset_index];
+     }
+
+     // Get a linear index which corresponds to the current rank/ptID pair in the iterative sense
+     ulong ArrowReader::get_current_index()
+     {
+       return current_dataset_index;
+     }
+
+     /// Check if 'current point' is past the end of the datasets (and thus invalid!)
+     bool ArrowReader::eoi()
+     {
+        return current_dataset_index >= points.size();
+     }
+
+     /// Get type information for a data entry, i.e. defines the C++ type which this should be
+     /// retrieved as, not what it is necessarily literally stored as in the output.
+     std::size_t ArrowReader::get_type(const std::string& label)
+     {
+         // As for the other readers, composite types (e.g. ModelParameters) were split into
+         // their basic elements when printed, so only the basic types can be identified here.
+         auto it = fields.find(label);
+         if(it==fields.end())
+         {
+             std::stringstream err;
+             err<<"Label '"<<label<<"' does not exist in the arrow printer output in '"<<output_dir<<"'!";
+             printer_error().raise(LOCAL_INFO,err.str());
+         }
+
+         switch(it->second.type)
+         {
+             case Arrow::Type::Bool:    return getTypeID<bool>();
+             case Arrow::Type::Int32:   return getTypeID<int>();
+             case Arrow::Type::UInt32:  return getTypeID<uint>();
+             case Arrow::Type::Int64:   return getTypeID<longlong>();
+             case Arrow::Type::UInt64:  return getTypeID<ulonglong>();
+             case Arrow::Type::Float32: return getTypeID<float>();
+             default:                   return getTypeID<double>();
+         }
+     }
+
+     /// Get labels of all datasets
+     std::set<std::string> ArrowReader::get_all_labels()
+     {
+         std::set<std::string> out;
+         for (auto it = fields.begin(); it != fields.end(); ++it)
+         {
+             out.insert(it->first);
+         }
+         return out;
+     }
+
+     /// @}
+
+  }
+}
@@ -0,0 +1,62 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Arrow printer class print function overloads.
+///  Add a new overload of the _print function in
+///  this file if you want to be able to print a
+///  new type.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+
+#include "gambit/Printers/printers/arrowprinter.hpp"
+#include "gambit/Printers/printers/common_print_overloads.hpp"
+
+namespace Gambit
+{
+  namespace Printers
+  {
+
+    /// @{ PRINT FUNCTIONS
+    /// Need to define one of these for every type we want to print!
+
+    /// Templatable print functions
+    #define PRINT(TYPE) _print(TYPE const& value, const std::string& label, const int /*vID*/, const uint rank, const ulong pID) \
+       { template_print(value,label,rank,pID); }
+    void ArrowPrinter::PRINT(bool     )
+    void ArrowPrinter::PRINT(int      )
+    void ArrowPrinter::PRINT(uint     )
+    void ArrowPrinter::PRINT(long     )
+    void ArrowPrinter::PRINT(ulong    )
+    void ArrowPrinter::PRINT(longlong )
+    void ArrowPrinter::PRINT(ulonglong)
+    void ArrowPrinter::PRINT(float    )
+    void ArrowPrinter::PRINT(double   )
+    #undef PRINT
+
+    // Piggyback off existing print functions to build standard overloads
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, std::vector<double>)
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, map_str_dbl)
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, map_str_str)
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, map_intpair_dbl)
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, ModelParameters)
+    USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, triplet<double>)
+    #ifndef SCANNER_STANDALONE
+    #ifndef GAMBIT_LIGHT
+      USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, DM_nucleon_couplings)
+      USE_COMMON_PRINT_OVERLOAD(ArrowPrinter, BBN_container)
+    #endif
+    #endif
+
+    /// @}
+
+  }
+}
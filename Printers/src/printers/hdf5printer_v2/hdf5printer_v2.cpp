@@ -37,12 +37,193 @@ namespace Gambit
 {
   namespace Printers
   {
+    /// Mutex held by whichever thread has an output HDF5 file open. The HDF5 library
+    /// may not be thread safe, so this serialises the file access of the background
+    /// writers with that of all the master buffers in this process.
+    std::recursive_mutex& hdf5_file_mutex()
+    {
+        static std::recursive_mutex mtx;
+        return mtx;
+    }
+
+    /// Number of master buffers in this process holding their output file open between accesses
+    std::size_t& held_hdf5_files()
+    {
+        static std::size_t n(0);
+        return n;
+    }
+
+    /// @{ Dataset storage settings
+
+    /// Default settings: chunks of HDF5_CHUNKLENGTH records, no filters
+    HDF5DataSetSettings::HDF5DataSetSettings()
+      : chunk_length(HDF5_CHUNKLENGTH)
+      , deflate_level(0)
+      , shuffle(true)
+      , chunk_cache_bytes(0)
+      , packed_flags(false)
+    {}
+
+    hid_t packed_flag_type()
+    {
+        static const hid_t type = []()
+        {
+            hid_t t = H5Tcopy(H5T_NATIVE_UCHAR);
+            if(t<0 or H5Tset_precision(t,1)<0)
+            {
+                printer_error().raise(LOCAL_INFO, "Failed to create the HDF5 datatype for bit-packed validity flags!");
+            }
+            return t;
+        }();
+        return type;
+    }
+
+    HDF5DataSetOptions::HDF5DataSetOptions()
+      : defaults()
+      , patterns()
+      , pack_flags(false)
+    {}
+
+    HDF5DataSetOptions::HDF5DataSetOptions(const Options& options)
+      : defaults(read_settings(options,HDF5DataSetSettings()))
+      , patterns()
+      , pack_flags(false)
+    {
+        std::string flag_format = options.getValueOrDef<std::string>("int","validity_format");
+        if(flag_format=="bits")
+        {
+            pack_flags = true;
+        }
+        else if(flag_format!="int")
+        {
+            std::ostringstream errmsg;
+            errmsg<<"Unknown 'validity_format' option '"<<flag_format<<"' for the HDF5 printer! Valid options are 'int' and 'bits'.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+        if(pack_flags and H5Zfilter_avail(H5Z_FILTER_NBIT)<=0)
+        {
+            std::ostringstream errmsg;
+            errmsg<<"The 'validity_format: bits' option of the HDF5 printer needs the N-bit filter, which the HDF5 library that GAMBIT is linked against does not provide. Please set 'validity_format: int'.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+
+        if(options.hasKey("dataset_options"))
+        {
+            for(const std::string& pattern : options.getNames("dataset_options"))
+            {
+                std::regex expr;
+                try
+                {
+                    expr = std::regex(pattern);
+                }
+                catch(const std::regex_error& e)
+                {
+                    std::ostringstream errmsg;
+                    errmsg<<"Invalid regular expression '"<<pattern<<"' in the 'dataset_options' of the HDF5 printer: "<<e.what();
+                    printer_error().raise(LOCAL_INFO, errmsg.str());
+                }
+                patterns.emplace_back(expr,read_settings(options.getOptions("dataset_options",pattern),defaults));
+            }
+        }
+
+        if(any_compressed())
+        {
+            // Deflate is an optional part of the HDF5 library
+            unsigned int filter_info(0);
+            if(H5Zfilter_avail(H5Z_FILTER_DEFLATE)<=0
+               or H5Zget_filter_info(H5Z_FILTER_DEFLATE,&filter_info)<0
+               or not (filter_info & H5Z_FILTER_CONFIG_ENCODE_ENABLED))
+            {
+                std::ostringstream errmsg;
+                errmsg<<"Compression of the output datasets was requested from the HDF5 printer, but the HDF5 library that GAMBIT is linked against cannot write with the deflate filter. Please set 'compression: none'.";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+        }
+    }
+
+    HDF5DataSetSettings HDF5DataSetOptions::read_settings(const Options& options, const HDF5DataSetSettings& base)
+    {
+        HDF5DataSetSettings out(base);
+        out.chunk_length = options.getValueOrDef<std::size_t>(base.chunk_length,"chunk_length");
+        if(out.chunk_length<1)
+        {
+            std::ostringstream errmsg;
+            errmsg<<"The 'chunk_length' option of the HDF5 printer must be at least 1.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+
+        std::string compression = options.getValueOrDef<std::string>(base.deflate_level>0 ? "deflate" : "none","compression");
+        if(compression=="none")
+        {
+            out.deflate_level = 0;
+        }
+        else if(compression=="deflate" or compression=="gzip")
+        {
+            out.deflate_level = options.getValueOrDef<int>(base.deflate_level>0 ? base.deflate_level : 4,"compression_level");
+            if(out.deflate_level<1 or out.deflate_level>9)
+            {
+                std::ostringstream errmsg;
+                errmsg<<"The 'compression_level' option of the HDF5 printer must be between 1 and 9 (got "<<out.deflate_level<<").";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+        }
+        else
+        {
+            std::ostringstream errmsg;
+            errmsg<<"Unknown 'compression' option '"<<compression<<"' for the HDF5 printer! Valid options are 'none' and 'deflate'.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+
+        out.shuffle = options.getValueOrDef<bool>(base.shuffle,"shuffle");
+
+        double cache_mb = options.getValueOrDef<double>(pow(2,-20)*base.chunk_cache_bytes,"chunk_cache_mb");
+        if(cache_mb<0)
+        {
+            std::ostringstream errmsg;
+            errmsg<<"The 'chunk_cache_mb' option of the HDF5 printer cannot be negative.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+        out.chunk_cache_bytes = std::size_t(cache_mb*pow(2,20));
+        return out;
+    }
+
+    const HDF5DataSetSettings& HDF5DataSetOptions::get(const std::string& dset_name) const
+    {
+        for(auto it=patterns.begin(); it!=patterns.end(); ++it)
+        {
+            if(std::regex_match(dset_name,it->first)) return it->second;
+        }
+        return defaults;
+    }
+
+    HDF5DataSetSettings HDF5DataSetOptions::get_flags(const std::string& dset_name) const
+    {
+        HDF5DataSetSettings out(get(dset_name));
+        out.packed_flags = pack_flags;
+        return out;
+    }
+
+    bool HDF5DataSetOptions::packs_flags() const { return pack_flags; }
+
+    bool HDF5DataSetOptions::any_compressed() const
+    {
+        if(defaults.deflate_level>0) return true;
+        for(auto it=patterns.begin(); it!=patterns.end(); ++it)
+        {
+            if(it->second.deflate_level>0) return true;
+        }
+        return false;
+    }
+
+    /// @}
+
     /// @{ HDF5DataSetBase member functions
 
     /// Constructor
     HDF5DataSetBase::HDF5DataSetBase(const std::string& name, const hid_t tid)
       : _myname(name)
       , is_open(false)
+      , stay_open(false)
       , exists_on_disk(false)
       , dset_id(-1)
       , hdftype_id(tid)
@@ -53,6 +234,7 @@ namespace Gambit
     HDF5DataSetBase::HDF5DataSetBase(const std::string& name)
       : _myname(name)
       , is_open(false)
+      , stay_open(false)
       , exists_on_disk(false)
       , dset_id(-1)
       , hdftype_id(-1)
@@ -78,6 +260,10 @@ namespace Gambit
     /// Retrieve name of the dataset we are supposed to access
     std::string HDF5DataSetBase::myname() const { return _myname; }
 
+    /// Access the storage settings of the dataset
+    void HDF5DataSetBase::set_settings(const HDF5DataSetSettings& new_settings) { settings = new_settings; }
+    const HDF5DataSetSettings& HDF5DataSetBase::get_settings() const { return settings; }
+
     /// Access variables that track whether the dataset exists on disk yet
     bool HDF5DataSetBase::get_exists_on_disk() const { return exists_on_disk; }
     void HDF5DataSetBase::set_exists_on_disk() { exists_on_disk = true; }
@@ -95,6 +281,19 @@ namespace Gambit
     /// Retrieve the HDF5 type ID for this dataset
     hid_t HDF5DataSetBase::get_hdftype_id() const { return hdftype_id; }
 
+    /// Retrieve the HDF5 type ID with which the dataset is stored
+    hid_t HDF5DataSetBase::get_file_type_id() const
+    {
+        return settings.packed_flags ? packed_flag_type() : hdftype_id;
+    }
+
+    /// Flags datasets may be stored either way, e.g. when resuming from a file written
+    /// with the other 'validity_format'
+    bool HDF5DataSetBase::stored_type_ok(const hid_t dtype) const
+    {
+        return H5Tequal(dtype, hdftype_id)>0 or H5Tequal(dtype, packed_flag_type())>0;
+    }
+
     /// Check if our dataset exists on disk with the required name at the given location
     bool HDF5DataSetBase::dataset_exists(const hid_t loc_id)
     {
@@ -193,6 +392,8 @@ namespace Gambit
     /// Open an existing dataset
     void HDF5DataSetBase::open_dataset(hid_t location_id)
     {
+        if(is_open and stay_open) return; // Still open from the last access
+
         if(is_open)
         {
             std::ostringstream errmsg;
@@ -200,8 +401,23 @@ namespace Gambit
             printer_error().raise(LOCAL_INFO, errmsg.str());
         }
 
+        // Size the chunk cache, if requested. The columns are written in order, so fully
+        // written chunks are the first to be evicted (w0=1).
+        hid_t dapl_id = H5P_DEFAULT;
+        if(get_settings().chunk_cache_bytes>0)
+        {
+            dapl_id = H5Pcreate(H5P_DATASET_ACCESS);
+            if(dapl_id<0 or H5Pset_chunk_cache(dapl_id, H5D_CHUNK_CACHE_NSLOTS_DEFAULT, get_settings().chunk_cache_bytes, 1.0)<0)
+            {
+                std::ostringstream errmsg;
+                errmsg << "Error opening existing dataset (with name=\""<<myname()<<"\") in HDF5 file. Failed to set the chunk cache size.";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+        }
+
         // Open the dataset
-        dset_id = H5Dopen2(location_id, myname().c_str(), H5P_DEFAULT);
+        dset_id = H5Dopen2(location_id, myname().c_str(), dapl_id);
+        if(dapl_id!=H5P_DEFAULT) H5Pclose(dapl_id);
         if(dset_id<0)
         {
             std::ostringstream errmsg;
@@ -249,7 +465,7 @@ namespace Gambit
         // Compute initial dataspace and chunk dimensions
         dims[0] = dims_out[0]; // Set to match existing data
         maxdims[0] = H5S_UNLIMITED; // No upper limit on number of records allowed in dataset
-        chunkdims[0] = HDF5_CHUNKLENGTH;
+        chunkdims[0] = get_settings().chunk_length;
         //slicedims[0] = 1; // Dimensions of a single record in the data space
 
         // Release dataspace handle
@@ -262,6 +478,8 @@ namespace Gambit
     /// Close a dataset
     void HDF5DataSetBase::close_dataset()
     {
+        if(stay_open) return; // Closed later, by keep_open(false)
+
         if(is_open)
         {
             if(dset_id>=0)
@@ -290,6 +508,13 @@ namespace Gambit
         is_open = false;
     }
 
+    /// Keep the dataset open between accesses (or close it)
+    void HDF5DataSetBase::keep_open(const bool keep)
+    {
+        stay_open = keep;
+        if(not stay_open and is_open) close_dataset();
+    }
+
     /// Obtain memory and dataspace identifiers for writing to a hyperslab in the dataset
     std::pair<hid_t,hid_t> HDF5DataSetBase::select_hyperslab(std::size_t offset, std::size_t length) const
     {
@@ -359,6 +584,68 @@ namespace Gambit
 
     /// @}
 
+    /// @{ HDF5PointIndex member functions
+
+    const std::size_t HDF5PointIndex::npos = std::size_t(-1);
+
+    /// Get the slot of a point, adding the point in a new slot if it is not already known
+    std::size_t HDF5PointIndex::insert(const PPIDpair& ppid)
+    {
+        auto result = slots.emplace(ppid,_points.size());
+        if(result.second) _points.push_back(ppid);
+        return result.first->second;
+    }
+
+    /// Get the slot of a point (npos if the point is not in the index)
+    std::size_t HDF5PointIndex::find(const PPIDpair& ppid) const
+    {
+        auto it = slots.find(ppid);
+        return it==slots.end() ? npos : it->second;
+    }
+
+    /// Report the number of points in the index
+    std::size_t HDF5PointIndex::size() const
+    {
+        return _points.size();
+    }
+
+    /// Retrieve all points in the index, in slot order
+    const std::vector<PPIDpair>& HDF5PointIndex::points() const
+    {
+        return _points;
+    }
+
+    /// Remove a set of points from the index
+    std::vector<std::size_t> HDF5PointIndex::erase(const std::set<PPIDpair>& removed_points)
+    {
+        std::vector<std::size_t> kept_slots;
+        std::vector<PPIDpair> remaining_points;
+        for(std::size_t i=0; i<_points.size(); ++i)
+        {
+            if(removed_points.count(_points[i])==0)
+            {
+                kept_slots.push_back(i);
+                remaining_points.push_back(_points[i]);
+            }
+        }
+        _points.swap(remaining_points);
+        slots.clear();
+        for(std::size_t i=0; i<_points.size(); ++i)
+        {
+            slots[_points[i]] = i;
+        }
+        return kept_slots;
+    }
+
+    /// Remove all points from the index
+    void HDF5PointIndex::clear()
+    {
+        _points.clear();
+        slots.clear();
+    }
+
+    /// @}
+
     /// @{ HDF5BufferBase member functions
 
     /// Constructor
@@ -379,12 +666,6 @@ namespace Gambit
         return synchronised;
     }
 
-    /// Report all the points in this buffer
-    std::set<PPIDpair> HDF5BufferBase::get_points_set() const
-    {
-        return buffer_set;
-    }
-
     /// @}
 
 
@@ -397,6 +678,14 @@ namespace Gambit
         )
         : synchronised(sync)
         , buffer_length(sync ? buflen : MAX_BUFFER_SIZE) // Use buflen for the bufferlength if this is a sync buffer, otherwise use MAX_BUFFER_SIZE
+        , hold_file(false)
+        , file_elsewhere(false)
+        , aggregating(false)
+        , file_collective(false)
+#ifdef WITH_MPI
+        , aggregator_ends(0)
+        , max_aggregator_sends(0)
+#endif
         , file(filename)
         , group(groupname)
         , metadata_group(metadata_groupname)
@@ -408,24 +697,24 @@ namespace Gambit
         , file_open(false)
         , have_lock(false)
 #ifdef WITH_MPI
-        , hdf5_buffers_int(sync,comm)
-        , hdf5_buffers_uint(sync,comm)
-        , hdf5_buffers_long(sync,comm)
-        , hdf5_buffers_ulong(sync,comm)
+        , hdf5_buffers_int(sync,buffered_points,comm)
+        , hdf5_buffers_uint(sync,buffered_points,comm)
+        , hdf5_buffers_long(sync,buffered_points,comm)
+        , hdf5_buffers_ulong(sync,buffered_points,comm)
         //, hdf5_buffers_longlong(sync,comm)
         //, hdf5_buffers_ulonglong(sync,comm)
-        , hdf5_buffers_float(sync,comm)
-        , hdf5_buffers_double(sync,comm)
+        , hdf5_buffers_float(sync,buffered_points,comm)
+        , hdf5_buffers_double(sync,buffered_points,comm)
         , myComm(comm)
 #else
-        , hdf5_buffers_int(sync)
-        , hdf5_buffers_uint(sync)
-        , hdf5_buffers_long(sync)
-        , hdf5_buffers_ulong(sync)
+        , hdf5_buffers_int(sync,buffered_points)
+        , hdf5_buffers_uint(sync,buffered_points)
+        , hdf5_buffers_long(sync,buffered_points)
+        , hdf5_buffers_ulong(sync,buffered_points)
         //, hdf5_buffers_longlong(sync)
         //, hdf5_buffers_ulonglong(sync)
-        , hdf5_buffers_float(sync)
-        , hdf5_buffers_double(sync)
+        , hdf5_buffers_float(sync,buffered_points)
+        , hdf5_buffers_double(sync,buffered_points)
 #endif
     {
         //std::cout<<"Constructed MasterBuffer to attach to file/group:"<<std::endl;
@@ -435,7 +724,10 @@ namespace Gambit
 
     HDF5MasterBuffer::~HDF5MasterBuffer()
     {
-        if(file_open) close_and_unlock_file();
+        // Finish background writes first, since they use the file handles
+        writer.reset();
+        if(hold_file) hold_file_open(false);
+        else if(file_open) close_and_unlock_file();
     }
 
     bool HDF5MasterBuffer::is_synchronised()
@@ -476,10 +768,31 @@ namespace Gambit
     /// (or as much of them as is currently possible in RA case)
     void HDF5MasterBuffer::flush()
     {
-        if(get_Npoints()>0) // No point trying to flush an already empty buffer
+        #ifdef WITH_MPI
+        // Write the flushes of the other processes before our own (on rank 0)
+        poll_aggregator();
+        #endif
+
+        const bool send(aggregating and file_elsewhere);
+        if(get_Npoints()>0 and (writer or send)) // Leave the write to the background writer, or to rank 0
+        {
+            HDF5BlockSet blocks;
+            for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+            {
+                blocks.push_back(it->second->detach_block());
+            }
+            buffered_points.clear();
+            #ifdef WITH_MPI
+            if(send) send_to_aggregator(blocks);
+            else
+            #endif
+            writer->push(std::move(blocks));
+        }
+        else if(get_Npoints()>0 and not file_elsewhere) // No point trying to flush an already empty buffer
         {
             // Obtain lock on the output file
             lock_and_open_file();
+            OpenFileGuard open_file(*this);
 
             // Determine next available output slot (i.e. current nominal dataset length)
             std::size_t target_pos = get_next_free_position();
@@ -493,7 +806,7 @@ namespace Gambit
                 logger()<<LogTags::printers<<LogTags::debug;
                 logger()<<"Preparing to flush "<<buffered_points.size()<<" points to target position "<<target_pos<<std::endl;
                 std::size_t i=0;
-                for(auto it=buffered_points.begin(); it!=buffered_points.end(); ++it, ++i)
+                for(auto it=buffered_points.points().begin(); it!=buffered_points.points().end(); ++it, ++i)
                 {
                     logger()<<"   buffered_point "<<i<<": "<<(*it)<<std::endl;
                 }
@@ -504,13 +817,12 @@ namespace Gambit
                     // Extend the output datasets to the next free position (in case some have been left behind)
                     it->second->ensure_dataset_exists(location_id, target_pos);
 
-                    // For synchronised writes we have to tell the buffers what order to write their output,
-                    // and where. 'target_pos' should usually be the end of their dataset, unless data for
+                    // For synchronised writes the buffers write their columns in slot order, to
+                    // 'target_pos'. This should usually be the end of their dataset, unless data for
                     // a certain dataset was not written for some buffer dump.
-                    it->second->block_flush(location_id,buffered_points,target_pos);
+                    it->second->block_flush(location_id,target_pos);
                 }
                 buffered_points.clear();
-                buffered_points_set.clear();
             }
             else
             {
@@ -527,17 +839,17 @@ namespace Gambit
                 // the points to be written
                 // We will do this in (large) chunks.
                 bool done = false;
-                auto it = buffered_points.begin();
+                auto it = buffered_points.points().begin();
                 std::set<PPIDpair> done_points;
                 while(not done)
                 {
                     std::vector<PPIDpair> sub_buffer;
                     sub_buffer.clear();
-                    for(std::size_t j=0; (j<1000000) && (it!=buffered_points.end()); ++j, ++it)
+                    for(std::size_t j=0; (j<1000000) && (it!=buffered_points.points().end()); ++j, ++it)
                     {
                         sub_buffer.push_back(*it);
                     }
-                    if(it==buffered_points.end()) done=true;
+                    if(it==buffered_points.points().end()) done=true;
                     //std::cout<<"Getting dataset positions for "<<sub_buffer.size()<<" points"<<std::endl;
                     //std::cout<<"("<<buffered_points.size()-sub_buffer.size()<<" points remaining)"<<std::endl;
 
@@ -567,40 +879,100 @@ namespace Gambit
                 }
 
 
-                // Remove flushed points from the buffered points record
-                std::vector<PPIDpair> remaining_buffered_points;
-                for(auto it=buffered_points.begin(); it!=buffered_points.end(); ++it)
-                {
-                    if(done_points.count(*it)==0)
-                    {
-                        // This point couldn't be flushed (wasn't found on disk (yet))
-                        //DEBUG
-                        //std::cout<<"Could not flush point "<<(*it)<<", leaving it in the buffer."<<std::endl;
-                        remaining_buffered_points.push_back(*it);
-                    }
-                }
-                buffered_points = remaining_buffered_points;
-                buffered_points_set = set_diff(buffered_points_set, done_points);
-                /// While we are here, check that buffered_points and buffered_points_set are the same size
-                if(buffered_points.size() != buffered_points_set.size())
-                {
-                    std::stringstream msg;
-                    msg<<"Inconsistency detected between buffered_points and buffered_points_set sizes after subtracting done_points ("<<buffered_points.size()<<" vs "<<buffered_points_set.size()<<")! This is a bug, please report it."<<std::endl;
-                    printer_error().raise(LOCAL_INFO,msg.str());
-                }
+                // Remove flushed points from the buffered points record and the buffers
+                // (the ones that couldn't be flushed, i.e. weren't found on disk (yet), are left in the buffer)
+                erase_points(done_points);
                 //std::cout<<buffered_points.size()<<" points failed to flush from random-access buffer."<<std::endl;
             }
 
             // Release lock on output file
-            close_and_unlock_file();
+            open_file.close();
+        }
+    }
+
+    /// Write the blocks of a synchronised flush to disk (called by the background writer)
+    void HDF5MasterBuffer::write_blocks(HDF5BlockSet& blocks)
+    {
+        lock_and_open_file_now();
+        OpenFileGuard open_file(*this);
+        std::size_t target_pos = get_next_free_position();
+        for(auto it=blocks.begin(); it!=blocks.end(); ++it)
+        {
+            (*it)->write(location_id,target_pos);
+        }
+        open_file.close();
+    }
+
+    /// Start a background writer for the flushes of the synchronised buffers
+    void HDF5MasterBuffer::enable_background_writes(const std::size_t max_queue)
+    {
+        if(not is_synchronised())
+        {
+            std::ostringstream errmsg;
+            errmsg<<"Background writes were requested for a non-synchronised buffer manager! Only synchronised buffers can be written in the background. This is a bug, please report it.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+        writer.reset(new HDF5BackgroundWriter([this](HDF5BlockSet& blocks){ write_blocks(blocks); }, max_queue));
+    }
+
+    /// Wait for the background writer to write all queued flushes
+    void HDF5MasterBuffer::finish_background_writes()
+    {
+        if(writer) writer->wait();
+    }
+
+    /// Keep the output file and datasets open between accesses (or close them)
+    void HDF5MasterBuffer::hold_file_open(const bool hold)
+    {
+        if(hold and not hold_file)
+        {
+            std::lock_guard<std::recursive_mutex> lock(hdf5_file_mutex());
+            hold_file = true;
+            ++held_hdf5_files();
+            for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+            {
+                it->second->keep_datasets_open(true);
+            }
+        }
+        else if(not hold and hold_file)
+        {
+            // Everything queued must be written before the handles are released
+            finish_background_writes();
+            hdf5_file_mutex().lock();
+            hold_file = false;
+            --held_hdf5_files();
+            for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+            {
+                it->second->keep_datasets_open(false);
+            }
+            if(file_open) close_and_unlock_file(); // also releases the mutex
+            else hdf5_file_mutex().unlock();
         }
     }
 
+    /// Set the storage settings of the output datasets
+    void HDF5MasterBuffer::set_dataset_options(const HDF5DataSetOptions& options)
+    {
+        dset_options = options;
+    }
+
+    const HDF5DataSetOptions& HDF5MasterBuffer::get_dataset_options() const
+    {
+        return dset_options;
+    }
+
+    /// Keep away from the output file while another process holds it open
+    void HDF5MasterBuffer::leave_file_to_aggregator(const bool leave)
+    {
+        file_elsewhere = leave;
+    }
+
     /// Print metadata directly to file
     void HDF5MasterBuffer::print_metadata(map_str_str datasets, bool sameset=false)
     {
         // Obtain lock on the output file
         lock_and_open_file();
+        OpenFileGuard open_file(*this);
 
         // Ensure file is open
         ensure_file_is_open();
@@ -630,13 +1002,14 @@ namespace Gambit
         }
 
         // Release lock on output file
-        close_and_unlock_file();
+        open_file.close();
     }
 
     /// Get names of all datasets in the group that we are pointed at
     std::vector<std::pair<std::string,int>> HDF5MasterBuffer::get_all_dset_names_on_disk()
     {
          lock_and_open_file();
+         OpenFileGuard open_file(*this);
 
          // Get all object names in the group
          std::vector<std::string> names = HDF5::lsGroup(group_id);
@@ -654,7 +1027,7 @@ namespace Gambit
              }
          }
 
-         close_and_unlock_file();
+         open_file.close();
 
          return dset_names_and_types;
     }
@@ -667,8 +1040,7 @@ namespace Gambit
         {
             it->second->MPI_flush_to_rank(r);
         }
-        buffered_points.clear();
-        buffered_points_set.clear();
+        clear_points();
     }
 
     /// Give process r permission to begin sending its buffer data
@@ -809,8 +1181,285 @@ namespace Gambit
         }
     }
 
+    /// Start aggregating the flushes of all processes on rank 0
+    void HDF5MasterBuffer::enable_aggregation(const std::size_t max_sends)
+    {
+        if(not is_synchronised())
+        {
+            std::ostringstream errmsg;
+            errmsg<<"Aggregation of the flushes on rank 0 was requested for a non-synchronised buffer manager! Only synchronised buffers can be aggregated. This is a bug, please report it.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+        aggregating = true;
+        max_aggregator_sends = max_sends;
+        if(myComm.Get_rank()==0) hold_file_open(true);
+        else leave_file_to_aggregator(true);
+    }
+
+    /// Stop aggregating the flushes of all processes on rank 0
+    void HDF5MasterBuffer::finish_aggregation()
+    {
+        if(not aggregating) return;
+
+        if(hold_file)
+        {
+            // Each of the other processes sends an empty message after its last flush
+            const int Nsenders = myComm.Get_size()-1;
+            while(aggregator_ends<Nsenders)
+            {
+                MPI_Status status;
+                myComm.Probe(MPI_ANY_SOURCE, h5v2_AGGREGATE, &status);
+                if(not recv_aggregated(status)) ++aggregator_ends;
+            }
+            hold_file_open(false);
+        }
+        else
+        {
+            aggregator_sends.emplace_back();
+            myComm.Isend(aggregator_sends.back().second.data(), 0, MPI_CHAR, 0, h5v2_AGGREGATE, &aggregator_sends.back().first);
+            leave_file_to_aggregator(false);
+        }
+        aggregating = false;
+    }
+
+    /// Wait until rank 0 has received all flushes sent by this process
+    void HDF5MasterBuffer::finish_aggregator_sends()
+    {
+        for(auto it=aggregator_sends.begin(); it!=aggregator_sends.end(); ++it)
+        {
+            myComm.Wait(&(it->first));
+        }
+        aggregator_sends.clear();
+    }
+
+    /// Pack the blocks of a flush and send them to rank 0
+    void HDF5MasterBuffer::send_to_aggregator(HDF5BlockSet& blocks)
+    {
+        // Forget the earlier sends that have completed
+        while(not aggregator_sends.empty())
+        {
+            int done;
+            MPI_Test(&(aggregator_sends.front().first), &done, MPI_STATUS_IGNORE);
+            if(not done) break;
+            aggregator_sends.pop_front();
+        }
+
+        // Limit the memory held by sends in flight, if requested. This waits for rank 0 to receive
+        // them, which it only does when it prints or waits for other processes (see HDF5Printer2::poll).
+        while(max_aggregator_sends>0 and aggregator_sends.size()>=max_aggregator_sends)
+        {
+            myComm.Wait(&(aggregator_sends.front().first));
+            aggregator_sends.pop_front();
+        }
+
+        // The message is the number of blocks, followed by the packed blocks. We must not wait
+        // for rank 0 to receive it, since rank 0 only receives when it prints or is idle.
+        aggregator_sends.emplace_back();
+        std::vector<char>& msg = aggregator_sends.back().second;
+        const std::size_t Nblocks(blocks.size());
+        pack_bytes(msg, &Nblocks, sizeof(Nblocks));
+        for(auto it=blocks.begin(); it!=blocks.end(); ++it)
+        {
+            (*it)->pack(msg);
+        }
+        if(msg.size()>(std::size_t)std::numeric_limits<int>::max())
+        {
+            std::ostringstream errmsg;
+            errmsg<<"A flush of the HDF5 printer buffers is too large ("<<msg.size()<<" bytes) to be sent to rank 0 in one message! Please reduce the 'buffer_length' option of the printer.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+        myComm.Isend(msg.data(), msg.size(), MPI_CHAR, 0, h5v2_AGGREGATE, &(aggregator_sends.back().first));
+    }
+
+    /// Receive and write all flushes that have arrived from other processes
+    void HDF5MasterBuffer::poll_aggregator()
+    {
+        if(not (aggregating and hold_file)) return;
+        MPI_Status status;
+        while(myComm.Iprobe(MPI_ANY_SOURCE, h5v2_AGGREGATE, &status))
+        {
+            if(not recv_aggregated(status)) ++aggregator_ends;
+        }
+    }
+
+    /// Receive a flush from another process and write it
+    bool HDF5MasterBuffer::recv_aggregated(const MPI_Status& probed)
+    {
+        MPI_Status status(probed);
+        int size;
+        int err = MPI_Get_count(&status, MPI_CHAR, &size);
+        if(err<0)
+        {
+            std::stringstream msg;
+            msg<<"Error from MPI_Get_count while attempting to receive a buffer flush from rank "<<status.MPI_SOURCE<<"!";
+            printer_error().raise(LOCAL_INFO,msg.str());
+        }
+        std::vector<char> msg(size);
+        myComm.Recv(msg.data(), size, MPI_CHAR, status.MPI_SOURCE, h5v2_AGGREGATE);
+        if(size==0) return false;
+
+        const char* in = msg.data();
+        std::size_t Nblocks;
+        unpack_bytes(in, &Nblocks, sizeof(Nblocks));
+        HDF5BlockSet blocks;
+        for(std::size_t i=0; i<Nblocks; ++i)
+        {
+            int type;
+            std::size_t name_length;
+            unpack_bytes(in, &type, sizeof(type));
+            unpack_bytes(in, &name_length, sizeof(name_length));
+            const std::string name(in, name_length);
+            in += name_length;
+            switch(type)
+            {
+                case h5v2_type<int      >(): blocks.push_back(unpack_block<int      >(name, in)); break;
+                case h5v2_type<uint     >(): blocks.push_back(unpack_block<uint     >(name, in)); break;
+                case h5v2_type<long     >(): blocks.push_back(unpack_block<long     >(name, in)); break;
+                case h5v2_type<ulong    >(): blocks.push_back(unpack_block<ulong    >(name, in)); break;
+                //case h5v2_type<longlong >(): blocks.push_back(unpack_block<longlong >(name, in)); break;
+                //case h5v2_type<ulonglong>(): blocks.push_back(unpack_block<ulonglong>(name, in)); break;
+                case h5v2_type<float    >(): blocks.push_back(unpack_block<float    >(name, in)); break;
+                case h5v2_type<double   >(): blocks.push_back(unpack_block<double   >(name, in)); break;
+                default:
+                {
+                    std::ostringstream errmsg;
+                    errmsg<<"Unrecognised buffer type ID ("<<type<<") in a buffer flush received from rank "<<status.MPI_SOURCE<<" (for dataset "<<name<<")! This is a bug, please report it.";
+                    printer_error().raise(LOCAL_INFO, errmsg.str());
+                }
+            }
+        }
+
+        if(writer) writer->push(std::move(blocks));
+        else write_blocks(blocks);
+        return true;
+    }
+
+    /// Write the buffers of all processes at once, with collective writes
+    void HDF5MasterBuffer::write_collective(const std::vector<std::pair<std::string,int>>& dsets)
+    {
+#ifdef HDF5PRINTER2_COLLECTIVE
+        finish_background_writes();
+
+        // Every process needs a buffer for every dataset, to take part in every write
+        std::vector<HDF5BufferBase*> buffers;
+        for(auto it=dsets.begin(); it!=dsets.end(); ++it)
+        {
+            switch(it->second)
+            {
+                case h5v2_type<int      >(): buffers.push_back(&get_buffer<int      >(it->first)); break;
+                case h5v2_type<uint     >(): buffers.push_back(&get_buffer<uint     >(it->first)); break;
+                case h5v2_type<long     >(): buffers.push_back(&get_buffer<long     >(it->first)); break;
+                case h5v2_type<ulong    >(): buffers.push_back(&get_buffer<ulong    >(it->first)); break;
+                //case h5v2_type<longlong >(): buffers.push_back(&get_buffer<longlong >(it->first)); break;
+                //case h5v2_type<ulonglong>(): buffers.push_back(&get_buffer<ulonglong>(it->first)); break;
+                case h5v2_type<float    >(): buffers.push_back(&get_buffer<float    >(it->first)); break;
+                case h5v2_type<double   >(): buffers.push_back(&get_buffer<double   >(it->first)); break;
+                default:
+                {
+                    std::ostringstream errmsg;
+                    errmsg<<"Unrecognised buffer type ID ("<<it->second<<") for dataset "<<it->first<<" in collective write! This is a bug, please report it.";
+                    printer_error().raise(LOCAL_INFO, errmsg.str());
+                }
+            }
+        }
+        if(buffers.size()!=all_buffers.size())
+        {
+            std::ostringstream errmsg;
+            errmsg<<"Some print buffers of this process ("<<all_buffers.size()<<" buffers) are missing from the list of datasets for the collective write ("<<dsets.size()<<" datasets)! This is a bug, please report it.";
+            printer_error().raise(LOCAL_INFO, errmsg.str());
+        }
+
+        // Our rows follow those of the lower ranks
+        unsigned long Npoints(get_Npoints());
+        unsigned long offset(0);
+        unsigned long total(0);
+        MPI_Exscan(&Npoints, &offset, 1, MPI_UNSIGNED_LONG, MPI_SUM, *myComm.get_boundcomm());
+        if(myComm.Get_rank()==0) offset = 0; // MPI_Exscan leaves this undefined
+        MPI_Allreduce(&Npoints, &total, 1, MPI_UNSIGNED_LONG, MPI_SUM, *myComm.get_boundcomm());
+        logger()<<LogTags::printers<<LogTags::info<<"Writing "<<Npoints<<" points of "<<total<<" collectively, after "<<offset<<" points of lower ranks"<<EOM;
+
+        if(total>0)
+        {
+            open_file_collective();
+            OpenFileGuard open_file(*this);
+            const std::size_t start = get_next_free_position();
+            for(auto it=buffers.begin(); it!=buffers.end(); ++it)
+            {
+                // Creating and extending datasets are collective too; all processes
+                // make the same calls since they see the same file
+                (*it)->ensure_dataset_exists(location_id, start+total);
+                (*it)->detach_block()->write_collective(location_id, start+offset);
+            }
+            buffered_points.clear();
+            open_file.close();
+        }
+#else
+        (void)dsets;
+        std::ostringstream errmsg;
+        errmsg<<"Collective writes were requested, but this GAMBIT build does not have MPI and a parallel HDF5 library! This is a bug, please report it.";
+        printer_error().raise(LOCAL_INFO, errmsg.str());
+#endif
+    }
+
+    /// Report whether collective writes are possible in this build
+    bool HDF5MasterBuffer::collective_writes_available()
+    {
+#ifdef HDF5PRINTER2_COLLECTIVE
+        return true;
+#else
+        return false;
+#endif
+    }
+
     #endif
 
+#ifdef HDF5PRINTER2_COLLECTIVE
+    /// Open the output file for collective access by all processes
+    void HDF5MasterBuffer::open_file_collective()
+    {
+        if(file_open)
+        {
+            std::stringstream err;
+            err<<"HDF5Printer2 attempted to open the output hdf5 file for collective writes, but it is already open! This is a bug, please report it."<<std::endl;
+            printer_error().raise(LOCAL_INFO, err.str());
+        }
+
+        hdf5_file_mutex().lock();
+
+        // Give everything up again if any of this fails
+        try
+        {
+            file_id = group_id = metadata_id = location_id = -1;
+            have_lock=true;
+            file_collective=true;
+
+            // No file lock is needed, since all processes access the file together through MPI-IO.
+            // (The 'evict on close' property of the usual file access list is not supported by
+            // parallel HDF5, so it is not used here.)
+            hid_t fapl_id = H5Pcreate(H5P_FILE_ACCESS);
+            H5Pset_fapl_mpio(fapl_id, *myComm.get_boundcomm(), MPI_INFO_NULL);
+            file_id = H5Fopen(file.c_str(), H5F_ACC_RDWR, fapl_id);
+            H5Pclose(fapl_id);
+            if(file_id<0)
+            {
+                std::stringstream err;
+                err<<"Failed to open the output hdf5 file '"<<file<<"' for collective writes!"<<std::endl;
+                printer_error().raise(LOCAL_INFO, err.str());
+            }
+            group_id = HDF5::openGroup(file_id,group);
+            metadata_id = HDF5::openGroup(file_id,metadata_group);
+            location_id = group_id;
+
+            file_open=true;
+        }
+        catch(...)
+        {
+            abandon_file();
+            throw;
+        }
+    }
+#endif
+
     /// Ensure HDF5 file is open (and locked for us to use)
     void HDF5MasterBuffer::ensure_file_is_open() const
     {
@@ -825,8 +1474,30 @@ namespace Gambit
     /// Open (and lock) output HDF5 file and obtain HDF5 handles
     void HDF5MasterBuffer::lock_and_open_file(const char access_type)
     {
+        // Everything queued for writing must be on disk before we look at the file
+        finish_background_writes();
+        lock_and_open_file_now(access_type);
+    }
+
+    /// Open (and lock) output HDF5 file, without waiting for the background writer
+    void HDF5MasterBuffer::lock_and_open_file_now(const char access_type)
+    {
+        if(file_elsewhere)
+        {
+            std::stringstream err;
+            err<<"HDF5MasterBuffer attempted to open the output hdf5 file while another process holds it open for writing! This is a bug, please report it."<<std::endl;
+            printer_error().raise(LOCAL_INFO, err.str());
+        }
+
+        // Obtain the lock (other threads of this process first, then other processes)
+        hdf5_file_mutex().lock();
+
+        // Nothing else to do if the file is still open from the last access
+        if(hold_file and file_open) return;
+
         if(have_lock)
         {
+            hdf5_file_mutex().unlock();
             std::stringstream err;
             err<<"HDF5MasterBuffer attempted to obtain a lock on the output hdf5 file, but it already has the lock! This is a bug, please report it."<<std::endl;
             printer_error().raise(LOCAL_INFO, err.str());
@@ -834,24 +1505,34 @@ namespace Gambit
 
         if(file_open)
         {
+            hdf5_file_mutex().unlock();
             std::stringstream err;
             err<<"HDF5Printer2 attempted to open the output hdf5 file, but it is already open! This is a bug, please report it."<<std::endl;
             printer_error().raise(LOCAL_INFO, err.str());
         }
 
-        // Obtain the lock
-        hdf5out.get_lock();
+        // Give everything up again if any of this fails
+        try
+        {
+            file_id = group_id = metadata_id = location_id = -1;
+            hdf5out.get_lock();
+            have_lock=true;
 
-        // Open the file and target groups
-        file_id  = HDF5::openFile(file,false,access_type);
-        group_id = HDF5::openGroup(file_id,group);
-        metadata_id = HDF5::openGroup(file_id,metadata_group);
+            // Open the file and target groups
+            file_id  = HDF5::openFile(file,false,access_type);
+            group_id = HDF5::openGroup(file_id,group);
+            metadata_id = HDF5::openGroup(file_id,metadata_group);
 
-        // Set the target dataset write location to the chosen group
-        location_id = group_id;
+            // Set the target dataset write location to the chosen group
+            location_id = group_id;
 
-        file_open=true;
-        have_lock=true;
+            file_open=true;
+        }
+        catch(...)
+        {
+            abandon_file();
+            throw;
+        }
     }
 
     /// Close (and unlock) output HDF5 file and release HDF5 handles
@@ -895,30 +1576,81 @@ namespace Gambit
             printer_error().raise(LOCAL_INFO, err.str());
         }
 
+        if(hold_file)
+        {
+            // Keep the file open for the next access, but get what we wrote onto disk
+            H5Fflush(file_id, H5F_SCOPE_LOCAL);
+            hdf5_file_mutex().unlock();
+            return;
+        }
+
         // Close groups and file
         HDF5::closeGroup(group_id);
         HDF5::closeGroup(metadata_id);
-        HDF5::closeFile(file_id);
+        if(held_hdf5_files()>0)
+        {
+            // Another master buffer may hold the same file open, and its open objects are
+            // counted as ours, so skip the check for open objects in HDF5::closeFile
+            if(H5Fclose(file_id)<0)
+            {
+                std::stringstream err;
+                err<<"Failed to close the output hdf5 file '"<<file<<"'! See HDF5 error output for more details."<<std::endl;
+                printer_error().raise(LOCAL_INFO, err.str());
+            }
+        }
+        else
+        {
+            HDF5::closeFile(file_id);
+        }
 
         // Release the lock
-        hdf5out.release_lock();
+        if(not file_collective) hdf5out.release_lock();
+        hdf5_file_mutex().unlock();
+        file_collective=false;
 
         file_open=false;
         have_lock=false;
     }
 
+    /// Release the output file after an error, without raising another one
+    void HDF5MasterBuffer::abandon_file()
+    {
+        // A file held open between accesses stays open for the next one
+        if(not (hold_file and file_open))
+        {
+            if(metadata_id>=0) H5Gclose(metadata_id);
+            if(group_id>=0) H5Gclose(group_id);
+            if(file_id>=0) H5Fclose(file_id);
+            file_id = group_id = metadata_id = location_id = -1;
+            if(have_lock and not file_collective)
+            {
+                // The error being handled is the one to report
+                try { hdf5out.release_lock(); }
+                catch(...) {}
+            }
+            file_collective=false;
+            file_open=false;
+            have_lock=false;
+        }
+        hdf5_file_mutex().unlock();
+    }
+
     /// Clear all data in buffers ***and on disk*** for this printer
     void HDF5MasterBuffer::reset()
     {
-        lock_and_open_file();
-        for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+        // If another process holds the file, the data on disk is reset by that process
+        if(not file_elsewhere)
         {
-            it->second->reset(location_id);
-            it->second->reset(metadata_id);
+            lock_and_open_file();
+            OpenFileGuard open_file(*this);
+            for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+            {
+                it->second->reset(location_id);
+                it->second->reset(metadata_id);
+            }
+            open_file.close();
         }
-        close_and_unlock_file();
-        buffered_points.clear();
-        buffered_points_set.clear();
+        clear_points();
     }
 
     /// Add base class point for a buffer to master buffer map
@@ -929,6 +1661,8 @@ namespace Gambit
         {
             /// Not already in the map; add it
             all_buffers.emplace(label,&buff);
+            buff.set_dataset_settings(dset_options);
+            if(hold_file) buff.keep_datasets_open(true);
         }
         else if(&buff!=it->second) // if candidate buffer not the same as the one already in the map
         {
@@ -949,14 +1683,23 @@ namespace Gambit
         }
     }
 
-    /// Inform all buffers that data has been written to certain mpirank/pointID pair
-    /// They will make sure that they have an output slot for this pair, so that all the
-    /// buffers for this printer stay "synchronised".
-    void HDF5MasterBuffer::update_all_buffers(const PPIDpair& ppid)
+    /// Erase points from the point index, and drop their data from all buffers
+    void HDF5MasterBuffer::erase_points(const std::set<PPIDpair>& removed_points)
+    {
+        const std::vector<std::size_t> kept_slots = buffered_points.erase(removed_points);
+        for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
+        {
+            it->second->retain(kept_slots);
+        }
+    }
+
+    /// Clear the point index, and all data in the buffers
+    void HDF5MasterBuffer::clear_points()
     {
+        buffered_points.clear();
         for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
         {
-            it->second->update(ppid);
+            it->second->clear();
         }
     }
 
@@ -1249,8 +1992,8 @@ namespace Gambit
                 ss << "   Buffer "<<it->first<<" contains "<<it->second->N_items_in_buffer()<<" unwritten items (synchronised="<<it->second->is_synchronised()<<")"<<std::endl;
                 // VERBOSE DEBUG OUTPUT
                 ss << "   Unwritten points are:" << std::endl;
-                auto point_set = it->second->get_points_set();
-                for(auto jt = point_set.begin(); jt!=point_set.end(); ++jt)
+                const std::vector<PPIDpair>& points = buffered_points.points();
+                for(auto jt = points.begin(); jt!=points.end(); ++jt)
                 {
                    ss << "   rank="<<jt->rank<<", pointID="<<jt->pointID<<std::endl;
                 }
@@ -1277,69 +2020,37 @@ namespace Gambit
     void HDF5MasterBuffer::extend_all_datasets_to(const std::size_t length)
     {
         lock_and_open_file();
+        OpenFileGuard open_file(*this);
         for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
         {
             it->second->ensure_dataset_exists(location_id, length);
         }
-        close_and_unlock_file();
+        open_file.close();
     }
 
     /// Retrieve a map containing pointers to all buffers managed by this object
     const std::map<std::string,HDF5BufferBase*>& HDF5MasterBuffer::get_all_buffers() { return all_buffers; }
 
     /// Retrieve set containing all points currently known to be in these buffers
-    const std::set<PPIDpair>& HDF5MasterBuffer::get_all_points() { return buffered_points_set; }
+    std::set<PPIDpair> HDF5MasterBuffer::get_all_points()
+    {
+        return std::set<PPIDpair>(buffered_points.points().begin(), buffered_points.points().end());
+    }
 
     /// Make sure all buffers know about all points in all buffers
     /// Should not generally be necessary if points are added in the
     /// "normal" way. Only needed in special circumstances (e.g. when
     /// receiving points from another process).
+    /// The buffers share a single point index, so a point added to any
+    /// of them already has a slot in all of them; this only reports the
+    /// state of the buffers.
     void HDF5MasterBuffer::resynchronise()
     {
         logger()<<LogTags::printers<<LogTags::info<<"Resynchronising print buffers:" << std::endl;
-
-        // Determine all known points in all buffers
-        std::set<PPIDpair> initial_buffer_points = buffered_points_set;
         for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
         {
             logger()<<"   Buffer contains "<<it->second->N_items_in_buffer()<<" items (name="<<it->second->dset_name()<<")"<<std::endl;
-            std::set<PPIDpair> this_buffer_points = it->second->get_points_set();
-            buffered_points_set.insert(this_buffer_points.begin(), this_buffer_points.end());
-        }
-
-        // Update all buffers with these points
-        for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
-        {
-            for(auto jt=buffered_points_set.begin(); jt!=buffered_points_set.end(); ++jt)
-            {
-                it->second->update(*jt);
-            }
-        }
-
-        // Determine which points were not already in the buffers
-        std::set<PPIDpair> new_points;
-        std::set_difference(buffered_points_set.begin(), buffered_points_set.end(),
-                            initial_buffer_points.begin(), initial_buffer_points.end(),
-                            std::inserter(new_points, new_points.end()));
-
-        // Debug info:
-        logger() << std::endl
-                 << "  Initial N points   : "<<initial_buffer_points.size()<<std::endl
-                 << "  Final N points     : "<<buffered_points_set.size()<<std::endl
-                 << "  Difference N points: "<<new_points.size()<<std::endl;
-
-        // Update the buffer variables with the new points
-        for(auto jt=new_points.begin(); jt!=new_points.end(); ++jt)
-        {
-            // Update all buffers with these points
-            for(auto it=all_buffers.begin(); it!=all_buffers.end(); ++it)
-            {
-                it->second->update(*jt);
-            }
-            // Update MasterBuffer variables
-            buffered_points.push_back(*jt);
         }
-
         logger() << std::endl
                  << "Print buffer now contains "<<get_Npoints()<<" items."
                  << EOM;
@@ -1352,37 +2063,22 @@ namespace Gambit
     {
         for(auto pt=removed_points.begin(); pt!=removed_points.end(); ++pt)
         {
-            auto it = buffered_points_set.find(*pt);
-            if(it!=buffered_points_set.end())
-            {
-                buffered_points_set.erase(it);
-                auto jt = std::find(buffered_points.begin(),buffered_points.end(),*pt);
-                if(jt!=buffered_points.end())
-                {
-                    buffered_points.erase(jt);
-                }
-                else
-                {
-                    std::ostringstream errmsg;
-                    errmsg<<"Error untracking point (rank="<<pt->rank<<", pointID="<<pt->pointID<<")! Point was found in tracked set, but not in ordering vector! This is a bug, please report it.";
-                    printer_error().raise(LOCAL_INFO, errmsg.str());
-                }
-            }
-            else
+            if(buffered_points.find(*pt)==HDF5PointIndex::npos)
             {
                 std::ostringstream errmsg;
                 errmsg<<"Could not untrack point (rank="<<pt->rank<<", pointID="<<pt->pointID<<")! Point was not being tracked! This is a bug, please report it.";
                 printer_error().raise(LOCAL_INFO, errmsg.str());
             }
         }
+        erase_points(removed_points);
     }
 
     /// Specialisation declarations for 'get_buffer' function for each buffer type
     #define DEFINE_GET_BUFFER(TYPE)\
     template<>\
-    HDF5Buffer<TYPE>& HDF5MasterBuffer::get_buffer<TYPE>(const std::string& label, const std::vector<PPIDpair>& buffered_points)\
+    HDF5Buffer<TYPE>& HDF5MasterBuffer::get_buffer<TYPE>(const std::string& label)\
     {\
-        HDF5Buffer<TYPE>& out_buffer = CAT(hdf5_buffers_,TYPE).get_buffer(label,buffered_points);\
+        HDF5Buffer<TYPE>& out_buffer = CAT(hdf5_buffers_,TYPE).get_buffer(label);\
         /*logger()<<"Updating buffer map with buffer "<<label<<", C++ type="<<typeid(TYPE).name()<<", type ID="<<out_buffer.get_type_id()<<EOM;*/\
         update_buffer_map(label,out_buffer);\
         return out_buffer;\
@@ -1426,6 +2122,8 @@ namespace Gambit
       , mpiSize(1)
       , lastPointID(nullpoint)
       , use_metadata(false)
+      , aggregate_output(false)
+      , collective_output(false)
 #ifdef WITH_MPI
       , myComm() // initially attaches to MPI_COMM_WORLD
 #endif
@@ -1446,8 +2144,21 @@ namespace Gambit
         {
             set_resume(get_HDF5_primary_printer()->get_resume());
             get_HDF5_primary_printer()->add_aux_buffer(buffermaster);
+            buffermaster.set_dataset_options(get_HDF5_primary_printer()->get_dataset_options());
             #ifdef WITH_MPI
             myComm = get_HDF5_primary_printer()->get_Comm();
+
+            // Only rank 0 may access the output file until finalise
+            if(get_HDF5_primary_printer()->get_aggregate_output())
+            {
+                if(buffermaster.is_synchronised())
+                {
+                    std::ostringstream errmsg;
+                    errmsg<<"Synchronised auxilliary print streams cannot be used with the 'aggregate_output' option of the HDF5 printer! Please switch that option off.";
+                    printer_error().raise(LOCAL_INFO, errmsg.str());
+                }
+                if(myRank!=0) buffermaster.leave_file_to_aggregator(true);
+            }
             #endif
         }
         else
@@ -1459,6 +2170,23 @@ namespace Gambit
             // This is the primary printer. Need to determine resume status
             set_resume(options.getValue<bool>("resume"));
 
+            // Chunking, compression and chunk cache of the output datasets
+            buffermaster.set_dataset_options(HDF5DataSetOptions(options));
+
+            // Write full sync buffers to disk from a background thread, so that the
+            // scan can continue while the file is locked and written?
+            if(options.getValueOrDef<bool>(false,"background_flush") and buffermaster.is_synchronised())
+            {
+                std::size_t max_queue = options.getValueOrDef<std::size_t>(2,"flush_queue_length");
+                if(max_queue<1)
+                {
+                    std::ostringstream errmsg;
+                    errmsg<<"The 'flush_queue_length' option of the HDF5 printer must be at least 1.";
+                    printer_error().raise(LOCAL_INFO, errmsg.str());
+                }
+                buffermaster.enable_background_writes(max_queue);
+            }
+
             // Overwrite output file if one already exists with the same name?
             bool overwrite_file = options.getValueOrDef<bool>(false,"delete_file_on_restart");
 
@@ -1615,6 +2343,12 @@ namespace Gambit
                 HDF5DataSet<ulong>     pointids      ("pointID");
                 HDF5DataSet<int>       pointids_valid("pointID_isvalid");
 
+                const HDF5DataSetOptions& dset_options = buffermaster.get_dataset_options();
+                mpiranks      .set_settings(dset_options.get(mpiranks      .myname()));
+                mpiranks_valid.set_settings(dset_options.get_flags(mpiranks_valid.myname()));
+                pointids      .set_settings(dset_options.get(pointids      .myname()));
+                pointids_valid.set_settings(dset_options.get_flags(pointids_valid.myname()));
+
                 mpiranks      .create_dataset(buffermaster.get_location_id());
                 mpiranks_valid.create_dataset(buffermaster.get_location_id());
                 pointids      .create_dataset(buffermaster.get_location_id());
@@ -1640,6 +2374,36 @@ namespace Gambit
                 myComm.Scatter(highests, highest, 0);
                 get_point_id() = highest;
             }
+
+            // Send the sync buffer flushes to rank 0 during the scan, to be written to an
+            // output file that rank 0 keeps open (instead of every process taking turns to
+            // lock, open and close it)? The datasets now exist, so rank 0 can take over.
+            if(options.getValueOrDef<bool>(false,"aggregate_output") and mpiSize>1 and buffermaster.is_synchronised())
+            {
+                aggregate_output = true;
+                buffermaster.enable_aggregation(options.getValueOrDef<std::size_t>(0,"aggregate_queue_length"));
+            }
+
+            // Write what is left in the sync buffers at the end of the run with collective
+            // parallel HDF5 writes of all processes, instead of gathering it on rank 0?
+            if(options.getValueOrDef<bool>(false,"collective_output") and mpiSize>1)
+            {
+                // Parallel writes through filters are only supported from HDF5 1.10.2
+                const HDF5DataSetOptions& dset_options = buffermaster.get_dataset_options();
+                const bool filters_ok = H5_VERSION_GE(1,10,2) or not (dset_options.any_compressed() or dset_options.packs_flags());
+                if(HDF5MasterBuffer::collective_writes_available() and filters_ok)
+                {
+                    collective_output = true;
+                }
+                else if(myRank==0)
+                {
+                    std::ostringstream msg;
+                    if(filters_ok) msg<<"The 'collective_output' option of the HDF5 printer needs a HDF5 library with parallel (MPI-IO) support, which this GAMBIT build does not have.";
+                    else msg<<"The 'collective_output' option of the HDF5 printer cannot be used with compressed or bit-packed datasets in HDF5 versions older than 1.10.2.";
+                    msg<<" The output of all processes will be gathered and written by rank 0 instead.";
+                    printer_warning().raise(LOCAL_INFO, msg.str());
+                }
+            }
 #else
             if(get_resume())
             {
@@ -1880,6 +2644,15 @@ namespace Gambit
     void HDF5Printer2::flush()
     {
         buffermaster.flush();
+        buffermaster.finish_background_writes();
+    }
+
+    /// Receive and write the flushes that the other processes have sent to rank 0
+    void HDF5Printer2::poll()
+    {
+        #ifdef WITH_MPI
+        buffermaster.poll_aggregator();
+        #endif
     }
 
     // Make sure printer output is fully on disk and safe
@@ -1893,6 +2666,20 @@ namespace Gambit
         // The primary printer will take care of finalising all output.
         if(not is_auxilliary_printer())
         {
+            #ifdef WITH_MPI
+            // Rank 0 writes the last aggregated flushes and closes the output file,
+            // after which every process may access it again
+            buffermaster.finish_aggregation();
+            for(auto it=aux_buffers.begin(); it!=aux_buffers.end(); ++it)
+            {
+                (*it)->leave_file_to_aggregator(false);
+            }
+            #endif
+
+            // Finish the background writes of every process before anything is
+            // gathered, so that all synchronised points are on disk for the RA writes
+            buffermaster.finish_background_writes();
+
             // On HPC systems we are likely to be using hundreds or thousands of processes,
             // over a networked filesystem. If each process tries to write to the
             // output file all at once, it will create an enormous bottleneck and be very
@@ -1924,8 +2711,18 @@ namespace Gambit
             logger()<<"# sync printer streams: "<<sync_buffers.size()<<std::endl;
             logger()<<"# RA printer streams  : "<<RA_buffers.size()<<EOM;
             #endif
-            logger()<<LogTags::printers<<LogTags::info<<"Gathering sync buffer data from all processes to rank 0 process..."<<EOM;
-            gather_and_print(buffermaster,sync_buffers,true);
+            if(collective_output and sync_buffers.size()==1)
+            {
+                // Every process writes its own rows. (Synchronised aux streams have to be
+                // merged into the same rows as the primary stream, so they are gathered instead.)
+                logger()<<LogTags::printers<<LogTags::info<<"Writing sync buffer data of all processes with collective HDF5 writes..."<<EOM;
+                buffermaster.write_collective(get_all_dset_defs(sync_buffers));
+            }
+            else
+            {
+                logger()<<LogTags::printers<<LogTags::info<<"Gathering sync buffer data from all processes to rank 0 process..."<<EOM;
+                gather_and_print(buffermaster,sync_buffers,true);
+            }
             #endif
 
             // Flush remaining buffer data
@@ -2023,6 +2820,11 @@ namespace Gambit
                 printer_warning().raise(LOCAL_INFO, errmsg.str());
             }
 
+            #ifdef WITH_MPI
+            // Rank 0 has received everything by now, since it took part in the gathers
+            buffermaster.finish_aggregator_sends();
+            #endif
+
             logger()<< LogTags::printers << LogTags::info << "HDF5Printer2 output finalisation complete."<<EOM;
 
             // DEBUG
@@ -2031,6 +2833,10 @@ namespace Gambit
         }
     }
 
+    /// Report whether the sync buffer flushes are aggregated on rank 0
+    bool HDF5Printer2::get_aggregate_output() { return aggregate_output; }
+    const HDF5DataSetOptions& HDF5Printer2::get_dataset_options() const { return buffermaster.get_dataset_options(); }
+
     /// Get pointer to primary printer of this class type
     /// (get_primary_printer returns a pointer-to-base)
     HDF5Printer2* HDF5Printer2::get_HDF5_primary_printer()
@@ -2414,6 +3220,33 @@ namespace Gambit
         return std::make_pair(idcodes,ordered_bufs); // Note: ordered_bufs only filled on rank 0!
     }
 
+    /// Agree on the names and types of all datasets written by a set of buffers, on all processes
+    std::vector<std::pair<std::string,int>> HDF5Printer2::get_all_dset_defs(const std::vector<HDF5MasterBuffer*>& masterbuffers)
+    {
+        std::pair<std::map<std::string,int>,std::vector<std::pair<std::string,int>>> idcodes = get_buffer_idcodes(masterbuffers);
+
+        // The types are only known on rank 0, in the order of the ID codes
+        std::vector<int> types(idcodes.first.size());
+        if(myRank==0)
+        {
+            if(idcodes.second.size()!=types.size())
+            {
+                std::ostringstream errmsg;
+                errmsg<<"Some datasets appear more than once (with different types) in the list of all datasets to be written! This is a bug, please report it.";
+                printer_error().raise(LOCAL_INFO, errmsg.str());
+            }
+            for(std::size_t i=0; i<types.size(); ++i) types[i] = idcodes.second[i].second;
+        }
+        myComm.Bcast(types, types.size(), 0);
+
+        std::vector<std::pair<std::string,int>> dsets(types.size());
+        for(auto it=idcodes.first.begin(); it!=idcodes.first.end(); ++it)
+        {
+            dsets.at(it->second) = std::make_pair(it->first, types.at(it->second));
+        }
+        return dsets;
+    }
+
     // Gather buffer data from all processes via MPI and print it on rank 0
     void HDF5Printer2::gather_and_print(HDF5MasterBuffer& out_printbuffer, const std::vector<HDF5MasterBuffer*>& masterbuffers, bool sync)
     {
@@ -60,6 +60,30 @@ namespace Gambit
       _print(val_as_uint,label,vID,mpirank,pointID);
     }
 
+    /// Handle print functions; these skip the buffer lookup after the first print
+    #define PRINT_HANDLE(TYPE) _print(TYPE const& value, print_handle& handle, const uint rank, const ulong pID) \
+       { handle_print(value,handle,rank,pID); }
+    void HDF5Printer2::PRINT_HANDLE(int)
+    void HDF5Printer2::PRINT_HANDLE(uint)
+    void HDF5Printer2::PRINT_HANDLE(long)
+    void HDF5Printer2::PRINT_HANDLE(ulong)
+    void HDF5Printer2::PRINT_HANDLE(float)
+    void HDF5Printer2::PRINT_HANDLE(double)
+    #undef PRINT_HANDLE
+
+    // As for the label prints, longlongs go into the long buffers
+    #define PRINTAS_HANDLE(INTYPE,OUTTYPE) _print(INTYPE const& value, print_handle& handle, const uint rank, const ulong pID) \
+       { handle_print((OUTTYPE)value,handle,rank,pID); }
+    void HDF5Printer2::PRINTAS_HANDLE(longlong, long)
+    void HDF5Printer2::PRINTAS_HANDLE(ulonglong, ulong)
+    #undef PRINTAS_HANDLE
+
+    void HDF5Printer2::_print(bool const& value, print_handle& handle, const unsigned int mpirank, const unsigned long pointID)
+    {
+      unsigned int val_as_uint = value;
+      handle_print(val_as_uint,handle,mpirank,pointID);
+    }
+
     // Piggyback off existing print functions to build standard overloads
     USE_COMMON_PRINT_OVERLOAD(HDF5Printer2, std::vector<double>)
     USE_COMMON_PRINT_OVERLOAD(HDF5Printer2, map_str_dbl)
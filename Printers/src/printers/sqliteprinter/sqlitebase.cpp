@@ -296,6 +296,29 @@ namespace Gambit
        return rc;
     }
 
+    // Prepare a statement, retrying while the database is locked (e.g. while the schema is being changed)
+    int SQLiteBase::prepare_sql(const std::string& sqlstr, sqlite3_stmt** stmt)
+    {
+        int rc;
+        while((rc = sqlite3_prepare_v2(get_db(), sqlstr.c_str(), -1, stmt, NULL)) == SQLITE_BUSY)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return rc;
+    }
+
+    // Step a statement outside of an explicit transaction, retrying while a writer holds the
+    // database lock. (In WAL mode readers are never blocked by writers.)
+    int SQLiteBase::step_sql(sqlite3_stmt* stmt)
+    {
+        int rc;
+        while((rc = sqlite3_step(stmt)) == SQLITE_BUSY)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return rc;
+    }
+
     // Get names and types for all columns in the target table
     // (Output is a map from names to types)
     std::map<std::string, std::string, Utils::ci_less> SQLiteBase::get_column_info()
@@ -56,7 +56,19 @@ namespace Gambit
     , buffer_header()
     , transaction_data_buffer()
     , synchronised(!options.getValueOrDef<bool>(false,"auxilliary"))
+    , use_upsert(options.getValueOrDef<bool>(true,"upsert") and sqlite3_libversion_number() >= 3024000)
+    , journal_mode(options.getValueOrDef<std::string>("","journal_mode"))
+    , synchronous(options.getValueOrDef<std::string>("","synchronous"))
+    , flush_queue_length(options.getValueOrDef<bool>(false,"background_flush") ? options.getValueOrDef<std::size_t>(2,"flush_queue_length") : 0)
+    , writer()
+    , row_stmt(NULL)
+    , row_stmt_ncols(0)
+    , row_stmt_cols()
     {
+        // Buffer 100 points by default. Without UPSERT, auxiliary output can only update rows that
+        // are already in the table, so then each primary point is written as soon as it is complete.
+        if(not options.hasKey("buffer_length") and use_upsert) max_buffer_length = 100;
+
         std::string database_file;
         std::string table_name;
         std::string metadata_table_name;
@@ -70,6 +82,10 @@ namespace Gambit
             table_name          = primary_printer->get_table_name();
             metadata_table_name = primary_printer->get_metadata_table_name();
             max_buffer_length   = primary_printer->get_max_buffer_length();
+            journal_mode        = primary_printer->get_journal_mode();
+            synchronous         = primary_printer->get_synchronous();
+            flush_queue_length  = primary_printer->get_flush_queue_length();
+            use_upsert          = primary_printer->get_use_upsert();
         }
         else
         {
@@ -151,12 +167,31 @@ namespace Gambit
         // Create/open the database file
         open_db(database_file,'+');
 
+        // Connection options. WAL mode is stored in the database file; the others only
+        // apply to this connection, so every printer sets them.
+        if(not journal_mode.empty()) set_pragma("journal_mode", journal_mode, {"DELETE","TRUNCATE","PERSIST","MEMORY","WAL","OFF"});
+        if(not synchronous.empty()) set_pragma("synchronous", synchronous, {"OFF","NORMAL","FULL","EXTRA"});
+
         // Create the results table in the database (if it doesn't already exist)
         make_table(table_name);
         make_metadata_table(metadata_table_name);
         set_table_name(table_name); // Inform base class of table name
         set_metadata_table_name(metadata_table_name);
 
+        // The writer thread uses the same connection as the main thread (never at the same
+        // time), which needs a thread safe SQLite library
+        if(flush_queue_length>0)
+        {
+            if(sqlite3_threadsafe()==0)
+            {
+                logger() << LogTags::printers << LogTags::warn << "SQLite printer: background_flush was requested, but the SQLite library was built without thread support. Writing the buffers from the main thread instead." << EOM;
+            }
+            else
+            {
+                writer.reset(new BackgroundWriter<SQLiteBatch>([this](SQLiteBatch& batch){ write_batch(batch); }, flush_queue_length));
+            }
+        }
+
         // If we are resuming and this is the primary printer, need to read the database and find the previous
         // highest pointID numbers used for this rank
         std::size_t my_highest_pointID=0;
@@ -168,7 +203,7 @@ namespace Gambit
 
             /* Execute SQL statement and iterate through results*/
             sqlite3_stmt *stmt;
-            int rc = sqlite3_prepare_v2(get_db(), sql.str().c_str(), -1, &stmt, NULL);
+            int rc = prepare_sql(sql.str(), &stmt);
             if (rc != SQLITE_OK)
             {
                 std::stringstream err;
@@ -176,7 +211,7 @@ namespace Gambit
                 printer_error().raise(LOCAL_INFO, err.str());
             }
             int colcount=0;
-            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+            while ((rc = step_sql(stmt)) == SQLITE_ROW)
             {
                 my_highest_pointID = sqlite3_column_int64(stmt, 0);
                 colcount++;
@@ -198,7 +233,7 @@ namespace Gambit
             std::stringstream sql2;
             sql2 << "SELECT MAX(metadataID) FROM " << get_metadata_table_name() << ";";
             sqlite3_stmt *stmt2;
-            rc = sqlite3_prepare_v2(get_db(), sql2.str().c_str(), -1, &stmt2, NULL);
+            rc = prepare_sql(sql2.str(), &stmt2);
             if (rc != SQLITE_OK)
             {
                 std::stringstream err;
@@ -206,7 +241,7 @@ namespace Gambit
                 printer_error().raise(LOCAL_INFO, err.str());
             }
             colcount=0;
-            while ((rc = sqlite3_step(stmt2)) == SQLITE_ROW)
+            while ((rc = step_sql(stmt2)) == SQLITE_ROW)
             {
                 lastMetadataID = sqlite3_column_int64(stmt2, 0);
                 lastMetadataID++;
@@ -241,7 +276,51 @@ namespace Gambit
         }
     }
 
+    SQLitePrinter::~SQLitePrinter()
+    {
+        // The writer thread must finish, and statements must be finalized, before the base
+        // class can close the database
+        writer.reset();
+        finalize_row_statement();
+    }
+
     std::size_t SQLitePrinter::get_max_buffer_length() {return max_buffer_length;}
+    std::string SQLitePrinter::get_journal_mode() {return journal_mode;}
+    std::string SQLitePrinter::get_synchronous() {return synchronous;}
+    std::size_t SQLitePrinter::get_flush_queue_length() {return flush_queue_length;}
+    bool SQLitePrinter::get_use_upsert() {return use_upsert;}
+
+    // Callback storing the first column of a result row in the std::string pointed to by 'out'
+    static int first_col_callback(void* out, int count, char** data, char** /* columns */)
+    {
+        if(count > 0 and data[0] != NULL) *static_cast<std::string*>(out) = data[0];
+        return 0;
+    }
+
+    // Run a PRAGMA that sets a connection option
+    void SQLitePrinter::set_pragma(const std::string& name, const std::string& value, const std::vector<std::string>& allowed)
+    {
+        bool ok = false;
+        for(const auto& a : allowed) ok = ok or Utils::iequals(a, value);
+        if(not ok)
+        {
+            std::stringstream err;
+            err << "Invalid value '" << value << "' for the '" << name << "' option of the SQLite printer. Allowed values are:";
+            for(const auto& a : allowed) err << " " << a;
+            printer_error().raise(LOCAL_INFO, err.str());
+        }
+
+        std::string result;
+        submit_sql(LOCAL_INFO, "PRAGMA "+name+"="+value+";", false, &first_col_callback, &result);
+
+        // journal_mode reports the mode actually in use, which differs if the change was not possible
+        // (e.g. WAL on a file system without shared memory support)
+        if(not result.empty() and not Utils::iequals(result, value))
+        {
+            logger() << LogTags::printers << LogTags::warn << "SQLite printer: requested " << name << "=" << value
+                     << " for database " << get_database_file() << ", but SQLite is using " << name << "=" << result << "." << EOM;
+        }
+    }
 
     void SQLitePrinter::initialise(const std::vector<int>&)
     {
@@ -254,6 +333,7 @@ namespace Gambit
         // with new ones.
 
         lastPointID = nullpoint;
+        finish_background_writes();
 
         // Primary printers aren't allowed to delete stuff unless 'force' is set to true
         if((is_auxilliary_printer() or force) and (buffer_header.size()>0))
@@ -261,6 +341,12 @@ namespace Gambit
             // Read through header to see what columns this printer has been touching. These are
             // the ones that we will reset/delete.
             // (a more nuanced reset might be required in the future?)
+            // Columns are created when the buffer is written, so some may not exist yet.
+            for(const auto& col_name : buffer_header)
+            {
+                ensure_column_exists(get_table_name(), col_name, buffer_info.at(col_name).second);
+            }
+
             std::stringstream sql;
             sql<<"UPDATE "<<get_table_name()<<" SET ";
             for(auto col_name_it=buffer_header.begin(); col_name_it!=buffer_header.end(); ++col_name_it)
@@ -277,6 +363,7 @@ namespace Gambit
     // Print metadata info to file
     void SQLitePrinter::_print_metadata(map_str_str metadata)
     {
+      finish_background_writes();
 
       std::stringstream sql;
 
@@ -331,6 +418,7 @@ namespace Gambit
     {
       // Dump buffer to disk. Nothing special needed for early shutdown.
       dump_buffer();
+      finish_background_writes();
 
       // Add last point ID to metadata
       if (get_output_metadata())
@@ -517,7 +605,7 @@ namespace Gambit
     }
 
     // Queue data for a table insert operation into the SQLitePrinter internal buffer
-    void SQLitePrinter::insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& col_name, const std::string& col_type, const std::string& data)
+    void SQLitePrinter::insert_data(const unsigned int mpirank, const unsigned long pointID, const std::string& col_name, const std::string& col_type, const SQLiteCell& data)
     {
         // Get the pairID for this rank/pointID combination
         std::size_t rowID = pairfunc(mpirank,pointID);
@@ -525,10 +613,6 @@ namespace Gambit
         // Last point ID
         lastPointID = PPIDpair(pointID,mpirank);
 
-        // Make sure we have a record of this column existing in the output table
-        // Create it if needed.
-        ensure_column_exists(get_table_name(), col_name, col_type);
-
         // Check if a row for this data exists in the transaction buffer
         auto buf_it=transaction_data_buffer.find(rowID);
         if(buf_it==transaction_data_buffer.end())
@@ -544,8 +628,10 @@ namespace Gambit
             }
 
             // Data is set to 'null' until we add some.
-            std::size_t current_row_size=buffer_info.size();
-            transaction_data_buffer.emplace(rowID,std::vector<std::string>(current_row_size,"null"));
+            SQLiteRow& row = transaction_data_buffer[rowID];
+            row.mpirank = mpirank;
+            row.pointID = pointID;
+            row.cells.resize(buffer_info.size());
         }
 
         // Check if this column exists in the current output buffer
@@ -571,11 +657,11 @@ namespace Gambit
             for(auto jt=transaction_data_buffer.begin();
                      jt!=transaction_data_buffer.end(); ++jt)
             {
-               std::vector<std::string>& row = jt->second;
+               std::vector<SQLiteCell>& row = jt->second.cells;
 
                // Add new empty column to every row
                // Values are null until we add them
-               row.push_back("null");
+               row.push_back(SQLiteCell());
 
                // Make sure size is correct
                if(row.size()!=buffer_header.size())
@@ -605,7 +691,7 @@ namespace Gambit
 
         // Add the data to the transaction buffer
         std::size_t col_index = it->second.first;
-        transaction_data_buffer.at(rowID).at(col_index) = data;
+        transaction_data_buffer.at(rowID).cells.at(col_index) = data;
     }
 
     // Delete all buffer data. Leaves the header intact so that we know what columns
@@ -615,106 +701,154 @@ namespace Gambit
         transaction_data_buffer.clear();
     }
 
-    // Create an SQL table insert operation for the current transaction_data_buffer
-    // Modifies 'sql' stringstream in-place
-    void SQLitePrinter::turn_buffer_into_insert(std::stringstream& sql, const std::string& table)
+    // Prepare the statement that writes one buffer row, unless the cached one is still
+    // good. Parameters: ?1 pairID, ?2 MPIrank, ?3 pointID, ?4... the buffer columns.
+    int SQLitePrinter::prepare_row_statement(const std::vector<std::string>& header)
     {
-        sql<<"INSERT INTO "<<table<<" (\npairID,\n";
-        for(auto col_name_it=buffer_header.begin(); col_name_it!=buffer_header.end(); ++col_name_it)
-        {
-            sql<<"`"<<(*col_name_it)<<"`"<<comma_unless_last(col_name_it,buffer_header)<<"\n";
-        }
-        sql<<") VALUES ";
-        for(auto row_it=transaction_data_buffer.begin();
-                 row_it!=transaction_data_buffer.end(); ++row_it)
+        if(row_stmt!=NULL and row_stmt_ncols==header.size()) return SQLITE_OK;
+        finalize_row_statement();
+
+        // MPIrank and pointID are always bound from the row itself
+        row_stmt_cols.clear();
+        for(std::size_t i=0; i<header.size(); ++i)
         {
-            sql<<"(\n";
-            std::size_t pairID = row_it->first;
-            std::vector<std::string>& row = row_it->second;
-            sql<<pairID<<",\n";
-            for(auto col_it=row.begin(); col_it!=row.end(); ++col_it)
+            if(not Utils::iequals(header[i],"MPIrank") and not Utils::iequals(header[i],"pointID"))
             {
-                sql<<(*col_it)<<comma_unless_last(col_it,row)<<"\n";
+                row_stmt_cols.push_back(i);
             }
-            sql<<")\n"<<comma_unless_last(row_it,transaction_data_buffer);
         }
-        sql<<";"; // End statement
-    }
 
-    // Execute an SQLite transaction to write the buffer to the output table
-    void SQLitePrinter::dump_buffer_as_INSERT()
-    {
-        // Add the table INSERT operation to a stream
+        // Columns not printed for a point are null in the buffer; they never replace existing values
+        std::stringstream set;
+        for(std::size_t k=0; k<row_stmt_cols.size(); ++k)
+        {
+            const std::string& col = header[row_stmt_cols[k]];
+            set<<(k>0 ? "," : "")<<"`"<<col<<"`=coalesce("<<(use_upsert ? "excluded.`"+col+"`" : "?"+std::to_string(k+4))<<",`"<<col<<"`)";
+        }
+
         std::stringstream sql;
-        turn_buffer_into_insert(sql,get_table_name());
+        if(use_upsert or synchronised)
+        {
+            sql<<"INSERT INTO "<<get_table_name()<<" (pairID,MPIrank,pointID";
+            for(std::size_t i : row_stmt_cols) sql<<",`"<<header[i]<<"`";
+            sql<<") VALUES (?1,?2,?3";
+            for(std::size_t k=0; k<row_stmt_cols.size(); ++k) sql<<",?"<<k+4;
+            sql<<")";
+            // Primary and auxiliary output for the same point may arrive in either order
+            if(use_upsert) sql<<" ON CONFLICT(pairID) DO "<<(row_stmt_cols.empty() ? "NOTHING" : "UPDATE SET "+set.str());
+        }
+        else
+        {
+            // Old SQLite library: auxiliary output only updates existing rows
+            sql<<"UPDATE "<<get_table_name()<<" SET "<<(row_stmt_cols.empty() ? "pairID=pairID" : set.str())<<" WHERE pairID=?1";
+        }
+        sql<<";";
 
-        //std::cout<<sql.str(); // DEBUG
+        int rc = sqlite3_prepare_v2(get_db(), sql.str().c_str(), -1, &row_stmt, NULL);
+        if(rc!=SQLITE_OK)
+        {
+            row_stmt = NULL;
+            return rc;
+        }
+        row_stmt_ncols = header.size();
+        return SQLITE_OK;
+    }
 
-        /* Execute SQL statement */
-        submit_sql(LOCAL_INFO,sql.str());
+    void SQLitePrinter::finalize_row_statement()
+    {
+        sqlite3_finalize(row_stmt); // no-op for NULL
+        row_stmt = NULL;
+        row_stmt_ncols = 0;
     }
 
-    void SQLitePrinter::dump_buffer_as_UPDATE()
+    // Write every row of a batch with the cached row statement
+    int SQLitePrinter::write_batch_rows(const SQLiteBatch& batch)
     {
-        std::stringstream sql;
-        // So for this is seems like the best thing to do is create a temporary
-        // table with this new data, and then update the main output table from
-        // this. Otherwise we have to write tonnes of separate 'update' statements,
-        // which is probably not very fast.
-        // So first we need to create the temporary table.
-        sql << "DROP TABLE IF EXISTS temp_table;\n"
-            << "CREATE TEMPORARY TABLE temp_table("
-            << "pairID   INT PRIMARY KEY NOT NULL,\n";
-        for(auto col_it=buffer_info.begin(); col_it!=buffer_info.end(); ++col_it)
+        int rc = prepare_row_statement(batch.header);
+        if(rc!=SQLITE_OK) return rc;
+
+        for(const auto& row_it : batch.rows)
         {
-            const std::string& col_name(col_it->first);
-            const std::string& col_type(col_it->second.second);
-            sql<<"`"<<col_name<<"`   "<<col_type<<comma_unless_last(col_it,buffer_info)<<"\n";
+            const SQLiteRow& row = row_it.second;
+            sqlite3_bind_int64(row_stmt, 1, row_it.first);
+            sqlite3_bind_int64(row_stmt, 2, row.mpirank);
+            sqlite3_bind_int64(row_stmt, 3, row.pointID);
+            for(std::size_t k=0; k<row_stmt_cols.size(); ++k)
+            {
+                const SQLiteCell& cell = row.cells[row_stmt_cols[k]];
+                switch(cell.kind)
+                {
+                    case SQLiteCell::integer_cell: sqlite3_bind_int64(row_stmt, k+4, cell.i); break;
+                    case SQLiteCell::real_cell:    sqlite3_bind_double(row_stmt, k+4, cell.r); break;
+                    default:                       sqlite3_bind_null(row_stmt, k+4); break;
+                }
+            }
+            rc = sqlite3_step(row_stmt);
+            sqlite3_reset(row_stmt);
+            if(rc!=SQLITE_DONE) return rc;
         }
-        sql <<");\n";
-
-        // Insert data into the temporary table
-        turn_buffer_into_insert(sql,"temp_table");
+        return SQLITE_OK;
+    }
 
-        // Update the primary output table using the temporary table
-        // Following: https://stackoverflow.com/a/47753166/1447953
-        sql<<"UPDATE "<<get_table_name()<<" SET (\n";
-        for(auto col_name_it=buffer_header.begin(); col_name_it!=buffer_header.end(); ++col_name_it)
+    // Write a batch to the output table in a single transaction
+    void SQLitePrinter::write_batch(SQLiteBatch& batch)
+    {
+        // New columns are only created here, at flush boundaries
+        for(std::size_t i=0; i<batch.header.size(); ++i)
         {
-            sql<<*col_name_it<<comma_unless_last(col_name_it,buffer_header)<<"\n";
+            ensure_column_exists(get_table_name(), batch.header[i], batch.types[i]);
         }
-        sql<<") = (SELECT \n";
-        for(auto col_name_it=buffer_header.begin(); col_name_it!=buffer_header.end(); ++col_name_it)
+
+        int rc;
+        do
         {
-            sql<<"temp_table."<<*col_name_it<<comma_unless_last(col_name_it,buffer_header)<<"\n";
+            // IMMEDIATE takes the write lock up front (submit_sql waits while the database is busy)
+            submit_sql(LOCAL_INFO, "BEGIN IMMEDIATE;");
+            rc = write_batch_rows(batch);
+            if(rc==SQLITE_OK)
+            {
+                submit_sql(LOCAL_INFO, "COMMIT;");
+            }
+            else
+            {
+                std::stringstream err;
+                err<<"SQL error while writing the SQLitePrinter buffer to the output table: "<<sqlite3_errmsg(get_db())<<std::endl;
+#ifdef SQL_DEBUG
+                if(row_stmt!=NULL) err<<"The attempted SQL statement was:"<<std::endl<<sqlite3_sql(row_stmt)<<std::endl;
+#endif
+                // A busy error inside a transaction needs a rollback before the retry
+                submit_sql(LOCAL_INFO, "ROLLBACK;", true);
+                if(rc!=SQLITE_BUSY) printer_error().raise(LOCAL_INFO, err.str());
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
-        sql<<" FROM temp_table WHERE temp_table.pairID = "<<get_table_name()<<".pairID)\n";
-        sql<<" WHERE EXISTS ( SELECT * FROM temp_table WHERE temp_table.pairID = "<<get_table_name()<<".pairID);\n";
-
-        /* Execute SQL statement */
-        submit_sql(LOCAL_INFO,sql.str());
+        while(rc==SQLITE_BUSY);
     }
 
+    // Hand the buffer over to be written, and clear it
     void SQLitePrinter::dump_buffer()
     {
         require_output_ready();
         // Don't try to dump the buffer if it is empty!
         if(transaction_data_buffer.size()>0)
         {
-            if(synchronised)
-            {
-                // Primary dataset writes can be performed as INSERT operations
-                dump_buffer_as_INSERT();
-            }
-            else
-            {
-                // Asynchronous ('auxilliary') writes need to be performed as UPDATE operations
-                dump_buffer_as_UPDATE();
-            }
+            SQLiteBatch batch;
+            batch.rows.swap(transaction_data_buffer);
+            batch.header = buffer_header;
+            for(const auto& col : buffer_header) batch.types.push_back(buffer_info.at(col).second);
+
+            if(writer) writer->push(std::move(batch));
+            else write_batch(batch);
+
             // Clear all the buffer data
             clear_buffer();
         }
     }
 
+    void SQLitePrinter::finish_background_writes()
+    {
+        if(writer) writer->wait();
+    }
+
   }
 }
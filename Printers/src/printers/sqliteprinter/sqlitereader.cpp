@@ -131,7 +131,7 @@ namespace Gambit
          sql<<" FROM "<<get_table_name();
     
          /* Execute SQL statement and iterate through results*/ 
-         int rc = sqlite3_prepare_v2(get_db(), sql.str().c_str(), -1, &stmt, NULL);
+         int rc = prepare_sql(sql.str(), &stmt);
          if (rc != SQLITE_OK) {
              std::stringstream err;
              err<<"Encountered SQLite error while preparing to read data from previous run: "<<sqlite3_errmsg(get_db());
@@ -173,13 +173,13 @@ namespace Gambit
          std::stringstream sql;
          sql<<"SELECT COUNT(pairID) FROM "<<get_table_name()<<";";
          sqlite3_stmt *temp_stmt;
-         int rc = sqlite3_prepare_v2(get_db(), sql.str().c_str(), -1, &temp_stmt, NULL);
+         int rc = prepare_sql(sql.str(), &temp_stmt);
          if (rc != SQLITE_OK) {
              std::stringstream err;
              err<<"Encountered SQLite error while preparing to measure length of input table: "<<sqlite3_errmsg(get_db());
              printer_error().raise(LOCAL_INFO, err.str());
          }
-         rc = sqlite3_step(temp_stmt);
+         rc = step_sql(temp_stmt);
          cout_row(temp_stmt); // DEBUG
          if (rc != SQLITE_ROW) {
              std::stringstream err;
@@ -215,7 +215,7 @@ namespace Gambit
          else
          {
              // Process the next row
-             int rc = sqlite3_step(stmt);
+             int rc = step_sql(stmt);
              if(rc==SQLITE_ROW)
              {
                  std::size_t rank = sqlite3_column_int64(stmt, get_col_i("MPIrank"));
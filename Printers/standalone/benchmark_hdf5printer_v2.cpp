@@ -0,0 +1,342 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Stand-alone benchmark of HDF5Printer2
+///  throughput: prints every dataset at every
+///  point, as a scan does, and reports points
+///  per second (including the flushes to disk
+///  and the final combination) for 50, 500 and
+///  5,000 datasets, printing by label and
+///  through print handles. Then compares the
+///  dataset storage options (chunk_length,
+///  compression, shuffle, chunk_cache_mb and
+///  dataset_options) for 500 datasets, a quarter
+///  of which are printed at only one point in
+///  fifty so that their _isvalid columns are
+///  mostly zero: reports points per second
+///  written, the file size and points per second
+///  read back (every dataset and flag, with the
+///  file in the page cache).
+///
+///  Run with more than one MPI process, it
+///  instead compares the ways the output of all
+///  processes reaches the file: each process
+///  locking the file to flush its buffers, the
+///  flushes sent to rank 0 (aggregate_output),
+///  and everything left for the end of the run,
+///  then gathered on rank 0 or written with
+///  collective parallel HDF5 writes
+///  (collective_output). Every file is checked
+///  against the gathered one, and the exit status
+///  is non-zero if any differs.
+///
+///  usage: benchmark_hdf5printer_v2 [prints per run] [output directory]
+///         mpirun -np <n> benchmark_hdf5printer_v2 [prints per run] [output directory]
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <sys/stat.h>
+
+#include "gambit/Printers/printers/hdf5printer_v2.hpp"
+#include "gambit/Utils/util_functions.hpp"
+#ifdef WITH_MPI
+  #include "gambit/Utils/mpiwrapper.hpp"
+#endif
+
+// Annoying other things we need due to mostly unwanted dependencies
+#include "gambit/Utils/static_members.hpp"
+
+using namespace Gambit;
+using namespace Printers;
+
+namespace
+{
+  const std::string file_name = "benchmark.hdf5";
+
+  /// Whether dataset d is printed at point p: with 'sparse', every fourth dataset is printed at only
+  /// one point in fifty
+  bool printed(const std::size_t d, const std::size_t p, const bool sparse)
+  {
+    return not sparse or d%4 != 3 or p%50 == 0;
+  }
+
+  /// Print n_points points of n_datasets doubles each to a new file, returning the points per second.
+  /// 'storage' holds further printer options.
+  double run(const std::string& dir, const std::size_t n_datasets, const std::size_t n_points, const bool handles,
+             const YAML::Node& storage = YAML::Node(), const bool sparse = false, const unsigned int rank = 0)
+  {
+    YAML::Node node = YAML::Clone(storage);
+    node["output_path"] = dir;
+    node["output_file"] = file_name;
+    node["group"] = "/data";
+    node["resume"] = false;
+    node["delete_file_on_restart"] = true;
+    Options options(node);
+
+    std::vector<std::string> labels;
+    std::vector<print_handle> print_handles;
+    for (std::size_t d = 0; d < n_datasets; ++d)
+    {
+      std::ostringstream label;
+      label << "dataset_" << d;
+      labels.push_back(label.str());
+      print_handles.push_back(print_handle(label.str(), d));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      HDF5Printer2 printer(options);
+      for (std::size_t p = 0; p < n_points; ++p)
+      {
+        // The printer finds its write position from these, which every scan prints at every point
+        printer.print((int)rank, "MPIrank", rank, p);
+        printer.print((ulong)p, "pointID", rank, p);
+
+        for (std::size_t d = 0; d < n_datasets; ++d)
+        {
+          if (not printed(d, p, sparse)) continue;
+          const double value = p + 1e-3*d;
+          if (handles) printer.print(value + rank, print_handles[d], rank, p);
+          else printer.print(value + rank, labels[d], d, rank, p);
+        }
+      }
+      printer.finalise();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return n_points / std::chrono::duration<double>(end - start).count();
+  }
+
+  /// Read every dataset of the file and its validity flags, returning the points per second
+  double read_back(const std::string& path, const std::size_t n_datasets)
+  {
+    auto start = std::chrono::steady_clock::now();
+    hid_t file_id = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    std::vector<double> values;
+    std::vector<int> flags;
+    hsize_t n_points = 0;
+    for (std::size_t d = 0; d < n_datasets; ++d)
+    {
+      std::ostringstream label;
+      label << "/data/dataset_" << d;
+      for (const bool isvalid : {false, true})
+      {
+        hid_t dset_id = H5Dopen2(file_id, (label.str() + (isvalid ? "_isvalid" : "")).c_str(), H5P_DEFAULT);
+        hid_t space_id = H5Dget_space(dset_id);
+        H5Sget_simple_extent_dims(space_id, &n_points, NULL);
+        if (isvalid)
+        {
+          flags.resize(n_points);
+          H5Dread(dset_id, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, flags.data());
+        }
+        else
+        {
+          values.resize(n_points);
+          H5Dread(dset_id, H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data());
+        }
+        H5Sclose(space_id);
+        H5Dclose(dset_id);
+      }
+    }
+    H5Fclose(file_id);
+    auto end = std::chrono::steady_clock::now();
+    return n_points / std::chrono::duration<double>(end - start).count();
+  }
+
+  /// Size of a file in MB
+  double file_size_mb(const std::string& path)
+  {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size/1048576. : 0;
+  }
+
+  /// The storage options compared
+  std::vector<std::pair<std::string,YAML::Node>> storage_options()
+  {
+    std::vector<std::pair<std::string,YAML::Node>> out;
+    out.emplace_back("defaults", YAML::Load("{}"));
+    out.emplace_back("chunk_length 10", YAML::Load("{chunk_length: 10}"));
+    out.emplace_back("chunk_length 1000", YAML::Load("{chunk_length: 1000}"));
+    out.emplace_back("deflate 4", YAML::Load("{chunk_length: 1000, compression: deflate}"));
+    out.emplace_back("deflate 4 + shuffle", YAML::Load("{chunk_length: 1000, compression: deflate, shuffle: true}"));
+    out.emplace_back("deflate 1 + shuffle", YAML::Load("{chunk_length: 1000, compression: deflate, compression_level: 1, shuffle: true}"));
+    out.emplace_back("+ chunk_cache_mb 0", YAML::Load("{chunk_length: 1000, compression: deflate, shuffle: true, chunk_cache_mb: 0}"));
+    out.emplace_back("+ chunk_cache_mb 16", YAML::Load("{chunk_length: 1000, compression: deflate, shuffle: true, chunk_cache_mb: 16}"));
+    out.emplace_back("deflate 9 _isvalid only", YAML::Load("{chunk_length: 1000, dataset_options: {'.*_isvalid': {compression: deflate, compression_level: 9}}}"));
+    return out;
+  }
+
+  /// The benchmarks of a single process
+  int serial_benchmarks(const std::size_t prints, const std::string& dir)
+  {
+    std::cout << "HDF5Printer2 throughput, " << prints << " prints per run (output in " << dir << ")" << std::endl
+              << std::setw(10) << "datasets" << std::setw(10) << "points"
+              << std::setw(18) << "by label (pt/s)" << std::setw(18) << "by handle (pt/s)" << std::endl;
+
+    for (std::size_t n_datasets : {50, 500, 5000})
+    {
+      const std::size_t n_points = std::max<std::size_t>(prints/n_datasets, 1);
+      const double by_label = run(dir, n_datasets, n_points, false);
+      const double by_handle = run(dir, n_datasets, n_points, true);
+      std::cout << std::setw(10) << n_datasets << std::setw(10) << n_points << std::fixed << std::setprecision(0)
+                << std::setw(18) << by_label << std::setw(18) << by_handle << std::endl;
+    }
+
+    const std::size_t n_datasets = 500;
+    const std::size_t n_points = std::max<std::size_t>(prints/n_datasets, 1);
+    std::cout << std::endl << "Storage options, " << n_datasets << " datasets (a quarter mostly invalid), " << n_points << " points, by handle" << std::endl
+              << std::setw(26) << "options" << std::setw(14) << "write (pt/s)" << std::setw(12) << "size (MB)" << std::setw(14) << "read (pt/s)" << std::endl;
+    for (const auto& storage : storage_options())
+    {
+      const double write = run(dir, n_datasets, n_points, true, storage.second, true);
+      const double size = file_size_mb(dir + "/" + file_name);
+      const double read = read_back(dir + "/" + file_name, n_datasets);
+      std::cout << std::setw(26) << storage.first << std::fixed << std::setprecision(0) << std::setw(14) << write
+                << std::setprecision(2) << std::setw(12) << size << std::setprecision(0) << std::setw(14) << read << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+  }
+
+#ifdef WITH_MPI
+  /// The values of every point in a file, by MPI rank and pointID
+  typedef std::map<std::pair<int,ulong>,std::vector<double>> point_values;
+
+  /// Read every point of a file; values that are not valid are read as -1
+  point_values read_points(const std::string& path, const std::size_t n_datasets)
+  {
+    hid_t file_id = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    auto read = [file_id](const std::string& name, hid_t type, void* out, std::size_t n)
+    {
+      hid_t dset_id = H5Dopen2(file_id, ("/data/" + name).c_str(), H5P_DEFAULT);
+      hid_t space_id = H5Dget_space(dset_id);
+      hsize_t length = 0;
+      H5Sget_simple_extent_dims(space_id, &length, NULL);
+      if (out != NULL and length == n) H5Dread(dset_id, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, out);
+      H5Sclose(space_id);
+      H5Dclose(dset_id);
+      return (std::size_t)length;
+    };
+
+    const std::size_t length = read("pointID", H5T_NATIVE_ULONG, NULL, 0);
+    std::vector<int> ranks(length), flags(length);
+    std::vector<ulong> pointIDs(length);
+    std::vector<double> values(length);
+    read("MPIrank", H5T_NATIVE_INT, ranks.data(), length);
+    read("pointID", H5T_NATIVE_ULONG, pointIDs.data(), length);
+    read("pointID_isvalid", H5T_NATIVE_INT, flags.data(), length);
+    point_values out;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+      if (flags[i]) out[std::make_pair(ranks[i], pointIDs[i])].resize(n_datasets, -1);
+    }
+    for (std::size_t d = 0; d < n_datasets; ++d)
+    {
+      std::ostringstream label;
+      label << "dataset_" << d;
+      read(label.str(), H5T_NATIVE_DOUBLE, values.data(), length);
+      read(label.str() + "_isvalid", H5T_NATIVE_INT, flags.data(), length);
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        auto it = out.find(std::make_pair(ranks[i], pointIDs[i]));
+        if (flags[i] and it != out.end()) it->second[d] = values[i];
+      }
+    }
+    H5Fclose(file_id);
+    return out;
+  }
+
+  /// Compare the ways the output of all MPI processes is written to the file
+  int mpi_benchmarks(const std::size_t prints, const std::string& dir)
+  {
+    GMPI::Comm comm;
+    const int rank = comm.Get_rank();
+    const int size = comm.Get_size();
+    const std::size_t n_datasets = 50;
+    const std::size_t n_points = std::max<std::size_t>(prints/n_datasets/size, 1);
+
+    // Buffers of up to 1000 points are flushed (at least ten times) during the run; larger ones
+    // leave everything for the end
+    const std::string all = std::to_string(n_points + 1);
+    const std::string part = std::to_string(std::min<std::size_t>(std::max<std::size_t>(n_points/10, 1), 1000));
+    std::vector<std::pair<std::string,YAML::Node>> modes;
+    modes.emplace_back("gathered", YAML::Load("{buffer_length: " + all + "}"));
+    modes.emplace_back("collective_output", YAML::Load("{buffer_length: " + all + ", collective_output: true}"));
+    modes.emplace_back("lock-based", YAML::Load("{buffer_length: " + part + "}"));
+    modes.emplace_back("aggregate_output", YAML::Load("{buffer_length: " + part + ", aggregate_output: true}"));
+
+    if (rank == 0)
+    {
+      std::cout << "HDF5Printer2 MPI output, " << size << " processes, " << n_points << " points per process, "
+                << n_datasets << " datasets (output in " << dir << ")" << std::endl;
+      if (not HDF5MasterBuffer::collective_writes_available())
+        std::cout << "Note: no parallel HDF5, so collective_output gathers the output on rank 0" << std::endl;
+      std::cout << std::setw(20) << "output" << std::setw(12) << "pt/s" << std::setw(12) << "points" << std::setw(20) << "matches gathered" << std::endl;
+    }
+
+    bool ok = true;
+    point_values gathered;
+    for (const auto& mode : modes)
+    {
+      const std::string mode_dir = dir + "/" + mode.first;
+      if (rank == 0) Utils::ensure_path_exists(mode_dir + "/");
+      comm.Barrier();
+      auto start = std::chrono::steady_clock::now();
+      run(mode_dir, n_datasets, n_points, true, mode.second, false, rank);
+      comm.Barrier();
+      auto end = std::chrono::steady_clock::now();
+      if (rank != 0) continue;
+
+      const point_values points = read_points(mode_dir + "/" + file_name, n_datasets);
+      if (gathered.empty()) gathered = points;
+      const bool complete = (points.size() == n_points*size);
+      const bool matches = complete and points == gathered;
+      ok = ok and matches;
+      std::cout << std::setw(20) << mode.first << std::fixed << std::setprecision(0)
+                << std::setw(12) << n_points*size / std::chrono::duration<double>(end - start).count()
+                << std::setw(12) << points.size() << std::setw(20) << (matches ? "yes" : "NO (FAILED)") << std::endl;
+    }
+
+    int result = (ok ? EXIT_SUCCESS : EXIT_FAILURE);
+    comm.Bcast_single(result, 0);
+    return result;
+  }
+#endif
+}
+
+int main(int argc, char* argv[])
+{
+  #ifdef WITH_MPI
+    GMPI::Init();
+  #endif
+
+  const std::size_t prints = (argc > 1 ? std::atol(argv[1]) : 5000000);
+  const std::string dir = (argc > 2 ? argv[2] : Utils::runtime_scratch() + "benchmark_hdf5printer_v2");
+  Utils::ensure_path_exists(dir + "/");
+
+  int result;
+  #ifdef WITH_MPI
+    result = (GMPI::Comm().Get_size() > 1 ? mpi_benchmarks(prints, dir) : serial_benchmarks(prints, dir));
+    GMPI::Finalize();
+  #else
+    result = serial_benchmarks(prints, dir);
+  #endif
+  return result;
+}
@@ -0,0 +1,153 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Stand-alone benchmark of SQLitePrinter
+///  throughput: prints every dataset at every
+///  point, as a scan does, plus one value per
+///  point to an auxiliary stream, and reports
+///  points per second (including the final
+///  flush) for 50 and 500 datasets. Compares
+///  buffer_length 1 and 100, the SQLite default
+///  journal mode and synchronous setting with WAL
+///  and synchronous NORMAL, and UPSERT with the
+///  UPDATE fallback used with SQLite libraries
+///  older than 3.24. The number of auxiliary
+///  values found in the table afterwards is
+///  reported as a check.
+///
+///  usage: benchmark_sqliteprinter [prints per run] [output directory]
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sqlite3.h>
+
+#include "gambit/Printers/printers/sqliteprinter.hpp"
+#include "gambit/Utils/util_functions.hpp"
+
+// Annoying other things we need due to mostly unwanted dependencies
+#include "gambit/Utils/static_members.hpp"
+
+using namespace Gambit;
+using namespace Printers;
+
+namespace
+{
+  const std::string file_name = "benchmark.sql";
+
+  /// Printer settings compared
+  struct Settings
+  {
+    std::size_t buffer_length;
+    bool wal;
+    bool upsert;
+  };
+
+  /// Print n_points points of n_datasets doubles each to a new file, returning the points per second
+  double run(const std::string& dir, const std::size_t n_datasets, const std::size_t n_points, const Settings& settings)
+  {
+    YAML::Node node;
+    node["output_path"] = dir;
+    node["output_file"] = file_name;
+    node["resume"] = false;
+    node["delete_file_on_restart"] = true;
+    node["buffer_length"] = settings.buffer_length;
+    node["upsert"] = settings.upsert;
+    if (settings.wal)
+    {
+      node["journal_mode"] = "WAL";
+      node["synchronous"] = "NORMAL";
+    }
+    Options options(node);
+    YAML::Node aux_node;
+    aux_node["auxilliary"] = true;
+    aux_node["name"] = "aux";
+    Options aux_options(aux_node);
+
+    std::vector<std::string> labels;
+    for (std::size_t d = 0; d < n_datasets; ++d)
+    {
+      std::ostringstream label;
+      label << "dataset_" << d;
+      labels.push_back(label.str());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+      SQLitePrinter printer(options);
+      SQLitePrinter aux(aux_options, &printer);
+      for (std::size_t p = 0; p < n_points; ++p)
+      {
+        printer.print((int)0, "MPIrank", 0, p);
+        printer.print((ulong)p, "pointID", 0, p);
+        for (std::size_t d = 0; d < n_datasets; ++d) printer.print(p + 1e-3*d, labels[d], d, 0, p);
+        aux.print(-1.0*p, "aux_value", n_datasets, 0, p);
+      }
+      printer.finalise();
+      aux.finalise();
+    }
+    auto end = std::chrono::steady_clock::now();
+    return n_points / std::chrono::duration<double>(end - start).count();
+  }
+
+  /// Number of rows of the table with an auxiliary value
+  long count_aux_values(const std::string& path)
+  {
+    sqlite3* db = NULL;
+    sqlite3_stmt* stmt = NULL;
+    long n = -1;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, NULL) == SQLITE_OK and
+        sqlite3_prepare_v2(db, "SELECT count(aux_value) FROM results;", -1, &stmt, NULL) == SQLITE_OK and
+        sqlite3_step(stmt) == SQLITE_ROW)
+    {
+      n = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return n;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const std::size_t prints = (argc > 1 ? std::atol(argv[1]) : 500000);
+  const std::string dir = (argc > 2 ? argv[2] : Utils::runtime_scratch() + "benchmark_sqliteprinter");
+  Utils::ensure_path_exists(dir + "/");
+
+  // The UPDATE fallback writes each point as soon as it is complete, so it is only run with buffer_length 1
+  const std::vector<Settings> all_settings = {{1, false, true}, {100, false, true}, {1, false, false},
+                                              {1, true, true}, {100, true, true}, {1, true, false}};
+
+  std::cout << "SQLitePrinter throughput, " << prints << " prints per run, SQLite " << sqlite3_libversion() << " (output in " << dir << ")" << std::endl
+            << std::setw(10) << "datasets" << std::setw(10) << "points" << std::setw(15) << "buffer_length"
+            << std::setw(16) << "journal" << std::setw(10) << "write" << std::setw(12) << "pt/s" << std::setw(12) << "aux rows" << std::endl;
+
+  for (std::size_t n_datasets : {50, 500})
+  {
+    const std::size_t n_points = std::max<std::size_t>(prints/n_datasets, 1);
+    for (const Settings& settings : all_settings)
+    {
+      const double rate = run(dir, n_datasets, n_points, settings);
+      std::cout << std::setw(10) << n_datasets << std::setw(10) << n_points << std::setw(15) << settings.buffer_length
+                << std::setw(16) << (settings.wal ? "WAL/NORMAL" : "defaults") << std::setw(10) << (settings.upsert ? "UPSERT" : "UPDATE")
+                << std::fixed << std::setprecision(0) << std::setw(12) << rate << std::setw(12) << count_aux_values(dir + "/" + file_name) << std::endl;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
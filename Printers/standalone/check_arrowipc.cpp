@@ -0,0 +1,432 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Stand-alone round-trip check of the Arrow
+///  IPC stream writer and reader (arrowipc.hpp)
+///  and of ArrowReader. A stream with a column of
+///  every Arrow::Type, with and without nulls,
+///  an empty batch and schema metadata is written
+///  with StreamWriter and read back with
+///  StreamReader, also after truncating it at
+///  every byte. The merge of the output of two
+///  ranks and an auxiliary stream by ArrowReader
+///  is checked as well. If pyarrow can be
+///  imported, it reads the stream too. Exits with
+///  a non-zero status if anything differs.
+///
+///  usage: check_arrowipc [output directory]
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gambit/Printers/printers/arrowipc.hpp"
+#include "gambit/Printers/printers/arrowreader.hpp"
+#include "gambit/Utils/util_functions.hpp"
+
+// Annoying other things we need due to mostly unwanted dependencies
+#include "gambit/Utils/static_members.hpp"
+
+using namespace Gambit;
+using namespace Printers;
+
+namespace
+{
+  /// Lengths of the batches of the stream (one empty, and most not a multiple of 8)
+  const std::vector<std::size_t> batch_lengths = {5, 0, 13, 8, 1};
+
+  const std::map<std::string,std::string> stream_metadata = {{"creator", "check_arrowipc"}, {"empty", ""}};
+
+  const std::vector<Arrow::Type> all_types = {Arrow::Type::Bool, Arrow::Type::Int32, Arrow::Type::UInt32, Arrow::Type::Int64,
+                                              Arrow::Type::UInt64, Arrow::Type::Float32, Arrow::Type::Float64};
+
+  /// The stream has two columns of each type: one without nulls, and one with nulls at every fourth row
+  std::vector<Arrow::Field> stream_schema()
+  {
+    std::vector<Arrow::Field> schema;
+    for (Arrow::Type t : all_types)
+    {
+      schema.push_back(Arrow::Field{Arrow::type_name(t), t});
+      schema.push_back(Arrow::Field{Arrow::type_name(t) + "_nulls", t});
+    }
+    return schema;
+  }
+
+  bool is_null(std::size_t column, std::size_t row) { return column%2 == 1 and row%4 == 1; }
+
+  /// The value in a row (counted over all batches) of a column of type t, converted to T. The values
+  /// use the high bits of the unsigned types and the sign of the signed ones.
+  template<class T>
+  T value(Arrow::Type t, std::size_t row)
+  {
+    const long long i = row;
+    switch (t)
+    {
+      case Arrow::Type::Bool:    return T(i%3 == 0);
+      case Arrow::Type::Int32:   return T(int(7*i - 50));
+      case Arrow::Type::UInt32:  return T((unsigned int)(4000000000u - 3*i));
+      case Arrow::Type::Int64:   return T(-i*(1LL << 40) - 1);
+      case Arrow::Type::UInt64:  return T((1ULL << 63) + i);
+      case Arrow::Type::Float32: return T(0.5f*i - 1.25f);
+      default:                   return T(1.0/(i + 1));
+    }
+  }
+
+  /// Store the value of a row in a column of a record batch
+  template<class T>
+  void store(Arrow::Column& col, std::size_t i, T x)
+  {
+    std::memcpy(&col.values[i*sizeof(T)], &x, sizeof(T));
+  }
+
+  void write_stream(const std::string& path)
+  {
+    const std::vector<Arrow::Field> schema = stream_schema();
+    Arrow::StreamWriter writer(path, schema, stream_metadata);
+    std::size_t row = 0;
+    for (std::size_t length : batch_lengths)
+    {
+      Arrow::RecordBatch batch;
+      batch.length = length;
+      batch.columns.resize(schema.size());
+      for (std::size_t c = 0; c < schema.size(); ++c)
+      {
+        Arrow::Column& col = batch.columns[c];
+        const Arrow::Type t = schema[c].type;
+        col.values.assign(length*Arrow::type_size(t), 0);
+        col.valid.assign(length, 1);
+        for (std::size_t i = 0; i < length; ++i)
+        {
+          if (is_null(c, row + i))
+          {
+            col.valid[i] = 0;
+            continue;
+          }
+          switch (t)
+          {
+            case Arrow::Type::Bool:    col.values[i] = value<bool>(t, row + i); break;
+            case Arrow::Type::Int32:   store(col, i, value<int>(t, row + i)); break;
+            case Arrow::Type::UInt32:  store(col, i, value<unsigned int>(t, row + i)); break;
+            case Arrow::Type::Int64:   store(col, i, value<long long>(t, row + i)); break;
+            case Arrow::Type::UInt64:  store(col, i, value<unsigned long long>(t, row + i)); break;
+            case Arrow::Type::Float32: store(col, i, value<float>(t, row + i)); break;
+            case Arrow::Type::Float64: store(col, i, value<double>(t, row + i)); break;
+          }
+        }
+      }
+      writer.write(batch);
+      row += length;
+    }
+    writer.close();
+  }
+
+  /// Whether a value read back is the one that was written
+  bool matches(const Arrow::StreamReader& reader, std::size_t b, std::size_t c, std::size_t i, std::size_t row)
+  {
+    const Arrow::Type t = reader.get_schema()[c].type;
+    switch (t)
+    {
+      case Arrow::Type::Bool:    return reader.value<bool>(b, c, i) == value<bool>(t, row);
+      case Arrow::Type::Int32:   return reader.value<int>(b, c, i) == value<int>(t, row);
+      case Arrow::Type::UInt32:  return reader.value<unsigned int>(b, c, i) == value<unsigned int>(t, row);
+      case Arrow::Type::Int64:   return reader.value<long long>(b, c, i) == value<long long>(t, row);
+      case Arrow::Type::UInt64:  return reader.value<unsigned long long>(b, c, i) == value<unsigned long long>(t, row);
+      case Arrow::Type::Float32: return reader.value<float>(b, c, i) == value<float>(t, row);
+      default:                   return reader.value<double>(b, c, i) == value<double>(t, row);
+    }
+  }
+
+  /// Compare the batches of a stream with the ones written; returns the number of differences
+  std::size_t compare_batches(const Arrow::StreamReader& reader, std::size_t& errors)
+  {
+    std::size_t row = 0;
+    if (reader.num_batches() > batch_lengths.size() and errors++ < 10)
+      std::cout << "  " << reader.num_batches() << " batches read, but " << batch_lengths.size() << " written" << std::endl;
+    for (std::size_t b = 0; b < reader.num_batches() and b < batch_lengths.size(); ++b)
+    {
+      if (reader.batch_length(b) != batch_lengths[b])
+      {
+        if (errors++ < 10) std::cout << "  batch " << b << " has " << reader.batch_length(b) << " rows, not " << batch_lengths[b] << std::endl;
+        return errors;
+      }
+      for (std::size_t c = 0; c < reader.get_schema().size(); ++c)
+      {
+        for (std::size_t i = 0; i < batch_lengths[b]; ++i)
+        {
+          const bool valid = reader.is_valid(b, c, i);
+          if (valid == is_null(c, row + i) or (valid and not matches(reader, b, c, i, row + i)))
+          {
+            if (errors++ < 10) std::cout << "  wrong value in row " << row + i << " of column '" << reader.get_schema()[c].name << "'" << std::endl;
+          }
+        }
+      }
+      row += batch_lengths[b];
+    }
+    return errors;
+  }
+
+  /// Write the stream, and read it back
+  bool check_round_trip(const std::string& path)
+  {
+    write_stream(path);
+    std::size_t errors = 0;
+    Arrow::StreamReader reader(path);
+
+    const std::vector<Arrow::Field> schema = stream_schema();
+    bool schema_ok = reader.get_schema().size() == schema.size();
+    for (std::size_t c = 0; schema_ok and c < schema.size(); ++c)
+      schema_ok = (reader.get_schema()[c].name == schema[c].name and reader.get_schema()[c].type == schema[c].type);
+    if (not schema_ok and errors++ < 10) std::cout << "  the schema differs" << std::endl;
+    if (reader.get_metadata() != stream_metadata and errors++ < 10) std::cout << "  the schema metadata differs" << std::endl;
+    if (not reader.is_complete() and errors++ < 10) std::cout << "  the stream is not complete" << std::endl;
+    if (reader.num_batches() != batch_lengths.size() and errors++ < 10) std::cout << "  " << reader.num_batches() << " batches read" << std::endl;
+    if (schema_ok) compare_batches(reader, errors);
+
+    std::cout << (errors == 0 ? "passed: " : "FAILED: ") << "write and read every type" << std::endl;
+    return errors == 0;
+  }
+
+  /// Read the stream truncated at every byte: the complete batches must still be read, and nothing else
+  bool check_truncated(const std::string& path, const std::string& dir)
+  {
+    std::ifstream in(path, std::ios::binary);
+    const std::vector<char> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    const std::string truncated = dir + "/truncated.arrows";
+    std::size_t errors = 0, previous_batches = 0;
+    for (std::size_t size = 0; size < data.size(); ++size)
+    {
+      std::ofstream(truncated, std::ios::binary | std::ios::trunc).write(data.data(), size);
+      Arrow::StreamReader reader(truncated);
+      if (reader.is_complete() and errors++ < 10) std::cout << "  stream truncated to " << size << " bytes is complete" << std::endl;
+      if (reader.num_batches() < previous_batches and errors++ < 10) std::cout << "  stream truncated to " << size << " bytes has fewer batches than a shorter one" << std::endl;
+      previous_batches = reader.num_batches();
+      if (not reader.get_schema().empty()) compare_batches(reader, errors);
+    }
+    // Only the end-of-stream marker is missing
+    if (previous_batches != batch_lengths.size() and errors++ < 10) std::cout << "  stream without end-of-stream marker has " << previous_batches << " batches" << std::endl;
+
+    std::cout << (errors == 0 ? "passed: " : "FAILED: ") << "read truncated streams (" << data.size() << " sizes)" << std::endl;
+    return errors == 0;
+  }
+
+  /// A row of a data file written by the arrow printer: the rank and pointID, and a value (or none) for
+  /// some of the other columns
+  struct Row
+  {
+    int rank;
+    unsigned long long pointID;
+    std::map<std::string,double> values;
+  };
+
+  /// Write a data file in the layout of the arrow printer, with the given columns after MPIrank and pointID
+  void write_data_file(const std::string& path, const std::vector<Arrow::Field>& fields, const std::vector<Row>& rows)
+  {
+    std::vector<Arrow::Field> schema = {Arrow::Field{"MPIrank", Arrow::Type::Int32}, Arrow::Field{"pointID", Arrow::Type::UInt64}};
+    schema.insert(schema.end(), fields.begin(), fields.end());
+    Arrow::StreamWriter writer(path, schema);
+
+    // Two rows per batch, so that the points of a file are spread over several batches
+    for (std::size_t first = 0; first < rows.size(); first += 2)
+    {
+      const std::size_t n = std::min<std::size_t>(2, rows.size() - first);
+      Arrow::RecordBatch batch;
+      batch.length = n;
+      batch.columns.resize(schema.size());
+      for (std::size_t c = 0; c < schema.size(); ++c)
+      {
+        Arrow::Column& col = batch.columns[c];
+        col.values.assign(n*Arrow::type_size(schema[c].type), 0);
+        col.valid.assign(n, 0);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+          const Row& row = rows[first + i];
+          auto it = row.values.find(schema[c].name);
+          col.valid[i] = (c < 2 or it != row.values.end());
+          if (not col.valid[i]) continue;
+          if (c == 0) store(col, i, row.rank);
+          else if (c == 1) store(col, i, row.pointID);
+          else if (schema[c].type == Arrow::Type::Bool) col.values[i] = (it->second != 0);
+          else if (schema[c].type == Arrow::Type::Int32) store(col, i, (int)it->second);
+          else if (schema[c].type == Arrow::Type::Float32) store(col, i, (float)it->second);
+          else store(col, i, it->second);
+        }
+      }
+      writer.write(batch);
+    }
+    writer.close();
+  }
+
+  /// Merge the primary output of two ranks with an auxiliary stream, and a stale generation of the primary stream
+  bool check_merge(const std::string& dir)
+  {
+    const std::vector<Arrow::Field> primary = {Arrow::Field{"x", Arrow::Type::Float64}, Arrow::Field{"n", Arrow::Type::Int32}};
+    const std::vector<Arrow::Field> aux = {Arrow::Field{"x", Arrow::Type::Float64}, Arrow::Field{"y", Arrow::Type::Float32}, Arrow::Field{"flag", Arrow::Type::Bool}};
+
+    // Rank 0 prints points 0-11 to two files; x is missing at every third point
+    std::vector<Row> rank0_a, rank0_b, rank1, stale, aux0, aux1;
+    for (unsigned long long p = 0; p < 12; ++p)
+    {
+      Row row{0, p, {{"n", 100. + p}}};
+      if (p%3 != 0) row.values["x"] = p + 0.5;
+      (p < 10 ? rank0_a : rank0_b).push_back(row);
+    }
+    // Rank 1 prints points 0-5, without n at point 2
+    for (unsigned long long p = 0; p < 6; ++p)
+    {
+      Row row{1, p, {{"x", 1000. + p}}};
+      if (p != 2) row.values["n"] = 200. + p;
+      rank1.push_back(row);
+    }
+    // A reset (earlier generation) of the primary stream, which must be ignored
+    stale.push_back(Row{0, 50, {{"x", -1.}, {"n", -1.}}});
+    // The auxiliary stream fills in x at point 3 of rank 0 (and does not remove it at point 4),
+    // replaces it at point 1 of rank 1, and adds a point that is not in the primary stream
+    aux0.push_back(Row{0, 3, {{"x", -3.5}, {"y", 6.}, {"flag", 1.}}});
+    aux0.push_back(Row{0, 4, {{"y", 8.}, {"flag", 0.}}});
+    aux0.push_back(Row{0, 20, {{"x", 20.5}, {"y", 40.}}});
+    aux1.push_back(Row{1, 1, {{"x", 2.25}, {"y", 7.}, {"flag", 1.}}});
+
+    Utils::remove_all_files_in(dir + "/", false);
+    write_data_file(dir + "/primary_rank0_g0_0.arrows", primary, stale);
+    write_data_file(dir + "/primary_rank0_g1_0.arrows", primary, rank0_a);
+    write_data_file(dir + "/primary_rank0_g1_1.arrows", primary, rank0_b);
+    write_data_file(dir + "/primary_rank1_g1_0.arrows", primary, rank1);
+    write_data_file(dir + "/aux_rank0_g0_0.arrows", aux, aux0);
+    write_data_file(dir + "/aux_rank1_g0_0.arrows", aux, aux1);
+
+    // Expected result: the points in the order of the primary output, then the new auxiliary ones,
+    // and the last valid value printed for each point
+    std::vector<PPIDpair> expected_points;
+    std::map<PPIDpair,std::map<std::string,double>> expected;
+    for (const auto* rows : {&rank0_a, &rank0_b, &rank1, &aux0, &aux1})
+    {
+      for (const Row& row : *rows)
+      {
+        const PPIDpair ppid(row.pointID, row.rank);
+        if (expected.find(ppid) == expected.end()) expected_points.push_back(ppid);
+        for (const auto& v : row.values) expected[ppid][v.first] = v.second;
+      }
+    }
+
+    YAML::Node node;
+    node["file"] = dir;
+    ArrowReader reader((Options(node)));
+    std::size_t errors = 0;
+
+    const std::set<std::string> labels = {"MPIrank", "pointID", "x", "n", "y", "flag"};
+    if (reader.get_all_labels() != labels and errors++ < 10) std::cout << "  wrong labels" << std::endl;
+    if ((reader.get_type("n") != getTypeID<int>() or reader.get_type("y") != getTypeID<float>() or reader.get_type("flag") != getTypeID<bool>()) and errors++ < 10)
+      std::cout << "  wrong types" << std::endl;
+    if (reader.get_dataset_length() != expected_points.size() and errors++ < 10)
+      std::cout << "  " << reader.get_dataset_length() << " points read, but " << expected_points.size() << " expected" << std::endl;
+
+    std::size_t i = 0;
+    for (PPIDpair pt = reader.get_current_point(); not reader.eoi(); pt = reader.get_next_point(), ++i)
+    {
+      if (i >= expected_points.size() or not (pt == expected_points[i]))
+      {
+        if (errors++ < 10) std::cout << "  point " << i << " is (" << pt.rank << ", " << pt.pointID << ")" << std::endl;
+        continue;
+      }
+      const std::map<std::string,double>& values = expected.at(pt);
+      for (const std::string label : {"x", "n", "y", "flag"})
+      {
+        double x = 0;
+        bool valid;
+        if (label == "n") { int n; valid = reader.retrieve(n, label, pt.rank, pt.pointID); x = n; }
+        else if (label == "y") { float y; valid = reader.retrieve(y, label, pt.rank, pt.pointID); x = y; }
+        else if (label == "flag") { bool b; valid = reader.retrieve(b, label, pt.rank, pt.pointID); x = b; }
+        else valid = reader.retrieve(x, label, pt.rank, pt.pointID);
+        auto it = values.find(label);
+        if (valid != (it != values.end()) or (valid and x != it->second))
+        {
+          if (errors++ < 10) std::cout << "  point (" << pt.rank << ", " << pt.pointID << "): " << label << " = " << (valid ? std::to_string(x) : "invalid") << std::endl;
+        }
+      }
+      ulong pointID;
+      int rank;
+      if ((not reader.retrieve(pointID, "pointID", pt.rank, pt.pointID) or pointID != pt.pointID or
+           not reader.retrieve(rank, "MPIrank", pt.rank, pt.pointID) or rank != (int)pt.rank) and errors++ < 10)
+        std::cout << "  point (" << pt.rank << ", " << pt.pointID << "): wrong MPIrank or pointID" << std::endl;
+    }
+
+    std::cout << (errors == 0 ? "passed: " : "FAILED: ") << "merge two ranks and an auxiliary stream (" << expected_points.size() << " points)" << std::endl;
+    return errors == 0;
+  }
+
+  /// Read the stream with pyarrow, if it is available
+  bool check_pyarrow(const std::string& path, const std::string& dir)
+  {
+    if (std::system("python3 -c 'import pyarrow' > /dev/null 2>&1") != 0)
+    {
+      std::cout << "skipped: read with pyarrow (pyarrow cannot be imported)" << std::endl;
+      return true;
+    }
+    const std::string script = dir + "/check_pyarrow.py";
+    std::ofstream out(script);
+    out << "import sys\n"
+           "import pyarrow as pa, pyarrow.ipc as ipc\n"
+           "types = [('bool', pa.bool_()), ('int32', pa.int32()), ('uint32', pa.uint32()), ('int64', pa.int64()),\n"
+           "         ('uint64', pa.uint64()), ('float', pa.float32()), ('double', pa.float64())]\n"
+           "def value(name, i):\n"
+           "    return {'bool': i%3 == 0, 'int32': 7*i - 50, 'uint32': 4000000000 - 3*i, 'int64': -i*2**40 - 1,\n"
+           "            'uint64': 2**63 + i, 'float': 0.5*i - 1.25, 'double': 1.0/(i + 1)}[name]\n"
+           "reader = ipc.open_stream(sys.argv[1])\n"
+           "batches = list(reader)\n"
+           "errors = []\n"
+           "meta = {k.decode(): v.decode() for k, v in (reader.schema.metadata or {}).items()}\n"
+           "if meta != {";
+    for (const auto& kv : stream_metadata) out << "'" << kv.first << "': '" << kv.second << "', ";
+    out << "}: errors.append('metadata ' + str(meta))\n"
+           "if [b.num_rows for b in batches] != [";
+    for (std::size_t length : batch_lengths) out << length << ", ";
+    out << "]: errors.append('batch lengths')\n"
+           "table = pa.Table.from_batches(batches, reader.schema)\n"
+           "for c, (name, t) in enumerate([(n + s, t) for n, t in types for s in ('', '_nulls')]):\n"
+           "    if reader.schema.field(c).name != name or reader.schema.field(c).type != t: errors.append('field ' + name)\n"
+           "    for i, v in enumerate(table.column(c).to_pylist()):\n"
+           "        expected = None if (c%2 == 1 and i%4 == 1) else value(name.split('_')[0], i)\n"
+           "        if v != expected: errors.append('%s row %d: %s, not %s' % (name, i, v, expected))\n"
+           "for e in errors[:10]: print('  ' + e)\n"
+           "sys.exit(1 if errors else 0)\n";
+    out.close();
+    const bool ok = (std::system(("python3 " + script + " " + path).c_str()) == 0);
+    std::cout << (ok ? "passed: " : "FAILED: ") << "read with pyarrow" << std::endl;
+    return ok;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const std::string dir = (argc > 1 ? argv[1] : Utils::runtime_scratch() + "check_arrowipc");
+  Utils::ensure_path_exists(dir + "/");
+  Utils::ensure_path_exists(dir + "/merge/");
+  const std::string path = dir + "/types.arrows";
+  bool ok = true;
+
+  ok &= check_round_trip(path);
+  ok &= check_truncated(path, dir);
+  ok &= check_merge(dir + "/merge");
+  ok &= check_pyarrow(path, dir);
+
+  std::cout << (ok ? "passed" : "FAILED") << std::endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
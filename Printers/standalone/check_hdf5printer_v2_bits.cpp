@@ -0,0 +1,197 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Stand-alone round-trip check of the
+///  'validity_format: bits' option of
+///  HDF5Printer2. Points with partly invalid
+///  data are written with packed validity flags,
+///  resumed into, combined with another run by
+///  hdf5_combine_tools, and copied point by point
+///  into a new file through HDF5Reader (as the
+///  postprocessor does). Every file is read back
+///  with HDF5Reader and compared with what was
+///  printed. Exits with a non-zero status if
+///  anything differs.
+///
+///  usage: check_hdf5printer_v2_bits [output directory]
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gambit/Printers/printers/hdf5printer_v2.hpp"
+#include "gambit/Printers/printers/hdf5reader.hpp"
+#include "gambit/Printers/printers/hdf5printer/hdf5_combine_tools.hpp"
+#include "gambit/Utils/util_functions.hpp"
+
+// Annoying other things we need due to mostly unwanted dependencies
+#include "gambit/Utils/static_members.hpp"
+
+using namespace Gambit;
+using namespace Printers;
+
+namespace
+{
+  /// Points per run: not a multiple of 8 or of the buffer length, so that the
+  /// packed flags of every flush end part way through a byte
+  const ulong n_points = 251;
+
+  /// The data printed at each point. Each dataset is left invalid at a different
+  /// pattern of points, so that the flags of neighbouring points differ.
+  bool x_valid(ulong p) { return p%3 != 0; }
+  bool n_valid(ulong p) { return p%8 != 5 and p%7 != 0; }
+  double x_value(ulong p) { return 0.25*p - 3.0; }
+  int n_value(ulong p) { return 1000 - int(p); }
+
+  /// Options of a printer writing to dir/file with packed validity flags
+  Options printer_options(const std::string& dir, const std::string& file, const bool resume)
+  {
+    YAML::Node node;
+    node["output_path"] = dir;
+    node["output_file"] = file;
+    node["group"] = "/data";
+    node["resume"] = resume;
+    node["delete_file_on_restart"] = not resume;
+    node["buffer_length"] = 16;
+    node["validity_format"] = "bits";
+    return Options(node);
+  }
+
+  /// Options of a reader of dir/file
+  Options reader_options(const std::string& path)
+  {
+    YAML::Node node;
+    node["file"] = path;
+    node["group"] = "/data";
+    return Options(node);
+  }
+
+  /// Print the points [first, first+n_points) with the pattern above
+  void write_run(const std::string& dir, const std::string& file, const ulong first, const bool resume)
+  {
+    HDF5Printer2 printer(printer_options(dir, file, resume));
+    for (ulong p = first; p < first + n_points; ++p)
+    {
+      printer.print((int)0, "MPIrank", 0, p);
+      printer.print(p, "pointID", 0, p);
+      if (x_valid(p)) printer.print(x_value(p), "x", 1, 0, p);
+      if (n_valid(p)) printer.print(n_value(p), "n", 2, 0, p);
+    }
+    printer.finalise();
+  }
+
+  /// Copy every point of a file into a new one through HDF5Reader, as the postprocessor does
+  void copy_run(const std::string& in, const std::string& dir, const std::string& file)
+  {
+    HDF5Reader reader(reader_options(in));
+    HDF5Printer2 printer(printer_options(dir, file, false));
+    for (PPIDpair pt = reader.get_current_point(); not reader.eoi(); pt = reader.get_next_point())
+    {
+      double x;
+      int n;
+      printer.print((int)pt.rank, "MPIrank", 0, pt.pointID);
+      printer.print(pt.pointID, "pointID", 0, pt.pointID);
+      if (reader.retrieve(x, "x", pt.rank, pt.pointID)) printer.print(x, "x", 1, 0, pt.pointID);
+      if (reader.retrieve(n, "n", pt.rank, pt.pointID)) printer.print(n, "n", 2, 0, pt.pointID);
+    }
+    printer.finalise();
+  }
+
+  /// Check that the validity flags of a dataset are stored with one bit per point
+  bool check_packed(const std::string& path, const std::string& name)
+  {
+    hid_t file_id = H5Fopen(path.c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    hid_t dset_id = H5Dopen2(file_id, ("/data/" + name + "_isvalid").c_str(), H5P_DEFAULT);
+    hid_t type_id = H5Dget_type(dset_id);
+    hid_t dcpl_id = H5Dget_create_plist(dset_id);
+    bool nbit = false;
+    for (int i = 0; i < H5Pget_nfilters(dcpl_id); ++i)
+    {
+      unsigned int flags;
+      std::size_t n_values = 0;
+      if (H5Pget_filter2(dcpl_id, i, &flags, &n_values, NULL, 0, NULL, NULL) == H5Z_FILTER_NBIT) nbit = true;
+    }
+    const bool packed = (nbit and H5Tget_precision(type_id) == 1);
+    H5Pclose(dcpl_id);
+    H5Tclose(type_id);
+    H5Dclose(dset_id);
+    H5Fclose(file_id);
+    if (not packed) std::cout << path << ": " << name << "_isvalid is not stored with one bit per point  FAILED" << std::endl;
+    return packed;
+  }
+
+  /// Read a file back and compare it with the points [0, n) that were printed into it
+  bool check_contents(const std::string& what, const std::string& path, const ulong n)
+  {
+    HDF5Reader reader(reader_options(path));
+    std::vector<bool> seen(n, false);
+    std::size_t errors = 0;
+    for (PPIDpair pt = reader.get_current_point(); not reader.eoi(); pt = reader.get_next_point())
+    {
+      const ulong p = pt.pointID;
+      if (pt.rank != 0 or p >= n or seen[p])
+      {
+        if (errors++ < 10) std::cout << "  unexpected point (rank " << pt.rank << ", pointID " << p << ")" << std::endl;
+        continue;
+      }
+      seen[p] = true;
+
+      double x;
+      int n_read;
+      const bool x_ok = reader.retrieve(x, "x", pt.rank, p);
+      const bool n_ok = reader.retrieve(n_read, "n", pt.rank, p);
+      if (x_ok != x_valid(p) or (x_ok and x != x_value(p)) or n_ok != n_valid(p) or (n_ok and n_read != n_value(p)))
+      {
+        if (errors++ < 10)
+          std::cout << "  point " << p << ": read x = " << (x_ok ? std::to_string(x) : "invalid")
+                    << ", n = " << (n_ok ? std::to_string(n_read) : "invalid") << std::endl;
+      }
+    }
+    for (ulong p = 0; p < n; ++p)
+      if (not seen[p] and errors++ < 10) std::cout << "  point " << p << " is missing" << std::endl;
+
+    std::cout << (errors == 0 ? "passed: " : "FAILED: ") << what << " (" << n << " points)" << std::endl;
+    return errors == 0;
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  const std::string dir = (argc > 1 ? argv[1] : Utils::runtime_scratch() + "check_hdf5printer_v2_bits");
+  Utils::ensure_path_exists(dir + "/");
+  bool ok = true;
+
+  // A new file, then resumed with the next points
+  write_run(dir, "run1.hdf5", 0, false);
+  ok &= check_packed(dir + "/run1.hdf5", "x") and check_packed(dir + "/run1.hdf5", "n");
+  ok &= check_contents("write", dir + "/run1.hdf5", n_points);
+  write_run(dir, "run1.hdf5", n_points, true);
+  ok &= check_packed(dir + "/run1.hdf5", "x");
+  ok &= check_contents("resume", dir + "/run1.hdf5", 2*n_points);
+
+  // Combined with a second run
+  write_run(dir, "run2.hdf5", 2*n_points, false);
+  const std::vector<std::string> inputs = {dir + "/run1.hdf5", dir + "/run2.hdf5"};
+  HDF5::combine_hdf5_files(dir + "/combined.hdf5", "", "/data", "/metadata", inputs.size(), false, false, false, inputs);
+  ok &= check_contents("combine", dir + "/combined.hdf5", 3*n_points);
+
+  // Postprocessed into a new file
+  copy_run(dir + "/combined.hdf5", dir, "postprocessed.hdf5");
+  ok &= check_packed(dir + "/postprocessed.hdf5", "n");
+  ok &= check_contents("postprocess", dir + "/postprocessed.hdf5", 3*n_points);
+
+  std::cout << (ok ? "passed" : "FAILED") << std::endl;
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -31,12 +31,15 @@
 #include <vector>
 
 #include "gambit/ScannerBit/scanner_utils.hpp"
+#include "gambit/ScannerBit/prior_plan.hpp"
 
 namespace Gambit {
 
     namespace Priors {
 
         using ::Gambit::Scanner::hyper_cube_ref;
+        using ::Gambit::Scanner::hyper_cube_batch_ref;
+        using ::Gambit::Scanner::hyper_cube_batch_cref;
         using ::Gambit::Scanner::map_vector;
 
         /**
@@ -80,6 +83,41 @@ namespace Gambit {
                 return physical;
             }
 
+            /**
+            * @brief Transform a population from unit hypercube to physical parameters
+            *
+            * Each row of unit is one point; the matching row of physical receives its physical parameters,
+            * one column per entry of getShownParameters().  The default goes through transform() point by point.
+            */
+            virtual void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const
+            {
+                const std::vector<std::string> names = getShownParameters();
+                Scanner::vector<double> point(unit.cols());
+                std::unordered_map<std::string, double> map;
+
+                for (int j = 0, end = unit.rows(); j < end; ++j)
+                {
+                    point = unit.row(j).transpose();
+                    transform(point, map);
+                    for (int i = 0, n = names.size(); i < n; ++i)
+                        physical(j, i) = map.at(names[i]);
+                }
+            }
+
+            /** @overload return Eigen matrix */
+            Scanner::matrix<double> transform_batch(hyper_cube_batch_cref<double> unit) const
+            {
+                Scanner::matrix<double> physical(unit.rows(), getShownParameters().size());
+                transform_batch(unit, physical);
+                return physical;
+            }
+
+            /** @brief Transform one point straight to the shown parameters (in the order of getShownParameters()), without a map */
+            void transform_to_vec(hyper_cube_ref<double> unit, hyper_cube_ref<double> physical) const
+            {
+                transform_batch(unit.transpose(), physical.transpose());
+            }
+
             /** @brief Transform from physical parameter to unit hypercube */
             virtual void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const = 0;
 
@@ -100,6 +138,13 @@ namespace Gambit {
             /** @brief Log of prior density */
             virtual double log_prior_density(const std::unordered_map<std::string, double> &) const = 0;
 
+            /**
+            * @brief Add this prior to a compiled plan, reading the unit hypercube from entry offset onwards
+            *
+            * Returns false (without touching the plan) if the prior cannot be expressed as independent 1D kernels.
+            */
+            virtual bool compile(prior_plan &, int) const { return false; }
+
             virtual std::vector<std::string> getShownParameters() const { return param_names; }
 
             inline unsigned int size() const { return param_size; }
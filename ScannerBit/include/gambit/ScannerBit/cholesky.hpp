@@ -12,6 +12,9 @@
 ///          (gregory.david.martinez@gmail.com)
 ///  \date Feb 2014
 ///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
 ///  *********************************************
 
 #ifndef CHOLESKY_HPP
@@ -20,67 +23,66 @@
 #include <vector>
 #include <cmath>
 #include <iostream>
+
+#include "gambit/ScannerBit/scanner_util_types.hpp"
+
 namespace Gambit
 {
-    // Cholesky decomposition class
+    /// Cholesky decomposition class
+    ///
+    /// The lower-triangular factor L is computed once by Eigen's (blocked) LLT and stored as one
+    /// contiguous row-major matrix, so each row used by the single-point multiply is contiguous.
     class Cholesky
     {
     private:
-        std::vector<std::vector<double>> el;
-            
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> factor_type;
+        factor_type el;
+
     public:
         Cholesky(){}
-        
-        Cholesky(const int num) : el(num, std::vector<double>(num)) {}
-                
+
+        Cholesky(const int num) : el(factor_type::Zero(num, num)) {}
+
+        /// Factorise the symmetric matrix a (only its upper triangle is read).
+        /// Returns false if a is not positive definite.
         bool EnterMat(std::vector<std::vector<double>> &a)
         {
-            el = a;
-            int num = el.size();
-            double sum = 0;
-            int i, j, k;
-            
-            for (i = 0; i < num; i++)
-            {
-                for (j = i; j < num; j++)
-                {
-                    for(sum = el[i][j], k = i - 1; k >= 0; k--)
-                        sum -= el[i][k]*el[j][k];
-                    if(i == j)
-                    {
-                        if(sum <= 0.0)
-                        {
-                                return false;
-                        }
-                        el[i][i] = std::sqrt(sum);
-                    }
-                    else
-                        el[j][i] = sum/el[i][i];
-                }
-            }
-            
-            for (i = 0; i < num; i++)
-                for (j = 0; j < i; j++)
-                    el[j][i] = 0.0;
-                    
+            int num = a.size();
+            Eigen::MatrixXd mat(num, num);
+            for (int i = 0; i < num; i++)
+                for (int j = i; j < num; j++)
+                    mat(i, j) = a[i][j];
+
+            Eigen::LLT<Eigen::MatrixXd, Eigen::Upper> llt(mat);
+            if (llt.info() != Eigen::Success)
+                return false;
+
+            el = llt.matrixL();
+
             return true;
         }
-        
+
+        /// y = L y, in place.  Row i of the product only needs entries 0..i of y, so working
+        /// upwards from the last row never reads an entry that has already been overwritten.
         void ElMult (std::vector<double> &y) const
         {
-            int i, j;
-            int num = el.size();
-            std::vector<double> b(num);
-            for(i = 0; i < num; i++)
-            {
-                b[i] = 0.0;
-                for (j = 0; j <= i; j++)
-                {
-                    b[i] += el[i][j]*y[j];
-                }
-            }
-            
-            y = b;
+            Eigen::Map<Eigen::VectorXd> x(y.data(), y.size());
+            for (int i = el.rows() - 1; i >= 0; i--)
+                x[i] = el.row(i).head(i + 1).dot(x.head(i + 1));
+        }
+
+        /// y = L y for a population of points, one point per row of y (i.e. y = y L^T).
+        /// The product goes through a per-thread scratch matrix, which is only reallocated when
+        /// the population grows, rather than through a new temporary on every call.
+        void ElMultBatch(Scanner::hyper_cube_batch_ref<double> y) const
+        {
+            static thread_local Scanner::matrix<double> scratch;
+            if (scratch.size() < y.size())
+                scratch.resize(y.size(), 1);
+
+            Eigen::Map<Scanner::matrix<double>> product(scratch.data(), y.rows(), y.cols());
+            product.noalias() = y * el.transpose().triangularView<Eigen::Upper>();
+            y = product;
         }
 
         /**
@@ -90,48 +92,51 @@ namespace Gambit
           */
         std::vector<double> invElMult(const std::vector<double> &y) const
         {
-            std::vector<double> x(y.size(), 0.);
-            for (int i = 0, n = x.size(); i < n; i++)
-            {
-                double sum_ = 0;
-                for (int j = 0; j < i; j++)
-                {
-                    sum_ += el[i][j] * x[j];
-                }
-                x[i] = (y[i] - sum_) / el[i][i];
-            }
+            std::vector<double> x(y);
+            invElMultInPlace(x);
             return x;
         }
 
+        /// y = L^-1 y, in place
+        void invElMultInPlace(std::vector<double> &y) const
+        {
+            Eigen::Map<Eigen::VectorXd> x(y.data(), y.size());
+            el.triangularView<Eigen::Lower>().solveInPlace(x);
+        }
+
+        /// (y - y0)^T (L L^T)^-1 (y - y0)
         template<typename VEC1, typename VEC2>
-        double Square(VEC1 &&y, VEC2 &&y0)
+        double Square(VEC1 &&y, VEC2 &&y0) const
+        {
+            int num = y.size();
+            Eigen::VectorXd x(num);
+
+            for (int i = 0; i < num; i++)
+                x[i] = y[i] - y0[i];
+
+            el.triangularView<Eigen::Lower>().solveInPlace(x);
+
+            return x.squaredNorm();
+        }
+
+        /// Get the diagonal of the Cholesky matrix, if it has no off-diagonal entries
+        bool Diagonal(std::vector<double> &d) const
         {
-            int i, j, num = y.size();
-            double sum;
-            std::vector<double> x(num);
-            
-            for (i = 0; i < num; i++)
+            int num = el.rows();
+            d.resize(num);
+            for (int i = 0; i < num; i++)
             {
-                for (sum = (y[i]-y0[i]), j=0; j < i; j++)
-                    sum -= el[i][j]*x[j];
-                
-                x[i]=sum/el[i][i];
+                for (int j = 0; j < i; j++)
+                    if (el(i, j) != 0.0)
+                        return false;
+                d[i] = el(i, i);
             }
-            
-            sum = 0.0;
-            for (i = 0; i < num; i++)
-                sum += x[i]*x[i];
-            
-            return sum;
+            return true;
         }
-        
-        double DetSqrt()
+
+        double DetSqrt() const
         {
-            double temp = 1.0;
-            int num = el.size();
-            for (int i = 0; i < num; i++)
-                temp *= el[i][i];
-            return temp;
+            return el.diagonal().prod();
         }
     };
 }
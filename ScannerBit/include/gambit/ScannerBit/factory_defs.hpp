@@ -60,6 +60,14 @@ namespace Gambit
         template<typename T>
         class scan_ptr;
 
+        /// Print handles of the quantities printed by like_ptr at every point
+        struct like_print_handles
+        {
+            Printers::print_handle purpose, modified_purpose, unit_cube, pointID, MPIrank;
+
+            like_print_handles() : unit_cube("unitCubeParameters"), pointID("pointID"), MPIrank("MPIrank") {}
+        };
+
         /// Base function for the object that is upputed by "set_purpose".
         template<typename ret, typename... args>
         class Function_Base <ret (args...)> : public std::enable_shared_from_this<Function_Base <ret (args...)>>
@@ -72,6 +80,7 @@ namespace Gambit
             Priors::BasePrior *prior;
             std::unordered_map<std::string, double> map;
             std::string purpose;
+            like_print_handles print_handles;
             int myRealRank; // the actual MPI rank of the process, use for process dependent setup etc. getRank() is for printing only.
 
             /// Variable to store some offset to be removed when printing out the return value of the function.
@@ -151,7 +160,12 @@ namespace Gambit
             }
 
             std::unordered_map<std::string, double> &getMap(){return map;}
-            void setPurpose(const std::string p) {purpose = p;}
+            void setPurpose(const std::string p)
+            {
+                purpose = p;
+                print_handles.purpose = Printers::print_handle(p);
+                print_handles.modified_purpose = Printers::print_handle("Modified" + p);
+            }
             void setPrinter(printer* p) {main_printer = p;}
             void setPrior(Priors::BasePrior *p) {prior = p;}
             printer &getPrinter() {return *main_printer;}
@@ -160,6 +174,7 @@ namespace Gambit
             std::vector<std::string> getParameters() {return prior->getParameters();}
             std::vector<std::string> getShownParameters() {return prior->getShownParameters();}
             std::string getPurpose() const {return purpose;}
+            like_print_handles &getPrintHandles() {return print_handles;}
             int getRank() const {return getPrinter().getRank();} // Printer controls the 'virtual' rank. Lets us re-print data from a point originally generated by another rank.
             void setRank(int r) {getPrinter().setRank(r);} // Needed by postprocessor to adjust 'virtual' rank; generally should not use otherwise.
             double getPurposeOffset() const { return purpose_offset; }
@@ -364,17 +379,18 @@ namespace Gambit
                 double ret_val = (*this)->operator()(map);
                 double modified_ret_val = (*this)->purposeModifier(ret_val);
                 unsigned long long int id = Gambit::Printers::get_point_id();
-                (*this)->getPrinter().print(ret_val, (*this)->getPurpose(), rank, id);
-                (*this)->getPrinter().print(modified_ret_val, "Modified" + (*this)->getPurpose(), rank, id);
+                like_print_handles &handles = (*this)->getPrintHandles();
+                (*this)->getPrinter().print(ret_val, handles.purpose, rank, id);
+                (*this)->getPrinter().print(modified_ret_val, handles.modified_purpose, rank, id);
                 if (vec.size() > 0 && (*this)->getPrinter().get_printUnitcube())
                 {
                     std::vector<double> temp(vec.size());
                     for (int i = 0, end = vec.size(); i < end; ++i)
                         temp[i] =vec[i];
-                    (*this)->getPrinter().print(temp, "unitCubeParameters", rank, id);
+                    (*this)->getPrinter().print(temp, handles.unit_cube, rank, id);
                 }
-                (*this)->getPrinter().print(id,   "pointID", rank, id);
-                (*this)->getPrinter().print(rank, "MPIrank", rank, id);
+                (*this)->getPrinter().print(id,   handles.pointID, rank, id);
+                (*this)->getPrinter().print(rank, handles.MPIrank, rank, id);
                 (*this)->getPrinter().enable(); // Make sure printer is re-enabled (might have been disabled by invalid point error)
 
                 // Return the value of the function, offset by any offset set
@@ -391,10 +407,11 @@ namespace Gambit
                     ret_val = (*this)->operator()(map);
                 double modified_ret_val = (*this)->purposeModifier(ret_val);
                 unsigned long long int id = Gambit::Printers::get_point_id();
-                (*this)->getPrinter().print(ret_val, (*this)->getPurpose(), rank, id);
-                (*this)->getPrinter().print(modified_ret_val, "Modified" + (*this)->getPurpose(), rank, id);
-                (*this)->getPrinter().print(id,   "pointID", rank, id);
-                (*this)->getPrinter().print(rank, "MPIrank", rank, id);
+                like_print_handles &handles = (*this)->getPrintHandles();
+                (*this)->getPrinter().print(ret_val, handles.purpose, rank, id);
+                (*this)->getPrinter().print(modified_ret_val, handles.modified_purpose, rank, id);
+                (*this)->getPrinter().print(id,   handles.pointID, rank, id);
+                (*this)->getPrinter().print(rank, handles.MPIrank, rank, id);
                 (*this)->getPrinter().enable(); // Make sure printer is re-enabled (might have been disabled by invalid point error)
 
                 // Return the value of the function, offset by any offset set
@@ -0,0 +1,339 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Distribution of point indices over MPI
+///  processes for the scanner plugins, either
+///  statically (round robin) or dynamically
+///  from a coordinator process.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __INDEX_SCHEDULER_HPP__
+#define __INDEX_SCHEDULER_HPP__
+
+#ifdef WITH_MPI
+#include "gambit/Utils/begin_ignore_warnings_mpi.hpp"
+#include "mpi.h"
+#include "gambit/Utils/end_ignore_warnings.hpp"
+#endif
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace Gambit
+{
+
+    namespace Scanner
+    {
+
+#ifdef WITH_MPI
+
+        /**
+        * @brief Barrier over all MPI processes that calls idle while it waits.  Collective.
+        *
+        * The processes may still be waiting on rank 0 to receive their printer output, so
+        * rank 0 must not block in a collective operation until they are done.
+        */
+        inline void idle_barrier(const std::function<void()> &idle)
+        {
+            MPI_Request req;
+            int done = 0;
+            MPI_Ibarrier(MPI_COMM_WORLD, &req);
+            MPI_Test(&req, &done, MPI_STATUS_IGNORE);
+            while (!done)
+            {
+                idle();
+                std::this_thread::yield();
+                MPI_Test(&req, &done, MPI_STATUS_IGNORE);
+            }
+        }
+
+        /**
+        * @brief Coordinator/worker distribution of the indices [0, total).
+        *
+        * Rank 0 only coordinates.  Workers ask it for a chunk of indices when they run out,
+        * through the same Irecv/Waitsome loop as the AIS scanner.  Chunks shrink as the
+        * remaining work shrinks (guided scheduling), down to min_chunk.  Once every index
+        * has been handed out, a worker that runs out steals the back half of the unstarted
+        * indices of the worker with the largest outstanding chunk: the coordinator asks that
+        * worker to split its chunk, which it does between two points.
+        *
+        * While it waits for the workers, the coordinator calls the idle function, if one is
+        * given (e.g. so that the printer can receive the output that the workers send it).
+        */
+        class dynamic_index_scheduler
+        {
+        private:
+            enum tags {request_tag = 1, assign_tag, steal_tag, yield_tag};
+
+            typedef unsigned long long index_type;
+
+            MPI_Comm comm;
+            int rank, numtasks;
+            index_type total, min_chunk;
+            std::function<void()> idle;
+
+            void coordinate()
+            {
+                const int nworkers = numtasks - 1;
+                index_type next = 0;
+
+                // The chunk each worker is believed to hold; the start is not updated as it progresses
+                std::vector<index_type> lo(nworkers, 0), hi(nworkers, 0);
+                std::vector<bool> stealing_from(nworkers, false), deferred(nworkers, false);
+                std::deque<int> thieves;
+                int nidle = 0;
+
+                // Requests 0..nworkers-1 are work requests, nworkers..2*nworkers-1 replies to steals
+                std::vector<index_type> yield_buf(2*nworkers);
+                std::vector<int> request_buf(nworkers);
+                std::vector<MPI_Request> reqs(2*nworkers);
+                std::vector<int> indices(2*nworkers);
+                std::vector<MPI_Status> stats(2*nworkers);
+
+                auto assign = [&](int w, index_type begin, index_type end)
+                {
+                    index_type range[2] = {begin, end};
+                    lo[w] = begin;
+                    hi[w] = end;
+                    MPI_Send(range, 2, MPI_UNSIGNED_LONG_LONG, w + 1, assign_tag, comm);
+                };
+
+                // Hand out fresh indices, or else steal for worker w; otherwise w becomes idle
+                auto serve = [&](int w)
+                {
+                    if (next < total)
+                    {
+                        index_type chunk = std::max(min_chunk, (total - next)/(2*nworkers));
+                        index_type end = std::min(total, next + chunk);
+                        assign(w, next, end);
+                        next = end;
+                        return;
+                    }
+
+                    int victim = -1;
+                    for (int v = 0; v < nworkers; v++)
+                    {
+                        if (v != w && !stealing_from[v] && !deferred[v] && hi[v] - lo[v] > 1 && (victim < 0 || hi[v] - lo[v] > hi[victim] - lo[victim]))
+                            victim = v;
+                    }
+
+                    if (victim >= 0)
+                    {
+                        int dummy = 0;
+                        stealing_from[victim] = true;
+                        thieves.push_back(w);
+                        MPI_Send(&dummy, 1, MPI_INT, victim + 1, steal_tag, comm);
+                    }
+                    else
+                        nidle++;
+                };
+
+                for (int w = 0; w < nworkers; w++)
+                {
+                    MPI_Irecv(&request_buf[w], 1, MPI_INT, w + 1, request_tag, comm, &reqs[w]);
+                    MPI_Irecv(&yield_buf[2*w], 2, MPI_UNSIGNED_LONG_LONG, w + 1, yield_tag, comm, &reqs[nworkers + w]);
+                }
+
+                while (nidle < nworkers)
+                {
+                    int outcount;
+                    if (idle)
+                    {
+                        MPI_Testsome(2*nworkers, &reqs[0], &outcount, &indices[0], &stats[0]);
+                        if (outcount == 0)
+                        {
+                            idle();
+                            std::this_thread::yield();
+                        }
+                    }
+                    else
+                        MPI_Waitsome(2*nworkers, &reqs[0], &outcount, &indices[0], &stats[0]);
+
+                    for (int k = 0; k < outcount; k++)
+                    {
+                        const int i = indices[k];
+                        if (i < nworkers)
+                        {
+                            const int w = i;
+                            MPI_Irecv(&request_buf[w], 1, MPI_INT, w + 1, request_tag, comm, &reqs[w]);
+                            lo[w] = hi[w] = 0;
+
+                            // Its reply to an outstanding steal must be dealt with first
+                            if (stealing_from[w])
+                                deferred[w] = true;
+                            else
+                                serve(w);
+                        }
+                        else
+                        {
+                            const int w = i - nworkers;
+                            const index_type begin = yield_buf[2*w], end = yield_buf[2*w + 1];
+                            MPI_Irecv(&yield_buf[2*w], 2, MPI_UNSIGNED_LONG_LONG, w + 1, yield_tag, comm, &reqs[nworkers + w]);
+
+                            stealing_from[w] = false;
+                            if (!deferred[w])
+                                hi[w] = begin < end ? begin : lo[w];
+
+                            const int thief = thieves.front();
+                            thieves.pop_front();
+                            if (begin < end)
+                                assign(thief, begin, end);
+                            else
+                                serve(thief);
+
+                            if (deferred[w])
+                            {
+                                deferred[w] = false;
+                                serve(w);
+                            }
+                        }
+                    }
+                }
+
+                for (int w = 0; w < nworkers; w++)
+                {
+                    assign(w, 0, 0);
+                    MPI_Cancel(&reqs[w]);
+                    MPI_Cancel(&reqs[nworkers + w]);
+                }
+                MPI_Waitall(2*nworkers, &reqs[0], MPI_STATUSES_IGNORE);
+            }
+
+            template <typename F>
+            void work(F &&f)
+            {
+                index_type range[2], begin = 0, end = 0;
+                int request = 0, steal = 0;
+                MPI_Request steal_req, assign_req;
+                MPI_Irecv(&steal, 1, MPI_INT, 0, steal_tag, comm, &steal_req);
+
+                // Answer a steal request by giving up the back half of the unstarted indices
+                auto yield = [&]()
+                {
+                    index_type give[2] = {end - (end - begin)/2, end};
+                    end = give[0];
+                    MPI_Send(give, 2, MPI_UNSIGNED_LONG_LONG, 0, yield_tag, comm);
+                    MPI_Irecv(&steal, 1, MPI_INT, 0, steal_tag, comm, &steal_req);
+                };
+
+                for (;;)
+                {
+                    MPI_Send(&request, 1, MPI_INT, 0, request_tag, comm);
+                    MPI_Irecv(range, 2, MPI_UNSIGNED_LONG_LONG, 0, assign_tag, comm, &assign_req);
+
+                    for (;;)
+                    {
+                        MPI_Request both[2] = {assign_req, steal_req};
+                        int which;
+                        MPI_Waitany(2, both, &which, MPI_STATUS_IGNORE);
+                        assign_req = both[0];
+                        steal_req = both[1];
+                        if (which == 0)
+                            break;
+                        yield();
+                    }
+
+                    begin = range[0];
+                    end = range[1];
+                    if (begin == end)
+                        break;
+
+                    while (begin < end)
+                    {
+                        int flag;
+                        MPI_Test(&steal_req, &flag, MPI_STATUS_IGNORE);
+                        if (flag)
+                            yield();
+
+                        f(begin++);
+                    }
+                }
+
+                MPI_Cancel(&steal_req);
+                MPI_Wait(&steal_req, MPI_STATUS_IGNORE);
+            }
+
+        public:
+            dynamic_index_scheduler(unsigned long long min_chunk = 1, std::function<void()> idle = nullptr) : total(0), min_chunk(std::max(min_chunk, 1ULL)), idle(std::move(idle))
+            {
+                MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+                MPI_Comm_size(comm, &numtasks);
+                MPI_Comm_rank(comm, &rank);
+            }
+
+            dynamic_index_scheduler(const dynamic_index_scheduler &) = delete;
+            dynamic_index_scheduler &operator=(const dynamic_index_scheduler &) = delete;
+
+            ~dynamic_index_scheduler()
+            {
+                MPI_Comm_free(&comm);
+            }
+
+            /// Call f(i) for every index i in [0, n), each on exactly one worker.  Collective.
+            template <typename F>
+            void run(unsigned long long n, F &&f)
+            {
+                total = n;
+                if (rank == 0)
+                    coordinate();
+                else
+                    work(f);
+            }
+        };
+
+#endif
+
+        /**
+        * @brief Call f(i) once for every i in [0, total), sharing the indices between the MPI processes.
+        *
+        * Statically, process r takes i = r, r + numtasks, ...  Dynamically (with more than one
+        * process), rank 0 hands out chunks of at least min_chunk indices to the other processes
+        * as they become free, and calls idle (if given) while it waits; see dynamic_index_scheduler.
+        * Statically, the processes wait for each other at the end, calling idle, if it is given.
+        */
+        template <typename F>
+        void for_each_index(unsigned long long total, bool dynamic, unsigned long long min_chunk, F &&f, std::function<void()> idle = nullptr)
+        {
+            int rank = 0, numtasks = 1;
+#ifdef WITH_MPI
+            MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
+            MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+            if (dynamic && numtasks > 1)
+            {
+                dynamic_index_scheduler(min_chunk, std::move(idle)).run(total, f);
+                return;
+            }
+#else
+            (void)dynamic;
+            (void)min_chunk;
+            (void)idle;
+#endif
+
+            for (unsigned long long i = rank; i < total; i += numtasks)
+                f(i);
+
+#ifdef WITH_MPI
+            if (idle && numtasks > 1)
+                idle_barrier(idle);
+#endif
+        }
+
+    }
+
+}
+
+#endif
@@ -125,6 +125,7 @@ namespace Gambit
             #endif
                 std::vector<Plugin_Details> loadExcluded(const std::string &);
                 void process(const std::string &, const std::string &, const std::string &, std::vector<Plugin_Details>&);
+                void addPlugins(const std::string &, const std::vector<std::string> &, const std::string & = "");
 
             public:
             #ifdef HAVE_PYBIND11
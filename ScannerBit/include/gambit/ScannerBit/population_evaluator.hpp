@@ -0,0 +1,207 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Evaluation of a population of unit hypercube
+///  points over all MPI processes, for scanner
+///  plugins.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __POPULATION_EVALUATOR_HPP__
+#define __POPULATION_EVALUATOR_HPP__
+
+#ifdef WITH_MPI
+#include "gambit/Utils/begin_ignore_warnings_mpi.hpp"
+#include "mpi.h"
+#include "gambit/Utils/end_ignore_warnings.hpp"
+#endif
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "gambit/ScannerBit/factory_defs.hpp"
+#include "gambit/ScannerBit/index_scheduler.hpp"
+
+namespace Gambit
+{
+
+    namespace Scanner
+    {
+
+        /**
+        * @brief Evaluates populations of unit hypercube points with a likelihood, sharing the
+        * points between all MPI processes.
+        *
+        * evaluate() is collective: every process must call it the same number of times.  The
+        * points only need to be set on rank 0; they are broadcast, evaluated either round robin
+        * or dynamically (see dynamic_index_scheduler), and the likelihoods, point IDs and printer
+        * ranks of all points are returned on every process.  The point IDs and ranks identify
+        * the points in the printer output, e.g. for printing auxiliary quantities later.
+        *
+        * With dynamic scheduling rank 0 only coordinates, so it is only worthwhile when the
+        * likelihood cost varies a lot between points.
+        */
+        class population_evaluator
+        {
+        private:
+            /// Result for one point, exchanged between processes as raw bytes
+            struct record
+            {
+                unsigned long long index, id;
+                double loglike;
+                int rank;
+            };
+
+            like_ptr LogLike;
+            int rank, numtasks;
+            bool dynamic;
+
+            /// Lets the printer receive the output of other processes while this one waits for them
+            std::function<void()> idle;
+
+#ifdef WITH_MPI
+            std::unique_ptr<dynamic_index_scheduler> scheduler;
+#endif
+
+            std::vector<double> flat;
+            std::vector<record> local, all;
+
+            void eval(const std::vector<double> &pt, unsigned long long i)
+            {
+                record r;
+                r.index = i;
+                r.loglike = LogLike(pt);
+                r.id = LogLike->getPtID();
+                r.rank = LogLike->getRank();
+                local.push_back(r);
+            }
+
+        public:
+            population_evaluator(like_ptr LogLike, bool dynamic = false, unsigned long long min_chunk = 1)
+                : LogLike(LogLike), rank(0), numtasks(1), dynamic(false), idle([LogLike]{ LogLike->getPrinter().poll(); })
+            {
+#ifdef WITH_MPI
+                MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
+                MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+                if (dynamic && numtasks > 1)
+                {
+                    this->dynamic = true;
+                    scheduler.reset(new dynamic_index_scheduler(min_chunk, idle));
+                }
+#else
+                (void)dynamic;
+                (void)min_chunk;
+#endif
+            }
+
+            int getRank() const { return rank; }
+
+            int getSize() const { return numtasks; }
+
+            /**
+            * @brief Evaluate the likelihood at every point.  Collective.
+            *
+            * points is read on rank 0 and overwritten with rank 0's points on the other processes.
+            * loglike, ids and ranks are resized and filled on every process.
+            */
+            void evaluate(std::vector<std::vector<double>> &points, std::vector<double> &loglike, std::vector<unsigned long long> &ids, std::vector<int> &ranks)
+            {
+                unsigned long long n = points.size();
+
+#ifdef WITH_MPI
+                if (numtasks > 1)
+                {
+                    // One broadcast of the shape, then one of the packed points
+                    int dim = n > 0 ? points[0].size() : 0;
+                    unsigned long long shape[2] = {n, (unsigned long long)dim};
+                    MPI_Bcast(shape, 2, MPI_UNSIGNED_LONG_LONG, 0, MPI_COMM_WORLD);
+                    n = shape[0];
+                    dim = shape[1];
+
+                    flat.resize(n*dim);
+                    if (rank == 0)
+                        for (unsigned long long i = 0; i < n; i++)
+                            std::copy(points[i].begin(), points[i].end(), flat.begin() + i*dim);
+
+                    MPI_Bcast(flat.data(), n*dim, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+                    if (rank != 0)
+                    {
+                        points.resize(n);
+                        for (unsigned long long i = 0; i < n; i++)
+                            points[i].assign(flat.begin() + i*dim, flat.begin() + (i + 1)*dim);
+                    }
+                }
+#endif
+
+                local.clear();
+                if (dynamic)
+                {
+#ifdef WITH_MPI
+                    scheduler->run(n, [&](unsigned long long i){ eval(points[i], i); });
+#endif
+                }
+                else
+                {
+                    for (unsigned long long i = rank; i < n; i += numtasks)
+                        eval(points[i], i);
+                }
+
+                all.swap(local);
+
+#ifdef WITH_MPI
+                if (numtasks > 1)
+                {
+                    idle_barrier(idle);
+
+                    // A single gather of the packed results of every process
+                    int nbytes = all.size()*sizeof(record);
+                    std::vector<int> counts(numtasks), displs(numtasks, 0);
+                    MPI_Allgather(&nbytes, 1, MPI_INT, counts.data(), 1, MPI_INT, MPI_COMM_WORLD);
+                    for (int r = 1; r < numtasks; r++)
+                        displs[r] = displs[r - 1] + counts[r - 1];
+
+                    local.swap(all);
+                    all.resize(n);
+                    MPI_Allgatherv(local.data(), nbytes, MPI_BYTE, all.data(), counts.data(), displs.data(), MPI_BYTE, MPI_COMM_WORLD);
+                }
+#endif
+
+                loglike.resize(n);
+                ids.resize(n);
+                ranks.resize(n);
+                for (const auto &r : all)
+                {
+                    loglike[r.index] = r.loglike;
+                    ids[r.index] = r.id;
+                    ranks[r.index] = r.rank;
+                }
+            }
+
+            /// Copy a value from rank 0 to every process.  Collective.
+            template <typename T>
+            void broadcast(T &val)
+            {
+#ifdef WITH_MPI
+                if (numtasks > 1)
+                    MPI_Bcast(&val, sizeof(T), MPI_BYTE, 0, MPI_COMM_WORLD);
+#else
+                (void)val;
+#endif
+            }
+        };
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,101 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Compiled structure-of-arrays plan for
+///  transforming the unit hypercube with many
+///  independent 1D priors.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __PRIOR_PLAN_HPP__
+#define __PRIOR_PLAN_HPP__
+
+#include <string>
+#include <vector>
+
+#include "gambit/ScannerBit/scanner_util_types.hpp"
+
+namespace Gambit
+{
+
+    namespace Priors
+    {
+
+        using ::Gambit::Scanner::hyper_cube_ref;
+        using ::Gambit::Scanner::hyper_cube_batch_ref;
+        using ::Gambit::Scanner::hyper_cube_batch_cref;
+
+        /// Elementwise kernels available to a compiled prior plan
+        enum class plan_kernel
+        {
+            flat,       ///< physical = (u*width + lower - shift)/scale
+            log,        ///< physical = (exp(u*width + lower) - shift)/scale
+            gaussian    ///< physical = sqrt(2)*erf_inv(2u - 1)*width + lower
+        };
+
+        /**
+        * @brief A group of 1D priors that share the same kernel, stored as a structure of arrays.
+        *
+        * Entry i of the group maps unit[in[i]] to physical[out[i]].
+        */
+        struct plan_group
+        {
+            plan_kernel kernel;
+            std::vector<int> in, out;
+            std::vector<double> width, lower, shift, scale;
+        };
+
+        /**
+        * @brief Plan for transforming the unit hypercube with independent 1D priors.
+        *
+        * Priors are grouped by kernel, so that each group is transformed by a single
+        * tight loop over contiguous arrays rather than a virtual call per parameter.
+        * The physical parameters are written to a flat array, in the order of names().
+        */
+        class prior_plan
+        {
+        private:
+            std::vector<plan_group> groups;
+            std::vector<std::string> param_names;
+
+            plan_group &group(plan_kernel);
+
+        public:
+            /** @brief Add a 1D prior, reading unit hypercube entry in, to the plan */
+            void add(plan_kernel kernel, int in, const std::string &name, double width, double lower, double shift = 0.0, double scale = 1.0);
+
+            /** @brief Add all priors of another plan, with their unit hypercube entries offset by offset */
+            void append(const prior_plan &plan, int offset);
+
+            /** @brief Names of the physical parameters, in the order of the flat output */
+            inline const std::vector<std::string> &names() const { return param_names; }
+
+            /** @brief Number of physical parameters */
+            inline int size() const { return param_names.size(); }
+
+            inline bool empty() const { return param_names.empty(); }
+
+            /** @brief Transform the unit hypercube into the flat array of physical parameters */
+            void run(hyper_cube_ref<double> unit, double *physical) const;
+
+            /**
+            * @brief Transform a population, one point per row
+            *
+            * Output i of the plan goes to column columns[i] of physical, or is skipped if columns[i] < 0.
+            */
+            void run_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical, const std::vector<int> &columns) const;
+        };
+
+    }  // namespace Priors
+
+}  // namespace Gambit
+
+#endif  // __PRIOR_PLAN_HPP__
@@ -55,7 +55,7 @@ namespace Gambit
         {
         private:
             std::vector<double> location;
-            mutable Cholesky col;
+            Cholesky col;
 
         public:
             // Constructor defined in cauchy.cpp
@@ -79,6 +79,19 @@ namespace Gambit
                 }
             }
 
+            void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override
+            {
+                for (int j = 0, rows = unit.rows(), cols = unit.cols(); j < rows; ++j)
+                    for (int i = 0; i < cols; ++i)
+                        physical(j, i) = std::tan(M_PI * (unit(j, i) - 0.5));
+
+                col.ElMultBatch(physical);
+
+                for (int j = 0, rows = unit.rows(), cols = unit.cols(); j < rows; ++j)
+                    for (int i = 0; i < cols; ++i)
+                        physical(j, i) += location[i];
+            }
+
             void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const override
             {
                 // subtract location
@@ -89,11 +102,11 @@ namespace Gambit
                 }
 
                 // invert rotation by Cholesky matrix
-                std::vector<double> rotated = col.invElMult(central);
+                col.invElMultInPlace(central);
 
                 // now diagonal; invert Cauchy CDF
-                for (int i = 0, end = rotated.size(); i < end; ++i)
-                    unit[i] = std::atan(rotated[i]) / M_PI + 0.5;
+                for (int i = 0, end = central.size(); i < end; ++i)
+                    unit[i] = std::atan(central[i]) / M_PI + 0.5;
             }
 
             double log_prior_density(const std::unordered_map<std::string, double> &physical) const override
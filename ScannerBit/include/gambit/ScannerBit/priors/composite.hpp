@@ -52,6 +52,18 @@ namespace Gambit
             // References to component prior objects
             std::vector<BasePrior*> my_subpriors;
             std::vector<std::string> shown_param_names;
+
+            // Compiled plan for the sub-priors that are independent 1D priors
+            prior_plan plan;
+            // Remaining sub-priors, with the offsets of their unit hypercube entries
+            std::vector<std::pair<BasePrior*, int>> uncompiled_subpriors;
+            // Column of each plan output among the shown parameters (-1 if not shown)
+            std::vector<int> plan_columns;
+            // Shown parameters that are not plan outputs, with their columns
+            std::vector<std::pair<int, std::string>> map_columns;
+
+            // Split the sub-priors into the compiled plan and the rest (defined in composite.cpp)
+            void compile_plan();
                 
         public:
         
@@ -73,18 +85,59 @@ namespace Gambit
             
             inline std::vector<std::string> getShownParameters() const override { return shown_param_names; }
             
-            // Transformation from unit hypercube to physical parameters
+            // Transformation from unit hypercube to physical parameters.  The compiled sub-priors are
+            // transformed into a flat scratch array first, and only then copied into the map.  The scratch
+            // is per thread, as scanners may evaluate the likelihood from several threads at once.
             void transform(hyper_cube_ref<double> unitPars, std::unordered_map<std::string,double> &outputMap) const override
             {
-                int unit_i = 0, unit_size;
-                for (auto it = my_subpriors.begin(), end = my_subpriors.end(); it != end; ++it)
+                static thread_local std::vector<double> physical;
+                physical.resize(plan.size());
+                plan.run(unitPars, physical.data());
+
+                const std::vector<std::string> &names = plan.names();
+                for (int i = 0, end = physical.size(); i < end; ++i)
                 {
-                    unit_size = (*it)->size();
-                    (*it)->transform(unitPars.segment(unit_i, unit_size), outputMap);
-                    unit_i += unit_size;
+                    outputMap[names[i]] = physical[i];
+                }
+
+                for (auto it = uncompiled_subpriors.begin(), end = uncompiled_subpriors.end(); it != end; ++it)
+                {
+                    it->first->transform(unitPars.segment(it->second, it->first->size()), outputMap);
+                }
+            }
+
+            // Transformation of a population, one point per row.  The plan runs over whole columns;
+            // the map is only filled (point by point) if some shown parameters come from uncompiled sub-priors.
+            void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override
+            {
+                plan.run_batch(unit, physical, plan_columns);
+
+                if (!map_columns.empty())
+                {
+                    Scanner::vector<double> point(unit.cols());
+                    std::unordered_map<std::string, double> map;
+                    for (int j = 0, end = unit.rows(); j < end; ++j)
+                    {
+                        point = unit.row(j).transpose();
+                        transform(point, map);
+                        for (auto it = map_columns.begin(), it_end = map_columns.end(); it != it_end; ++it)
+                            physical(j, it->first) = map.at(it->second);
+                    }
                 }
             }
 
+            // True if all the sub-priors are in the compiled plan
+            inline bool fullyCompiled() const { return uncompiled_subpriors.empty(); }
+
+            // A composite prior can itself be compiled into a bigger plan if all its sub-priors are compiled
+            bool compile(prior_plan &other, int offset) const override
+            {
+                if (!fullyCompiled())
+                    return false;
+                other.append(plan, offset);
+                return true;
+            }
+
             // Transformation from physical parameters back to unit hypercube
             void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const override
             {
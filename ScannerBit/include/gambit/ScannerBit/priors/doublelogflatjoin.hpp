@@ -60,12 +60,16 @@ namespace Gambit
          /// Try to get options for double log-flat joined prior
          double get_option(const str&, const Options&);
 
+         /// Transformation of a single unit interval value
+         double transform_value(double) const;
+
       public: 
          /// Constructor defined in doublelogflatjoin.cpp
          DoubleLogFlatJoin(const std::vector<std::string>& param, const Options&); 
 
          /// Transformation from unit interval to the double log + flat join (inverse prior transform)
          void transform(hyper_cube_ref<double> unitpars, std::unordered_map <std::string, double> &output) const override;
+         void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override;
          void inverse_transform(const std::unordered_map<std::string, double> &, hyper_cube_ref<double>) const override;
 
          /// Probability density function
@@ -23,6 +23,7 @@
 #define PRIOR_DEFS_HPP
 
 #include <cmath>
+#include <type_traits>
 #include "gambit/ScannerBit/priors.hpp"
 
    /// Registry of priors
@@ -219,6 +220,12 @@ namespace Gambit
                 output[myparameter] = (T::inv(unitpars[0]*(upper-lower) + lower)-shift_out)/scale_out;
             }
 
+            void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override
+            {
+                for (int j = 0, end = unit.rows(); j < end; ++j)
+                    physical(j, 0) = (T::inv(unit(j, 0)*(upper-lower) + lower)-shift_out)/scale_out;
+            }
+
             void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const override
             {
                 const double p = physical.at(myparameter);
@@ -232,6 +239,18 @@ namespace Gambit
             {
                 return T::prior(physical.at(param_names[0])*scale+shift)*scale;
             }
+
+            // Flat and log priors can be compiled into elementwise kernels
+            bool compile(prior_plan &plan, int offset) const override
+            {
+                if (std::is_same<T, flatprior>::value)
+                    plan.add(plan_kernel::flat, offset, myparameter, upper-lower, lower, shift_out, scale_out);
+                else if (std::is_same<T, logprior>::value)
+                    plan.add(plan_kernel::log, offset, myparameter, upper-lower, lower, shift_out, scale_out);
+                else
+                    return false;
+                return true;
+            }
         };
 
         LOAD_PRIOR(log, RangePrior1D<logprior>)
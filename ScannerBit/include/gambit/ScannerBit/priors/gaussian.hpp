@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "gambit/ScannerBit/cholesky.hpp"
+#include "gambit/ScannerBit/prior_math.hpp"
 #include "gambit/ScannerBit/priors.hpp"
 #include "gambit/Utils/yaml_options.hpp"
 
@@ -53,7 +54,7 @@ namespace Gambit
         {
         private:
             std::vector <double> mu;
-            mutable Cholesky col;
+            Cholesky col;
 
         public:
             // Constructor defined in gaussian.cpp
@@ -64,8 +65,12 @@ namespace Gambit
             {
                 std::vector<double> vec(unitpars.size());
 
+                #pragma omp simd
+                for (int i = 0; i < int(vec.size()); ++i)
+                    vec[i] = M_SQRT2 * fast_math::erf_inv(2. * unitpars[i] - 1.);
                 for (int i = 0, end = vec.size(); i < end; ++i)
-                    vec[i] = M_SQRT2 * boost::math::erf_inv(2. * unitpars[i] - 1.);
+                    if (!std::isfinite(vec[i]))
+                        vec[i] = M_SQRT2 * fast_math::erf_inv_checked(2. * unitpars[i] - 1.);
 
                 col.ElMult(vec);
 
@@ -77,6 +82,25 @@ namespace Gambit
                 }
             }
 
+            void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override
+            {
+                for (int i = 0, rows = unit.rows(), cols = unit.cols(); i < cols; ++i)
+                {
+                    #pragma omp simd
+                    for (int j = 0; j < rows; ++j)
+                        physical(j, i) = M_SQRT2 * fast_math::erf_inv(2. * unit(j, i) - 1.);
+                    for (int j = 0; j < rows; ++j)
+                        if (!std::isfinite(physical(j, i)))
+                            physical(j, i) = M_SQRT2 * fast_math::erf_inv_checked(2. * unit(j, i) - 1.);
+                }
+
+                col.ElMultBatch(physical);
+
+                for (int j = 0, rows = unit.rows(), cols = unit.cols(); j < rows; ++j)
+                    for (int i = 0; i < cols; ++i)
+                        physical(j, i) += mu[i];
+            }
+
             void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const override
             {
                 // subtract mean
@@ -87,11 +111,11 @@ namespace Gambit
                 }
 
                 // invert rotation by Cholesky matrix
-                std::vector<double> rotated = col.invElMult(central);
+                col.invElMultInPlace(central);
 
                 // now diagonal; invert Gaussian CDF
-                for (int i = 0, end = rotated.size(); i < end; ++i)
-                    unit[i] = 0.5 * (boost::math::erf(rotated[i] / M_SQRT2) + 1.0);
+                for (int i = 0, end = central.size(); i < end; ++i)
+                    unit[i] = 0.5 * (boost::math::erf(central[i] / M_SQRT2) + 1.0);
             }
 
             double log_prior_density(const std::unordered_map<std::string, double> &physical) const
@@ -104,6 +128,18 @@ namespace Gambit
                 
                 return -0.5 * col.Square(vec, mu) - norm;
             }
+
+            /** @brief Gaussians with diagonal covariance matrices can be compiled into elementwise kernels */
+            bool compile(prior_plan &plan, int offset) const override
+            {
+                std::vector<double> sigma;
+                if (!col.Diagonal(sigma))
+                    return false;
+
+                for (int i = 0, end = param_names.size(); i < end; ++i)
+                    plan.add(plan_kernel::gaussian, offset + i, param_names[i], sigma[i], mu[i]);
+                return true;
+            }
         };
 
         LOAD_PRIOR(gaussian, Gaussian)
@@ -33,6 +33,7 @@
 #include <vector>
 
 #include "gambit/ScannerBit/cholesky.hpp"
+#include "gambit/ScannerBit/prior_math.hpp"
 #include "gambit/ScannerBit/priors.hpp"
 #include "gambit/Utils/yaml_options.hpp"
 
@@ -57,7 +58,7 @@ namespace Gambit
         private:
             std::vector <double> mu;
             double base{10.};
-            mutable Cholesky col;
+            Cholesky col;
 
         public:
             // Constructor defined in LogNormal.cpp
@@ -67,8 +68,12 @@ namespace Gambit
             void transform(hyper_cube_ref<double> unitpars, std::unordered_map<std::string, double> &outputMap) const override
             {
                 std::vector<double> vec(unitpars.size());
+                #pragma omp simd
+                for (int i = 0; i < int(vec.size()); ++i)
+                    vec[i] = M_SQRT2 * fast_math::erf_inv(2. * unitpars[i] - 1.);
                 for (int i = 0, end = vec.size(); i < end; ++i)
-                    vec[i] = M_SQRT2 * boost::math::erf_inv(2. * unitpars[i] - 1.);
+                    if (!std::isfinite(vec[i]))
+                        vec[i] = M_SQRT2 * fast_math::erf_inv_checked(2. * unitpars[i] - 1.);
 
                 col.ElMult(vec);
 
@@ -80,6 +85,25 @@ namespace Gambit
                 }
             }
 
+            void transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const override
+            {
+                for (int i = 0, rows = unit.rows(), cols = unit.cols(); i < cols; ++i)
+                {
+                    #pragma omp simd
+                    for (int j = 0; j < rows; ++j)
+                        physical(j, i) = M_SQRT2 * fast_math::erf_inv(2. * unit(j, i) - 1.);
+                    for (int j = 0; j < rows; ++j)
+                        if (!std::isfinite(physical(j, i)))
+                            physical(j, i) = M_SQRT2 * fast_math::erf_inv_checked(2. * unit(j, i) - 1.);
+                }
+
+                col.ElMultBatch(physical);
+
+                for (int j = 0, rows = unit.rows(), cols = unit.cols(); j < rows; ++j)
+                    for (int i = 0; i < cols; ++i)
+                        physical(j, i) = std::pow(base, physical(j, i) + mu[i]);
+            }
+
             void inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const override
             {
                 // undo exponentiation
@@ -97,11 +121,11 @@ namespace Gambit
                 }
 
                 // invert rotation by Cholesky matrix
-                std::vector<double> rotated = col.invElMult(central);
+                col.invElMultInPlace(central);
 
                 // now diagonal; invert Gaussian CDF
-                for (int i = 0, end = rotated.size(); i < end; ++i)
-                    unit[i] = 0.5 * (boost::math::erf(rotated[i] / M_SQRT2) + 1.0);
+                for (int i = 0, end = central.size(); i < end; ++i)
+                    unit[i] = 0.5 * (boost::math::erf(central[i] / M_SQRT2) + 1.0);
             }
 
             double log_prior_density(const std::unordered_map<std::string, double> &physical) const
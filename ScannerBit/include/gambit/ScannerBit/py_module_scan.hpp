@@ -720,14 +720,8 @@ PYBIND11_EMBEDDED_MODULE(scanner_plugin, m)
     })
     .def_static("transform_to_vec", [](Gambit::Scanner::hyper_cube_ref<double> unit)
     {
-        //auto &map = getLike()->getMap();
-        static std::unordered_map<std::string, double> map;
-        get_prior().transform(unit, map);
-        auto params = get_prior().getShownParameters();
-        Gambit::Scanner::vector<double> vec(params.size());
-        
-        for (size_t i = 0, end = params.size(); i < end; ++i)
-            vec[i] = map[params[i]];
+        Gambit::Scanner::vector<double> vec(get_prior().getShownParameters().size());
+        get_prior().transform_to_vec(unit, vec);
         
         return vec;
     })
@@ -761,17 +755,31 @@ PYBIND11_EMBEDDED_MODULE(scanner_plugin, m)
     .def_static("transform_to_vec", [](Gambit::Scanner::hyper_cube_ref<float> unitf)
     {
         Gambit::Scanner::vector<double> unit = unitf.template cast<double>();
-        //auto &map = getLike()->getMap();
-        static std::unordered_map<std::string, double> map;
-        get_prior().transform(unit, map);
-        auto params = get_prior().getShownParameters();
-        Gambit::Scanner::vector<double> vec(params.size());
-        
-        for (size_t i = 0, end = params.size(); i < end; ++i)
-            vec[i] = map[params[i]];
+        Gambit::Scanner::vector<double> vec(get_prior().getShownParameters().size());
+        get_prior().transform_to_vec(unit, vec);
         
         return vec;
     })
+    .def_static("transform", [](Gambit::Scanner::hyper_cube_batch_cref<double> unit)
+    {
+        // Population of points, one per row; the result is allocated as a numpy array and filled in place
+        py::array_t<double> physical({(py::ssize_t)unit.rows(), (py::ssize_t)get_prior().getShownParameters().size()});
+        Eigen::Map<Gambit::Scanner::matrix<double>, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>> 
+            phys(physical.mutable_data(), physical.shape(0), physical.shape(1), Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>(1, physical.shape(1)));
+        get_prior().transform_batch(unit, phys);
+        
+        return physical;
+    })
+    .def_static("transform", [](Gambit::Scanner::hyper_cube_batch_cref<double> unit, Gambit::Scanner::hyper_cube_batch_ref<double> physical)
+    {
+        if (physical.rows() != unit.rows() || physical.cols() != (int)get_prior().getShownParameters().size())
+        {
+            scan_err << "Output array for a population of " << unit.rows() << " points has shape (" << physical.rows() << ", " 
+                     << physical.cols() << "), but should be (" << unit.rows() << ", " << get_prior().getShownParameters().size() << ")." << scan_end;
+        }
+        
+        get_prior().transform_batch(unit, physical);
+    })
     .def_static("inverse_transform", [](std::unordered_map<std::string, double> &physical)
     {
         Gambit::Scanner::vector<double> unit(get_prior().size());
@@ -51,6 +51,16 @@ namespace Gambit
         template <typename T>
         using hyper_cube_ref = Eigen::Ref<vector<T>, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
         
+        /// \brief Represents a population of points, one point per row.
+        ///
+        template <typename T>
+        using hyper_cube_batch_ref = Eigen::Ref<matrix<T>, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+        
+        /// \brief Represents a read-only population of points, one point per row.
+        ///
+        template <typename T>
+        using hyper_cube_batch_cref = Eigen::Ref<const matrix<T>, 0, Eigen::Stride<Eigen::Dynamic, Eigen::Dynamic>>;
+        
         /// \brief Vector using raw data.
         ///
         template <typename T>
@@ -266,22 +266,7 @@ void AIS(Gambit::Scanner::like_ptr LogLike,
            const long long &rand,
            int N,
            int M,
-           std::vector<double> Bs);
-
-#ifdef WITH_MPI
-void AIS_MPI(Gambit::Scanner::like_ptr LogLike, 
-           Gambit::Scanner::printer_interface &printer, 
-           Gambit::Scanner::resume_params_func set_resume_params, 
-           const int &ma, 
-           //const double &div, 
-           const int &proj, 
-           const double &din, 
-           const double &alim, 
-           const double &alimt, 
-           const long long &rand,
-           int N,
-           int M,
-           std::vector<double> Bs);
-#endif
+           std::vector<double> Bs,
+           bool dynamic = false);
 
 #endif
@@ -100,9 +100,15 @@ namespace Gambit
         /// Particles making up the swarm (rank-local selection)
         std::vector<particle> particles;
 
-        /// Particles making up the swarm (total population)
+        /// Particles making up the swarm (total population; only up to date on rank 0 after gather_particles)
         std::vector<particle> particles_global;
 
+        /// Rank-local particles packed into one contiguous structure-of-arrays block, and the blocks of all ranks
+        /// @{
+        std::vector<double> packed_particles;
+        std::vector<double> packed_particles_global;
+        /// @}
+
         /// Current global best fit
         /// @{
         double global_best_value;
@@ -112,6 +118,12 @@ namespace Gambit
         /// Mean personal best fit across the current generation
         double mean_lnlike;
 
+        /// Mean personal best fit across the generation most recently combined by collect_data
+        double current_mean_lnlike;
+
+        /// Whether any process has been asked by the calling code to shut down early
+        bool quit_requested;
+
         /// Smoothed fractional improvement in the mean personal best fit across the most recent generations
         double sfim;
 
@@ -158,9 +170,12 @@ namespace Gambit
         /// Check whether the swarm has converged
         bool converged();
 
-        /// Collect all particles and related data to rank 0
+        /// Combine the function call counts, global best fit and convergence measures of all processes
         void collect_data();
 
+        /// Collect all particles to rank 0
+        void gather_particles();
+
       public:
 
         /// Pointer to objective function
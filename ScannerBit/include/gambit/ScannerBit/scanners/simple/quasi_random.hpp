@@ -0,0 +1,311 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Low-discrepancy (quasi-random) designs on the
+///  unit hypercube: scrambled Sobol, Halton and
+///  Latin hypercube.
+///
+///  Every design is stateless: point i can be
+///  generated directly from the index i, so the
+///  points can be partitioned over MPI processes
+///  by index.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __QUASI_RANDOM_HPP__
+#define __QUASI_RANDOM_HPP__
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gambit/ScannerBit/scanners/simple/sobol_table.hpp"
+
+namespace Gambit
+{
+
+    namespace Scanner
+    {
+
+        namespace QuasiRandom
+        {
+
+            /// SplitMix64 finaliser; used to derive independent seeds and uniform hashes
+            inline std::uint64_t mix64(std::uint64_t x)
+            {
+                x += 0x9e3779b97f4a7c15ULL;
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+                return x ^ (x >> 31);
+            }
+
+            /// Hash of (seed, a, b) to a uniform double in (0, 1)
+            inline double hash_uniform(std::uint64_t seed, std::uint64_t a, std::uint64_t b)
+            {
+                std::uint64_t h = mix64(mix64(seed ^ mix64(a)) ^ b);
+                return (double(h >> 11) + 0.5)/9007199254740992.0;
+            }
+
+            /// Abstract design; point(i, u) fills u with the i-th point, every coordinate in (0, 1)
+            class sequence
+            {
+            public:
+                virtual ~sequence() {}
+
+                virtual void point(std::uint64_t index, std::vector<double> &u) const = 0;
+
+                /// Number of distinct points the design can produce
+                virtual std::uint64_t max_points() const { return std::numeric_limits<std::uint64_t>::max(); }
+            };
+
+            /**
+            * @brief Sobol sequence with Joe-Kuo direction numbers, optionally Owen-scrambled.
+            *
+            * The scrambling is the hash-based nested uniform scramble of Burley (2020), with an
+            * independent seed for each dimension.
+            */
+            class sobol_sequence : public sequence
+            {
+            private:
+                int dim;
+                bool scramble;
+                std::vector<std::uint32_t> v;      ///< direction numbers, 32 per dimension
+                std::vector<std::uint32_t> seeds;
+
+                static std::uint32_t reverse_bits(std::uint32_t x)
+                {
+                    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+                    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+                    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+                    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+                    return (x >> 16) | (x << 16);
+                }
+
+                static std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed)
+                {
+                    x = reverse_bits(x);
+                    x += seed;
+                    x ^= x*0x6c50b47cu;
+                    x ^= x*0xb82f1e52u;
+                    x ^= x*0xc7afe638u;
+                    x ^= x*0x8d22f6e6u;
+                    return reverse_bits(x);
+                }
+
+            public:
+                static const int max_dimension = sobol_table_size + 1;
+
+                sobol_sequence(int dim, bool scramble, std::uint64_t seed) : dim(dim), scramble(scramble), v(32*dim), seeds(dim)
+                {
+                    for (int k = 0; k < 32; k++)
+                        v[k] = 1u << (31 - k);
+
+                    for (int d = 1; d < dim; d++)
+                    {
+                        const sobol_polynomial &p = sobol_table[d - 1];
+                        int s = 0;
+                        while (p.poly >> (s + 1))
+                            s++;
+
+                        std::uint32_t *vd = &v[32*d];
+                        for (int k = 0; k < s && k < 32; k++)
+                            vd[k] = p.m[k] << (31 - k);
+
+                        // v_k = v_{k-s} ^ (v_{k-s} >> s) ^ sum_j a_j v_{k-j}, a_j the inner coefficients of the polynomial
+                        for (int k = s; k < 32; k++)
+                        {
+                            vd[k] = vd[k - s] ^ (vd[k - s] >> s);
+                            for (int j = 1; j < s; j++)
+                                if ((p.poly >> (s - j)) & 1u)
+                                    vd[k] ^= vd[k - j];
+                        }
+                    }
+
+                    for (int d = 0; d < dim; d++)
+                        seeds[d] = std::uint32_t(mix64(seed + d) >> 32);
+                }
+
+                void point(std::uint64_t index, std::vector<double> &u) const override
+                {
+                    const std::uint32_t gray = std::uint32_t(index ^ (index >> 1));
+                    for (int d = 0; d < dim; d++)
+                    {
+                        const std::uint32_t *vd = &v[32*d];
+                        std::uint32_t x = 0;
+                        for (std::uint32_t g = gray, k = 0; g; g >>= 1, k++)
+                            if (g & 1u)
+                                x ^= vd[k];
+
+                        if (scramble)
+                            x = owen_scramble(x, seeds[d]);
+
+                        u[d] = (double(x) + 0.5)/4294967296.0;
+                    }
+                }
+
+                std::uint64_t max_points() const override { return std::uint64_t(1) << 32; }
+            };
+
+            /**
+            * @brief Halton sequence, optionally scrambled by a random permutation of the digits
+            * at each digit position of each dimension.
+            *
+            * Index i gives point i + 1 of the sequence, so that the unscrambled design never
+            * contains the origin.
+            */
+            class halton_sequence : public sequence
+            {
+            private:
+                int dim;
+                std::vector<unsigned int> bases;
+                std::vector<int> ndigits;
+                std::vector<std::vector<unsigned int>> perms;   ///< per dimension, ndigits permutations of 0..base-1
+
+            public:
+                halton_sequence(int dim, bool scramble, std::uint64_t seed) : dim(dim), bases(dim), ndigits(dim), perms(dim)
+                {
+                    for (unsigned int n = 2, d = 0; int(d) < dim; n++)
+                    {
+                        bool prime = true;
+                        for (int j = 0; j < int(d) && bases[j]*bases[j] <= n; j++)
+                            if (n%bases[j] == 0)
+                                prime = false;
+                        if (prime)
+                            bases[d++] = n;
+                    }
+
+                    for (int d = 0; d < dim; d++)
+                    {
+                        const unsigned int b = bases[d];
+
+                        // enough digits to resolve both a 64-bit index and a double
+                        ndigits[d] = int(std::ceil(64.0/std::log2(double(b))));
+
+                        perms[d].resize(ndigits[d]*b);
+                        for (int k = 0; k < ndigits[d]; k++)
+                        {
+                            unsigned int *p = &perms[d][k*b];
+                            for (unsigned int j = 0; j < b; j++)
+                                p[j] = j;
+
+                            if (scramble)
+                            {
+                                for (unsigned int j = b - 1; j > 0; j--)
+                                {
+                                    unsigned int r = unsigned(hash_uniform(seed, d, (std::uint64_t(k) << 32) | j)*(j + 1));
+                                    std::swap(p[j], p[r]);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                void point(std::uint64_t index, std::vector<double> &u) const override
+                {
+                    for (int d = 0; d < dim; d++)
+                    {
+                        const unsigned int b = bases[d];
+                        const unsigned int *p = perms[d].data();
+                        const double inv_b = 1.0/b;
+                        std::uint64_t n = index + 1;
+                        double x = 0.0, scale = inv_b;
+
+                        // all digit positions are used, so scrambled trailing zeros are included
+                        for (int k = 0; k < ndigits[d]; k++, p += b, scale *= inv_b)
+                        {
+                            x += p[n%b]*scale;
+                            n /= b;
+                        }
+
+                        u[d] = x < 1.0 ? (x > 0.0 ? x : 0.5*scale) : 1.0 - 1.0/9007199254740992.0;
+                    }
+                }
+            };
+
+            /**
+            * @brief Latin hypercube design of a fixed number of points N.
+            *
+            * Each dimension uses an independent pseudo-random permutation of the N strata, given
+            * by a keyed Feistel bijection with cycle walking, so no O(N) tables are stored.
+            * Points are jittered uniformly within their strata if scramble is set, or placed
+            * at the centres of the strata otherwise.
+            */
+            class latin_hypercube : public sequence
+            {
+            private:
+                int dim;
+                bool jitter;
+                std::uint64_t N, seed;
+                int half_bits;
+
+                std::uint64_t permute(std::uint64_t x, std::uint64_t key) const
+                {
+                    const std::uint64_t mask = (std::uint64_t(1) << half_bits) - 1;
+                    do
+                    {
+                        std::uint64_t l = x >> half_bits, r = x & mask;
+                        for (int round = 0; round < 4; round++)
+                        {
+                            std::uint64_t t = l ^ (mix64(r ^ (key + round)) & mask);
+                            l = r;
+                            r = t;
+                        }
+                        x = (l << half_bits) | r;
+                    }
+                    while (x >= N);
+
+                    return x;
+                }
+
+            public:
+                latin_hypercube(int dim, bool scramble, std::uint64_t seed, std::uint64_t N) : dim(dim), jitter(scramble), N(N), seed(seed), half_bits(1)
+                {
+                    while (half_bits < 32 && (std::uint64_t(1) << (2*half_bits)) < N)
+                        half_bits++;
+                }
+
+                void point(std::uint64_t index, std::vector<double> &u) const override
+                {
+                    for (int d = 0; d < dim; d++)
+                    {
+                        const std::uint64_t stratum = permute(index, mix64(seed + d));
+                        const double offset = jitter ? hash_uniform(seed, d, index) : 0.5;
+                        u[d] = (double(stratum) + offset)/double(N);
+                    }
+                }
+
+                std::uint64_t max_points() const override { return N; }
+            };
+
+            /// Make the design called type ("sobol", "halton" or "lhs"); returns null for an unknown type.
+            /// N is the number of points (only used by the Latin hypercube).
+            inline std::unique_ptr<sequence> make_sequence(const std::string &type, int dim, bool scramble, std::uint64_t seed, std::uint64_t N)
+            {
+                if (type == "sobol")
+                    return std::unique_ptr<sequence>(new sobol_sequence(dim, scramble, seed));
+                else if (type == "halton")
+                    return std::unique_ptr<sequence>(new halton_sequence(dim, scramble, seed));
+                else if (type == "lhs")
+                    return std::unique_ptr<sequence>(new latin_hypercube(dim, scramble, seed, N));
+
+                return std::unique_ptr<sequence>();
+            }
+
+        }
+
+    }
+
+}
+
+#endif
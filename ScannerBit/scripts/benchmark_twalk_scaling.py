@@ -0,0 +1,145 @@
+#!/usr/bin/env python3
+#
+#  GAMBIT: Global and Modular BSM Inference Tool
+#*********************************************
+#  \file
+#
+#  Scaling benchmark of the T-Walk scanner with
+#  MPI. Runs T-Walk on the 'gaussian' objective
+#  (ScannerBit/src/objectives/test_functions)
+#  for a fixed time with each number of
+#  processes, and reports the time per step.
+#  Every step exchanges the chains of all
+#  processes, so this measures how that
+#  exchange scales with the number of processes.
+#
+#  usage: benchmark_twalk_scaling.py <gambit executable> [--ranks 8,16,...]
+#         [--mpiexec "mpiexec --oversubscribe"] [--minutes 0.5] [--dimension 10]
+#         [--workdir <directory>]
+#
+#*********************************************
+#
+#  Authors (add name and date if you modify):
+#
+#  \author The GAMBIT Collaboration
+#  \date 2026 Oct
+#
+#*********************************************
+
+import argparse
+import os
+import re
+import shlex
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# GAMBIT-light needs a user likelihood, although the scan only uses the gaussian objective
+user_lib_source = """
+double user_loglike(const int n_inputs, const double *input, const int n_outputs, double *output)
+{
+    return 0;
+}
+"""
+
+yaml_template = """
+UserModel:
+  p1:
+    name: x1
+    prior_type: flat
+    range: [0.0, 1.0]
+UserLogLikes:
+  loglike:
+    lang: c
+    user_lib: {user_lib}
+    func_name: user_loglike
+    input: [x1]
+Printer:
+  printer: none
+Scanner:
+  use_scanner: twalk
+  use_objectives: gauss
+  objectives:
+    gauss:
+      plugin: gaussian
+      purpose: LogLike
+      parameters:
+{parameters}
+  scanners:
+    twalk:
+      plugin: twalk
+      like: LogLike
+      # Run until the time limit rather than to convergence
+      sqrtR: 1.0000001
+      timeout_mins: {minutes}
+      ran_seed: 1
+Priors:
+{priors}
+Logger:
+  redirection:
+    [Default]: "default.log"
+KeyValues:
+  default_output_path: "{output_path}"
+"""
+
+# Summary printed by rank 0 at the end of the run
+steps_line = re.compile(r"TWalk took (\d+) steps with (\d+) processes in ([0-9.eE+-]+) s")
+
+
+def run_scan(gambit, mpiexec, workdir, ranks, user_lib, minutes, dimension):
+    """Run T-Walk with the given number of processes, returning the number of steps and their time."""
+    rundir = os.path.join(workdir, "ranks_" + str(ranks))
+    os.makedirs(rundir)
+    names = ["x" + str(i) for i in range(dimension)]
+    parameters = "\n".join("        " + name + ":" for name in names)
+    priors = "\n".join("  {0}_prior:\n    prior_type: flat\n    parameters: [\"gaussian::{0}\"]\n    range: [-5.0, 5.0]".format(name) for name in names)
+    # Not in the output directory, where GAMBIT writes a copy of it while the other processes may still read it
+    yaml_file = os.path.join(workdir, "ranks_" + str(ranks) + ".yaml")
+    with open(yaml_file, "w") as f:
+        f.write(yaml_template.format(user_lib=user_lib, parameters=parameters, priors=priors, minutes=minutes, output_path=rundir))
+    log_file = os.path.join(rundir, "gambit.log")
+    with open(log_file, "w") as log:
+        status = subprocess.call(shlex.split(mpiexec) + ["-np", str(ranks), gambit, "-rf", yaml_file], stdout=log, stderr=subprocess.STDOUT)
+    with open(log_file) as log:
+        match = steps_line.search(log.read())
+    if status != 0 or match is None:
+        raise RuntimeError("T-Walk failed with " + str(ranks) + " processes; see " + log_file)
+    return int(match.group(1)), float(match.group(3))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Time per step of T-Walk against the number of MPI processes.")
+    parser.add_argument("gambit", help="GAMBIT executable, built with MPI")
+    parser.add_argument("--ranks", default="8,16,32,64,128,256,512", help="comma-separated numbers of processes")
+    parser.add_argument("--mpiexec", default="mpiexec", help="MPI launcher and its options")
+    parser.add_argument("--minutes", type=float, default=0.5, help="run time of each scan")
+    parser.add_argument("--dimension", type=int, default=10, help="dimension of the gaussian")
+    parser.add_argument("--workdir", help="directory for the runs (default: a temporary directory)")
+    args = parser.parse_args()
+
+    gambit = os.path.abspath(args.gambit)
+    workdir = os.path.abspath(args.workdir) if args.workdir else tempfile.mkdtemp(prefix="gambit_twalk_scaling_")
+    if os.path.exists(workdir): shutil.rmtree(workdir)
+    os.makedirs(workdir)
+
+    # Build the user likelihood library
+    user_lib = os.path.join(workdir, "user_loglike.so")
+    with open(os.path.join(workdir, "user_loglike.c"), "w") as f:
+        f.write(user_lib_source)
+    subprocess.check_call([os.environ.get("CC", "cc"), "-shared", "-fPIC", "-o", user_lib, os.path.join(workdir, "user_loglike.c")])
+
+    # GAMBIT must run from its own directory
+    os.chdir(os.path.dirname(gambit))
+
+    print("T-Walk scaling, {0}-dimensional gaussian, {1} minutes per run (output in {2})".format(args.dimension, args.minutes, workdir))
+    print("{0:>10}{1:>12}{2:>16}{3:>16}".format("processes", "steps", "ms per step", "points/s"))
+    for ranks in [int(r) for r in args.ranks.split(",")]:
+        steps, seconds = run_scan(gambit, args.mpiexec, workdir, ranks, user_lib, args.minutes, args.dimension)
+        print("{0:>10}{1:>12}{2:>16.3f}{3:>16.0f}".format(ranks, steps, 1e3*seconds/steps, steps*ranks/seconds))
+        sys.stdout.flush()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
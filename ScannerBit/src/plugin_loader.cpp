@@ -30,6 +30,9 @@
 #include <iostream>
 #include <fstream>
 #include <stdio.h>
+#include <cstdint>
+#include <chrono>
+#include <sys/stat.h>
 
 #include "gambit/ScannerBit/scanner_utils.hpp"
 #include "gambit/ScannerBit/plugin_comparators.hpp"
@@ -39,6 +42,7 @@
 #include "gambit/Utils/screen_print_utils.hpp"
 #include "gambit/Utils/mpiwrapper.hpp"
 #include "gambit/Utils/util_functions.hpp"
+#include "gambit/Utils/startup_profiler.hpp"
 #include "gambit/ScannerBit/priors_rollcall.hpp"
 
 #ifdef HAVE_PYBIND11
@@ -345,22 +349,212 @@ namespace Gambit
                 return table.str();
             }
 
+            /// Plugin symbols found in a single plugin library, plus the information needed to tell if they are stale
+            struct plugin_library_symbols
+            {
+                long long mtime;    // Modification time of the library (ns since the epoch)
+                long long size;     // Size of the library (bytes)
+                long long recorded; // Time at which the hash was taken (ns since the epoch)
+                std::string hash;
+                std::vector<std::string> symbols;
+            };
+
+            /// Libraries modified less than this long (ns) before their hash was taken may be modified again with the
+            /// same time stamp (file systems store times with a resolution as coarse as 2 s), so their hash is checked
+            const long long racy_mtime_window = 2000000000LL;
+
+            /// Get the modification time (ns since the epoch) and size of a file; returns false if they cannot be determined
+            inline bool file_stamp(const std::string &file, long long &mtime, long long &size)
+            {
+                struct stat info;
+                mtime = size = -1;
+                if (stat(file.c_str(), &info) != 0) return false;
+                #ifdef __APPLE__
+                    mtime = (long long)info.st_mtimespec.tv_sec*1000000000LL + info.st_mtimespec.tv_nsec;
+                #else
+                    mtime = (long long)info.st_mtim.tv_sec*1000000000LL + info.st_mtim.tv_nsec;
+                #endif
+                size = (long long)info.st_size;
+                return true;
+            }
+
+            /// The current time, in ns since the epoch
+            inline long long time_now()
+            {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+            }
+
+            /// Return a hash (64-bit FNV-1a, in hex) of the contents of a file
+            inline std::string file_hash(const std::string &file)
+            {
+                std::ifstream in(file, std::ios::binary);
+                std::uint64_t h = 14695981039346656037ULL;
+                char buffer[65536];
+                while (in.read(buffer, sizeof buffer) || in.gcount() > 0)
+                {
+                    for (std::streamsize i = 0; i < in.gcount(); i++)
+                    {
+                        h ^= (unsigned char)buffer[i];
+                        h *= 1099511628211ULL;
+                    }
+                }
+                std::stringstream ss;
+                ss << std::hex << std::setw(16) << std::setfill('0') << h;
+                return ss.str();
+            }
+
+            /// Run nm on a library, and return the names of all the plugins that it defines
+            std::vector<std::string> scan_plugin_symbols(const std::string &p_str)
+            {
+                std::vector<std::string> symbols;
+                std::string str;
+                if (FILE* f = popen((std::string("nm ") + p_str + std::string(" | grep \"__gambit_plugin_pluginInit_\"")).c_str(), "r"))
+                {
+                    char buffer[1024];
+                    int n;
+                    std::stringstream ss;
+
+                    while ((n = fread(buffer, 1, sizeof buffer, f)) > 0)
+                    {
+                        ss << std::string(buffer, n);
+                    }
+
+                    while(std::getline(ss, str))
+                    {
+                        std::string::size_type pos = str.find("__gambit_plugin_pluginInit_");
+
+                        if (pos != std::string::npos &&
+                                (str.rfind(" T ", pos) != std::string::npos || str.rfind(" t ", pos) != std::string::npos))
+                        {
+                            symbols.push_back(str.substr(pos + 27, str.rfind("__") - pos - 27));
+                        }
+                    }
+
+                    pclose(f);
+                }
+                return symbols;
+            }
+
+            /// Read the on-disk cache of plugin symbols, keyed by library path
+            std::map<std::string, plugin_library_symbols> load_plugin_symbol_cache(const std::string &file)
+            {
+                std::map<std::string, plugin_library_symbols> cache;
+                if (access(file.c_str(), R_OK) == -1) return cache;
+                try
+                {
+                    YAML::Node node = YAML::LoadFile(file);
+                    for (auto it = node.begin(), end = node.end(); it != end; ++it)
+                    {
+                        // Entries written by older versions (without size and hash time) are dropped; their libraries get hashed again
+                        if (not it->second["size"] or not it->second["recorded"]) continue;
+                        plugin_library_symbols &entry = cache[it->first.as<std::string>()];
+                        entry.mtime = it->second["mtime"].as<long long>();
+                        entry.size = it->second["size"].as<long long>();
+                        entry.recorded = it->second["recorded"].as<long long>();
+                        entry.hash = it->second["hash"].as<std::string>();
+                        if (it->second["symbols"]) entry.symbols = it->second["symbols"].as<std::vector<std::string>>();
+                    }
+                }
+                catch (YAML::Exception &)
+                {
+                    // A corrupt cache just means that all libraries get scanned again.
+                    cache.clear();
+                }
+                return cache;
+            }
+
+            /// Write the on-disk cache of plugin symbols.  The file is written under a temporary name and then moved into
+            /// place, so that processes starting simultaneously never see a partially-written cache.
+            void save_plugin_symbol_cache(const std::string &file, const std::map<std::string, plugin_library_symbols> &cache)
+            {
+                YAML::Node node;
+                for (auto &&entry : cache)
+                {
+                    node[entry.first]["mtime"] = entry.second.mtime;
+                    node[entry.first]["size"] = entry.second.size;
+                    node[entry.first]["recorded"] = entry.second.recorded;
+                    node[entry.first]["hash"] = entry.second.hash;
+                    node[entry.first]["symbols"] = entry.second.symbols;
+                }
+                const std::string temp_file = file + "." + std::to_string(getpid());
+                std::ofstream out(temp_file);
+                if (not out.is_open()) return;
+                out << node << std::endl;
+                out.close();
+                if (std::rename(temp_file.c_str(), file.c_str()) != 0) std::remove(temp_file.c_str());
+            }
+
+            /// Get the plugin symbols in a library, from the cache if the library is unchanged, and otherwise by scanning it
+            /// with nm.  The library is taken to be unchanged if its modification time (to the ns) and size match the cache,
+            /// and it was last modified well before its hash was taken; otherwise it is unchanged if its hash matches.
+            plugin_library_symbols get_plugin_symbols(const std::string &lib, const std::map<std::string, plugin_library_symbols> &cache)
+            {
+                plugin_library_symbols result;
+                file_stamp(lib, result.mtime, result.size);
+                auto it = cache.find(lib);
+                if (it != cache.end() && result.mtime >= 0 && it->second.mtime == result.mtime && it->second.size == result.size &&
+                    it->second.recorded - it->second.mtime > racy_mtime_window)
+                {
+                    return it->second;
+                }
+                result.recorded = time_now();
+                result.hash = file_hash(lib);
+                if (it != cache.end() && it->second.hash == result.hash)
+                {
+                    result.symbols = it->second.symbols;
+                    return result;
+                }
+                result.symbols = scan_plugin_symbols(lib);
+                return result;
+            }
+
             Plugin_Loader::Plugin_Loader() : path(root_path + "/ScannerBit/lib/")//, python_plugin_map(pyplugin_info())
             {
+                Utils::profile_phase phase("ScannerBit plugin loading");
                 std::string p_str;
                 std::ifstream lib_list(path + "plugin_libraries.list");
                 if (lib_list.is_open())
                 {
+                    std::vector<std::string> libs;
                     while (lib_list >> p_str)
                     {
                         //if (p_str.find(".so") != std::string::npos && p_str.find(".so.") == std::string::npos)
                         p_str = path + p_str;
                         if(access(p_str.c_str(), F_OK) != -1) //can use R_OK|W_OK|X_OK also
-                            loadLibrary (p_str);
+                            libs.push_back(p_str);
                         else
                             scan_warn << "Could not find plugin library \"" << p_str << "\"." << scan_end;
                     }
 
+                    // Find the plugins in each library, scanning the libraries concurrently and
+                    // reusing the cached results for any libraries that have not changed.
+                    {
+                        Utils::profile_phase scan_phase("Plugin symbol scan");
+                        const std::string cache_file(Utils::buildtime_scratch()+"scanbit_plugin_symbols.yaml");
+                        std::map<std::string, plugin_library_symbols> cache = load_plugin_symbol_cache(cache_file);
+                        std::vector<plugin_library_symbols> lib_symbols(libs.size());
+
+                        #pragma omp parallel for schedule(dynamic)
+                        for (size_t i = 0; i < libs.size(); i++)
+                        {
+                            lib_symbols[i] = get_plugin_symbols(libs[i], cache);
+                        }
+
+                        bool cache_changed = false;
+                        for (size_t i = 0; i < libs.size(); i++)
+                        {
+                            addPlugins(libs[i], lib_symbols[i].symbols);
+                            auto it = cache.find(libs[i]);
+                            if (it == cache.end() || it->second.recorded != lib_symbols[i].recorded)
+                            {
+                                cache[libs[i]] = lib_symbols[i];
+                                cache_changed = true;
+                            }
+                        }
+                        if (cache_changed) save_plugin_symbol_cache(cache_file, cache);
+                    }
+
+                    Utils::profile_phase status_phase("Plugin status checks");
                     auto excluded_plugins = loadExcluded(Utils::buildtime_scratch()+"scanbit_excluded_libs.yaml");
                     const str linked_libs(Utils::buildtime_scratch()+"scanbit_linked_libs.yaml");
                     const str reqd_entries(Utils::buildtime_scratch()+"scanbit_reqd_entries.yaml");
@@ -474,42 +668,26 @@ namespace Gambit
                 return excluded_plugins;
             }
 
-            void Plugin_Loader::loadLibrary (const std::string &p_str, const std::string &plug)
+            void Plugin_Loader::addPlugins (const std::string &p_str, const std::vector<std::string> &symbols, const std::string &plug)
             {
-                std::string str;
-                if (FILE* f = popen((std::string("nm ") + p_str + std::string(" | grep \"__gambit_plugin_pluginInit_\"")).c_str(), "r"))
+                for (auto &&symbol : symbols)
                 {
-                    char buffer[1024];
-                    int n;
-                    std::stringstream ss;
+                    Plugin_Details temp(symbol);
 
-                    while ((n = fread(buffer, 1, sizeof buffer, f)) > 0)
+                    if (plug == "" || temp.plugin == plug)
                     {
-                        ss << std::string(buffer, n);
+                        temp.path = p_str;
+                        plugins.push_back(temp);
+                        total_plugins.push_back(temp);
                     }
-
-                    while(std::getline(ss, str))
-                    {
-                        std::string::size_type pos = str.find("__gambit_plugin_pluginInit_");
-
-                        if (pos != std::string::npos &&
-                                (str.rfind(" T ", pos) != std::string::npos || str.rfind(" t ", pos) != std::string::npos))
-                        {
-                            Plugin_Details temp(str.substr(pos + 27, str.rfind("__") - pos - 27));
-
-                            if (plug == "" || temp.plugin == plug)
-                            {
-                                temp.path = p_str;
-                                plugins.push_back(temp);
-                                total_plugins.push_back(temp);
-                            }
-                        }
-                    }
-
-                    pclose(f);
                 }
             }
 
+            void Plugin_Loader::loadLibrary (const std::string &p_str, const std::string &plug)
+            {
+                addPlugins(p_str, scan_plugin_symbols(p_str), plug);
+            }
+
             std::vector<std::string> Plugin_Loader::print_plugin_names(const std::string &plug_type) const
             {
                 std::vector<std::string> vec;
@@ -455,6 +455,8 @@ namespace Gambit
             setSize(param_size);
             
             my_subpriors.insert(my_subpriors.end(), phantomPriors.begin(), phantomPriors.end());
+
+            compile_plan();
         }  
         
         CompositePrior::CompositePrior(const std::vector<std::string> &params_in, const Options &options_in) : BasePrior(params_in)//, shown_param_names(params_in)
@@ -634,6 +636,40 @@ namespace Gambit
             setSize(param_size);
             
             my_subpriors.insert(my_subpriors.end(), phantomPriors.begin(), phantomPriors.end());
+
+            compile_plan();
+        }
+
+        // Split the sub-priors into the compiled plan (independent 1D priors, grouped by kernel)
+        // and the rest, which keep their own transform.  Sub-priors that cannot be compiled
+        // include the fixed and same_as priors, which must stay after the others as they
+        // may read parameters back out of the map.
+        void CompositePrior::compile_plan()
+        {
+            int unit_i = 0;
+            for (auto it = my_subpriors.begin(), end = my_subpriors.end(); it != end; ++it)
+            {
+                if (!(*it)->compile(plan, unit_i))
+                {
+                    uncompiled_subpriors.push_back(std::make_pair(*it, unit_i));
+                }
+                unit_i += (*it)->size();
+            }
+
+            // Where each shown parameter comes from, for transform_batch
+            std::unordered_map<std::string, int> plan_index;
+            for (int i = 0, end = plan.size(); i < end; ++i)
+                plan_index[plan.names()[i]] = i;
+
+            plan_columns.assign(plan.size(), -1);
+            for (int col = 0, end = shown_param_names.size(); col < end; ++col)
+            {
+                auto found = plan_index.find(shown_param_names[col]);
+                if (found != plan_index.end())
+                    plan_columns[found->second] = col;
+                else
+                    map_columns.push_back(std::make_pair(col, shown_param_names[col]));
+            }
         }
     } // end namespace Priors
 } // end namespace Gambit
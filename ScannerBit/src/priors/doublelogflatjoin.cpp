@@ -172,8 +172,28 @@ namespace Gambit
         scan_err << "Invalid input to DoubleLogFlatJoin prior (in 'transform'): Input parameters must be a vector of size 1! (has size=" << unitpars.size() << ")" << scan_end;
       }
 
+      output[myparameter] = transform_value(unitpars[0]);
+    }
+
+    /// Transformation of a population, one point per row
+    void DoubleLogFlatJoin::transform_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical) const
+    {
+      // Only valid for 1D parameter transformation
+      if (unit.cols()!=1)
+      {
+        scan_err << "Invalid input to DoubleLogFlatJoin prior (in 'transform_batch'): Input parameters must be a vector of size 1! (has size=" << unit.cols() << ")" << scan_end;
+      }
+
+      for (int j = 0, end = unit.rows(); j < end; ++j)
+      {
+        physical(j, 0) = transform_value(unit(j, 0));
+      }
+    }
+
+    /// Transformation of a single unit interval value
+    double DoubleLogFlatJoin::transform_value(double r) const
+    {
       double x = 0; // output (result)
-      double r = unitpars[0]; // input unit cube parameter
       double x0 = lower;
       double x1 = flat_start;
       double x2 = flat_end;
@@ -199,7 +219,7 @@ namespace Gambit
         scan_err << "Problem transforming r-value for DoubleLogFlatJoin (received "<<r<<")!" << scan_end;
       }
 
-      output[myparameter] = x;
+      return x;
     }
 
     void DoubleLogFlatJoin::inverse_transform(const std::unordered_map<std::string, double> &physical, hyper_cube_ref<double> unit) const
@@ -0,0 +1,157 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Compiled structure-of-arrays plan for
+///  transforming the unit hypercube with many
+///  independent 1D priors.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <cmath>
+
+#include "gambit/ScannerBit/prior_plan.hpp"
+#include "gambit/ScannerBit/prior_math.hpp"
+
+namespace Gambit
+{
+    namespace Priors
+    {
+        plan_group &prior_plan::group(plan_kernel kernel)
+        {
+            for (auto &g : groups)
+            {
+                if (g.kernel == kernel)
+                    return g;
+            }
+
+            groups.push_back(plan_group());
+            groups.back().kernel = kernel;
+            return groups.back();
+        }
+
+        void prior_plan::add(plan_kernel kernel, int in, const std::string &name, double width, double lower, double shift, double scale)
+        {
+            plan_group &g = group(kernel);
+            g.in.push_back(in);
+            g.out.push_back(param_names.size());
+            g.width.push_back(width);
+            g.lower.push_back(lower);
+            g.shift.push_back(shift);
+            g.scale.push_back(scale);
+            param_names.push_back(name);
+        }
+
+        void prior_plan::append(const prior_plan &plan, int offset)
+        {
+            const int out_offset = param_names.size();
+            for (const auto &other : plan.groups)
+            {
+                plan_group &g = group(other.kernel);
+                for (int i = 0, end = other.in.size(); i < end; ++i)
+                {
+                    g.in.push_back(other.in[i] + offset);
+                    g.out.push_back(other.out[i] + out_offset);
+                }
+                g.width.insert(g.width.end(), other.width.begin(), other.width.end());
+                g.lower.insert(g.lower.end(), other.lower.begin(), other.lower.end());
+                g.shift.insert(g.shift.end(), other.shift.begin(), other.shift.end());
+                g.scale.insert(g.scale.end(), other.scale.begin(), other.scale.end());
+            }
+            param_names.insert(param_names.end(), plan.param_names.begin(), plan.param_names.end());
+        }
+
+        void prior_plan::run(hyper_cube_ref<double> unit, double *physical) const
+        {
+            const double *u = unit.data();
+            const int stride = unit.innerStride();
+
+            for (const auto &g : groups)
+            {
+                const int n = g.in.size();
+                const int *in = g.in.data(), *out = g.out.data();
+                const double *width = g.width.data(), *lower = g.lower.data();
+                const double *shift = g.shift.data(), *scale = g.scale.data();
+
+                switch (g.kernel)
+                {
+                    case plan_kernel::flat:
+                        #pragma omp simd
+                        for (int i = 0; i < n; ++i)
+                            physical[out[i]] = (u[in[i]*stride]*width[i] + lower[i] - shift[i])/scale[i];
+                        break;
+
+                    case plan_kernel::log:
+                        // std::exp, as in logprior::inv, so that the plan gives the same values as RangePrior1D<logprior>
+                        #pragma omp simd
+                        for (int i = 0; i < n; ++i)
+                            physical[out[i]] = (std::exp(u[in[i]*stride]*width[i] + lower[i]) - shift[i])/scale[i];
+                        break;
+
+                    case plan_kernel::gaussian:
+                        #pragma omp simd
+                        for (int i = 0; i < n; ++i)
+                            physical[out[i]] = M_SQRT2*fast_math::erf_inv(2.*u[in[i]*stride] - 1.)*width[i] + lower[i];
+                        // Redo u = 0 or 1 (and invalid u) with the checked version, which raises the error
+                        for (int i = 0; i < n; ++i)
+                            if (!std::isfinite(physical[out[i]]))
+                                physical[out[i]] = M_SQRT2*fast_math::erf_inv_checked(2.*u[in[i]*stride] - 1.)*width[i] + lower[i];
+                        break;
+                }
+            }
+        }
+
+        void prior_plan::run_batch(hyper_cube_batch_cref<double> unit, hyper_cube_batch_ref<double> physical, const std::vector<int> &columns) const
+        {
+            const int rows = unit.rows();
+
+            for (const auto &g : groups)
+            {
+                for (int i = 0, n = g.in.size(); i < n; ++i)
+                {
+                    const int col = columns[g.out[i]];
+                    if (col < 0)
+                        continue;
+
+                    const double width = g.width[i], lower = g.lower[i];
+                    const double shift = g.shift[i], scale = g.scale[i];
+                    const auto u = unit.col(g.in[i]);
+                    auto x = physical.col(col);
+
+                    switch (g.kernel)
+                    {
+                        case plan_kernel::flat:
+                            #pragma omp simd
+                            for (int j = 0; j < rows; ++j)
+                                x[j] = (u[j]*width + lower - shift)/scale;
+                            break;
+
+                        case plan_kernel::log:
+                            // std::exp, as in logprior::inv (see run)
+                            #pragma omp simd
+                            for (int j = 0; j < rows; ++j)
+                                x[j] = (std::exp(u[j]*width + lower) - shift)/scale;
+                            break;
+
+                        case plan_kernel::gaussian:
+                            #pragma omp simd
+                            for (int j = 0; j < rows; ++j)
+                                x[j] = M_SQRT2*fast_math::erf_inv(2.*u[j] - 1.)*width + lower;
+                            for (int j = 0; j < rows; ++j)
+                                if (!std::isfinite(x[j]))
+                                    x[j] = M_SQRT2*fast_math::erf_inv_checked(2.*u[j] - 1.)*width + lower;
+                            break;
+                    }
+                }
+            }
+        }
+
+    }  // namespace Priors
+}  // namespace Gambit
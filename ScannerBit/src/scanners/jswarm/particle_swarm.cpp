@@ -37,6 +37,8 @@ namespace Gambit
     , nprocs(1)
     , global_best_value(-std::numeric_limits<double>::max())
     , mean_lnlike(-std::numeric_limits<double>::max())
+    , current_mean_lnlike(-std::numeric_limits<double>::max())
+    , quit_requested(false)
     , sfim(1.0)
     , nPar_total(0)
     , phi1_index(0)
@@ -142,16 +144,18 @@ namespace Gambit
       // Create the particles
       if (rank == 0) particles_global.resize(NP, particle(nPar_total, lowerbounds, upperbounds, rng));
       particles.resize(NP_per_rank, particle(nPar_total, lowerbounds, upperbounds, rng));
+      packed_particles.resize(NP_per_rank * (2 + 3*nPar_total));
+      if (rank == 0) packed_particles_global.resize(NP * (2 + 3*nPar_total));
 
       // Create an array to hold the indices of the discrete parameters
       if (nDiscrete != 0) discrete.resize(nDiscrete);
 
+      // Initialise the convergence measures (tracked identically on all processes)
+      conv_progress.resize(convsteps);
+      for (auto& x : conv_progress) x = 1.0;
+
       if (rank == 0)
       {
-        // Initialise the convergence measures
-        conv_progress.resize(convsteps);
-        for (auto& x : conv_progress) x = 1.0;
-
         // Done
         if (verbose > 1) cout << "j-Swarm: successfully initialised swarm with NP = " << NP
                                             << ", nPar = " << nPar << ", nDiscrete = " << nDiscrete << endl;
@@ -219,12 +223,15 @@ namespace Gambit
           // Sort out the personal bests and global best for the new population
           update_best_fits(p);
         }
-        // Collect the data from all processes to rank 0
+        // Combine the global best fit and convergence measures from all processes
         collect_data();
+        if (converged()) Scanner::scan_error().raise(LOCAL_INFO, "j-Swarm converged immediately! This is a bug, please report it.");
+
+        // Collect the particles from all processes to rank 0
+        gather_particles();
 
         if (rank == 0)
         {
-          if (converged()) Scanner::scan_error().raise(LOCAL_INFO, "j-Swarm converged immediately! This is a bug, please report it.");
           if (verbose > 1) cout << "  j-Swarm: successfully tested first generation." << endl;
 
           // Save the run settings and first generation
@@ -277,17 +284,14 @@ namespace Gambit
 
         }
 
-        // Collect the data from all processes to rank 0
+        // Combine the global best fit and convergence measures from all processes
         collect_data();
 
         // Check for convergence or early shutdown requested by the calling code
-        bool complete;
-        if (rank == 0) complete = converged();
-        #ifdef WITH_MPI
-          GMPI::Comm().Bcast_single(complete, 0);
-        #endif
-        if (complete or Scanner::Plugins::plugin_info.early_shutdown_in_progress())
+        bool complete = converged();
+        if (complete or quit_requested)
         {
+          gather_particles();
           if (rank == 0)
           {
             if (verbose > 0)
@@ -301,7 +305,11 @@ namespace Gambit
         }
 
         // Save generation
-        if (rank == 0 and gen%savecount == 0) save_generation(gen);
+        if (gen%savecount == 0)
+        {
+          gather_particles();
+          if (rank == 0) save_generation(gen);
+        }
 
       }
 
@@ -309,68 +317,91 @@ namespace Gambit
 
     }
 
-    /// Collect all particles and related data to rank 0
+    /// Combine the function call counts, global best fit and convergence measures of all processes
     void particle_swarm::collect_data()
     {
+      double sum_personal_best = 0.0;
+      for (const particle& p : particles) sum_personal_best += p.personal_best_value;
+      bool quit = Scanner::Plugins::plugin_info.early_shutdown_in_progress();
+
       #ifdef WITH_MPI
 
-        // Determine the size of temporary arrays
-        int size = (rank == 0 ? nprocs : 1);
+        MPI_Comm comm = *GMPI::Comm().get_boundcomm();
 
-        // Collect the particles from all processes to rank 0
-        // This could be sped up using MPI_Gatherv if the array temporaries seem to be causing a bottleneck.
+        // Sum the function calls, personal best fits and shutdown requests of all processes in one reduction
+        double local_sums[3] = {double(fcall), sum_personal_best, quit ? 1.0 : 0.0};
+        double global_sums[3];
+        MPI_Allreduce(local_sums, global_sums, 3, MPI_DOUBLE, MPI_SUM, comm);
+        fcall_global = int(global_sums[0]);
+        current_mean_lnlike = global_sums[1]/NP;
+        quit_requested = (global_sums[2] > 0.0);
+
+        // Find the process holding the global best fit, and share its location
+        struct { double value; int rank; } local_best = {global_best_value, rank}, global_best;
+        MPI_Allreduce(&local_best, &global_best, 1, MPI_DOUBLE_INT, MPI_MAXLOC, comm);
+        global_best_value = global_best.value;
+        GMPI::Comm().Bcast(global_best_x, nPar_total, global_best.rank);
+
+      #else
+
+        fcall_global = fcall;
+        current_mean_lnlike = sum_personal_best/NP;
+        quit_requested = quit;
+
+      #endif
+    }
+
+    /// Collect all particles to rank 0
+    void particle_swarm::gather_particles()
+    {
+      #ifdef WITH_MPI
+
+        // Pack the local particles as {lnlike}, {personal best lnlike}, {positions}, {velocities}, {personal best positions}
+        double* lnlike = packed_particles.data();
+        double* pbv = lnlike + NP_per_rank;
+        double* x = pbv + NP_per_rank;
+        double* v = x + NP_per_rank * nPar_total;
+        double* pbx = v + NP_per_rank * nPar_total;
         for (int i = 0; i < NP_per_rank; i++)
         {
-          std::vector<double> local_lnlike(size);
-          std::vector<double> local_personal_best_value(size);
-          std::vector<std::vector<double>> local_x(size, std::vector<double>(nPar_total));
-          std::vector<std::vector<double>> local_v(size, std::vector<double>(nPar_total));
-          std::vector<std::vector<double>> local_personal_best_x(size, std::vector<double>(nPar_total));
-          GMPI::Comm().Gather_single(particles.at(i).lnlike, local_lnlike, 0);
-          GMPI::Comm().Gather_single(particles.at(i).personal_best_value, local_personal_best_value, 0);
-          GMPI::Comm().Gather_arrays(particles.at(i).x[0], local_x[0][0], nPar_total, 0);
-          GMPI::Comm().Gather_arrays(particles.at(i).v[0], local_v[0][0], nPar_total, 0);
-          GMPI::Comm().Gather_arrays(particles.at(i).personal_best_x[0], local_personal_best_x[0][0], nPar_total, 0);
-
-          if (rank == 0)
-          {
-            for (int j = 0; j < nprocs; j++)
-            {
-              particles_global.at(NP_per_rank * j + i).lnlike = local_lnlike[j];
-              particles_global.at(NP_per_rank * j + i).personal_best_value = local_personal_best_value[j];
-              for (int k = 0; k < nPar_total; k++)
-              {
-                particles_global.at(NP_per_rank * j + i).x.at(k) = local_x[j][k];
-                particles_global.at(NP_per_rank * j + i).v.at(k) = local_v[j][k];
-                particles_global.at(NP_per_rank * j + i).personal_best_x.at(k) = local_personal_best_x[j][k];
-              }
-            }
-          }
+          const particle& p = particles[i];
+          lnlike[i] = p.lnlike;
+          pbv[i] = p.personal_best_value;
+          std::copy(p.x.begin(), p.x.end(), x + i * nPar_total);
+          std::copy(p.v.begin(), p.v.end(), v + i * nPar_total);
+          std::copy(p.personal_best_x.begin(), p.personal_best_x.end(), pbx + i * nPar_total);
         }
 
-        // Sum fcall from all processes
-        GMPI::Comm().Reduce(fcall, fcall_global, MPI_SUM, 0);
+        // Every process holds the same number of particles, so one gather of the blocks suffices
+        GMPI::Comm().Gather(packed_particles, packed_particles_global, 0);
 
-        // Collect the global best fit across all processes
-        int global_best_rank;
-        std::vector<double> global_best_values(size);
-        GMPI::Comm().Gather_single(global_best_value, global_best_values, 0);
         if (rank == 0)
         {
-          auto max_it = std::max_element(global_best_values.begin(), global_best_values.end());
-          global_best_rank = std::distance(global_best_values.begin(), max_it);
+          const int block = packed_particles.size();
+          for (int j = 0; j < nprocs; j++)
+          {
+            lnlike = packed_particles_global.data() + j * block;
+            pbv = lnlike + NP_per_rank;
+            x = pbv + NP_per_rank;
+            v = x + NP_per_rank * nPar_total;
+            pbx = v + NP_per_rank * nPar_total;
+            for (int i = 0; i < NP_per_rank; i++)
+            {
+              particle& p = particles_global.at(NP_per_rank * j + i);
+              p.lnlike = lnlike[i];
+              p.personal_best_value = pbv[i];
+              p.x.assign(x + i * nPar_total, x + (i+1) * nPar_total);
+              p.v.assign(v + i * nPar_total, v + (i+1) * nPar_total);
+              p.personal_best_x.assign(pbx + i * nPar_total, pbx + (i+1) * nPar_total);
+            }
+          }
         }
-        GMPI::Comm().Bcast_single(global_best_rank, 0);
-        GMPI::Comm().Bcast_single(global_best_value, global_best_rank);
-        GMPI::Comm().Bcast(global_best_x, nPar_total, global_best_rank);
 
       #else
 
-        fcall_global = fcall;
         particles_global = particles;
 
       #endif
-
     }
 
     /// Update a particle's velocity and use that to update its position
@@ -438,8 +469,8 @@ namespace Gambit
     bool particle_swarm::converged()
     {
 
-      // Find the mean value of the personal best likelihoods
-      double current_mean = std::accumulate(particles_global.begin(), particles_global.end(), 0.0, [](int i, particle& p){return i+p.personal_best_value;})/NP;
+      // Mean value of the personal best likelihoods, as combined across all processes by collect_data
+      double current_mean = current_mean_lnlike;
       // Find the fractional improvement between this generation and last generation
       double mean_ratio = current_mean/mean_lnlike;
       double fractional_diff = (mean_ratio <= 1.0) ? 1.0 - mean_ratio : 1.0;
@@ -450,7 +481,7 @@ namespace Gambit
       conv_progress.push_back(fractional_diff);
       // Average over the generations stored
       sfim = std::accumulate(conv_progress.begin(), conv_progress.end(), 0.0)/convsteps;
-      if (verbose > 1) cout << "  j-Swarm: Smoothed fractional improvement of the mean personal best: " << sfim << endl;
+      if (rank == 0 and verbose > 1) cout << "  j-Swarm: Smoothed fractional improvement of the mean personal best: " << sfim << endl;
 
       // Compare to threshold value
       return (sfim < convthresh);
@@ -22,8 +22,11 @@
 #include "gambit/Utils/end_ignore_warnings.hpp"
 #endif
 
+#include <algorithm>
+#include <functional>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -63,6 +66,155 @@ double get_node_value(YAML::Node node, std::string key, double default_)
   return default_;
 }
 
+/**
+ * @brief Central finite-difference gradient of a function on the unit hypercube, with the
+ * stencil points shared between MPI processes and OpenMP threads
+ *
+ * Only rank 0 runs Minuit2. Whenever it asks for a gradient at a new point, the point is
+ * broadcast to the other processes, which wait in serve() and evaluate their share of the
+ * stencil; finish() releases them and sends them the result of the minimization. Minuit2
+ * asks for one component at a time, so the whole gradient is computed on the first request
+ * at a new point. Near the edges of the hypercube the stencil is truncated so that the
+ * function is only called inside it.
+ */
+class parallel_gradient
+{
+ public:
+  parallel_gradient(std::function<double(const std::vector<double>&)> func, int dim, double step, int threads) :
+    func(func), dim(dim), step(step), threads(threads), rank(0), size(1),
+    x0(dim), grad(dim), values(2 * dim), valid(false)
+  {
+#ifdef WITH_MPI
+    // a communicator of its own, so that the commands cannot mix with other messages
+    MPI_Comm_dup(MPI_COMM_WORLD, &comm);
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+#endif
+  }
+
+  parallel_gradient(const parallel_gradient&) = delete;
+  parallel_gradient& operator=(const parallel_gradient&) = delete;
+
+  ~parallel_gradient()
+  {
+#ifdef WITH_MPI
+    MPI_Comm_free(&comm);
+#endif
+  }
+
+  /** @brief Whether this process runs the minimization */
+  bool master() const { return rank == 0; }
+
+  /** @brief Component icoord of the gradient at x. Rank 0 only */
+  double operator()(const double* x, unsigned int icoord)
+  {
+    if (!valid || !std::equal(x, x + dim, x0.begin()))
+    {
+      std::copy(x, x + dim, x0.begin());
+#ifdef WITH_MPI
+      int command = gradient_command;
+      MPI_Bcast(&command, 1, MPI_INT, 0, comm);
+      MPI_Bcast(x0.data(), dim, MPI_DOUBLE, 0, comm);
+#endif
+      compute();
+    }
+    return grad[icoord];
+  }
+
+  /** @brief Evaluate stencil points for rank 0 until it calls finish(). Returns the best fit and status it sends */
+  int serve(std::vector<double>& best_fit)
+  {
+    int status = 0;
+#ifdef WITH_MPI
+    for (;;)
+    {
+      int command;
+      MPI_Bcast(&command, 1, MPI_INT, 0, comm);
+      if (command == finish_command)
+      {
+        break;
+      }
+      MPI_Bcast(x0.data(), dim, MPI_DOUBLE, 0, comm);
+      compute();
+    }
+    best_fit.resize(dim);
+    MPI_Bcast(best_fit.data(), dim, MPI_DOUBLE, 0, comm);
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+#else
+    (void)best_fit;
+#endif
+    return status;
+  }
+
+  /** @brief Release the other processes from serve(), sending them the best fit and status. Rank 0 only */
+  void finish(std::vector<double>& best_fit, int status)
+  {
+#ifdef WITH_MPI
+    int command = finish_command;
+    MPI_Bcast(&command, 1, MPI_INT, 0, comm);
+    MPI_Bcast(best_fit.data(), dim, MPI_DOUBLE, 0, comm);
+    MPI_Bcast(&status, 1, MPI_INT, 0, comm);
+#else
+    (void)best_fit;
+    (void)status;
+#endif
+  }
+
+ private:
+  enum commands {gradient_command, finish_command};
+
+  std::function<double(const std::vector<double>&)> func;
+  int dim;
+  double step;
+  int threads;
+  int rank;
+  int size;
+#ifdef WITH_MPI
+  MPI_Comm comm;
+#endif
+  std::vector<double> x0;
+  std::vector<double> grad;
+  std::vector<double> values;
+  bool valid;
+
+  double lower(double x) const { return std::max(0., x - step); }
+  double upper(double x) const { return std::min(1., x + step); }
+
+  /** @brief Evaluate this process's share of the stencil around x0, and on rank 0 the gradient */
+  void compute()
+  {
+    // stencil point k moves coordinate k / 2 down (k even) or up (k odd)
+    const int n = 2 * dim;
+    std::fill(values.begin(), values.end(), 0.);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(threads)
+    for (int k = rank; k < n; k += size)
+    {
+      std::vector<double> v(x0);
+      const int i = k / 2;
+      v[i] = k % 2 ? upper(x0[i]) : lower(x0[i]);
+      values[k] = func(v);
+    }
+
+#ifdef WITH_MPI
+    if (rank == 0)
+    {
+      MPI_Reduce(MPI_IN_PLACE, values.data(), n, MPI_DOUBLE, MPI_SUM, 0, comm);
+    }
+    else
+    {
+      MPI_Reduce(values.data(), nullptr, n, MPI_DOUBLE, MPI_SUM, 0, comm);
+    }
+#endif
+
+    for (int i = 0; i < dim; i++)
+    {
+      grad[i] = (values[2 * i + 1] - values[2 * i]) / (upper(x0[i]) - lower(x0[i]));
+    }
+    valid = true;
+  }
+};
+
 scanner_plugin(minuit2, version(6, 23, 01))
 {
   reqd_libraries("Minuit2", "Minuit2Math");
@@ -97,6 +249,14 @@ scanner_plugin(minuit2, version(6, 23, 01))
     const double precision{get_inifile_value<double>("precision", 0.0001)};
     const int print_level{get_inifile_value<int>("print_level", 1)};
     const int strategy{get_inifile_value<int>("strategy", 2)};
+    const std::string gradient{get_inifile_value<std::string>("gradient", "minuit")};
+    const double gradient_step{get_inifile_value<double>("gradient_step", 0.0001)};
+    const int gradient_threads{get_inifile_value<int>("gradient_threads", 1)};
+
+    if (gradient != "minuit" && gradient != "parallel")
+    {
+      scan_error().raise(LOCAL_INFO, "Minuit2: Unknown gradient: " + gradient);
+    }
 
     // get starting point (optional). It can be written in hypercube or physical
     // parameters. Default is center of hypercube for each parameter
@@ -235,8 +395,27 @@ scanner_plugin(minuit2, version(6, 23, 01))
       return -2. * model(v);
     };
 
-    ROOT::Math::Functor f(chi_squared, dim);
-    min->SetFunction(f);
+    // either let Minuit2 differentiate numerically, or hand it the gradient computed over
+    // all processes and threads. The minimizer keeps a reference to the function, so it
+    // must outlive the minimization
+    std::unique_ptr<ROOT::Math::Functor> f;
+    std::unique_ptr<ROOT::Math::GradFunctor> fg;
+    std::unique_ptr<parallel_gradient> g;
+    if (gradient == "parallel")
+    {
+      auto chi_squared_vector = [&model] (const std::vector<double>& v)
+      {
+        return -2. * model(v);
+      };
+      g.reset(new parallel_gradient(chi_squared_vector, dim, gradient_step, gradient_threads));
+      fg.reset(new ROOT::Math::GradFunctor(chi_squared, std::ref(*g), dim));
+      min->SetFunction(*fg);
+    }
+    else
+    {
+      f.reset(new ROOT::Math::Functor(chi_squared, dim));
+      min->SetFunction(*f);
+    }
 
     // set the free variables to be minimized
 
@@ -255,32 +434,41 @@ scanner_plugin(minuit2, version(6, 23, 01))
       }
     }
 
-    // do the minimization
-    min->Minimize();
+    // do the minimization. With the parallel gradient only rank 0 runs Minuit2, and the other
+    // processes evaluate stencil points for it until it sends them the result
+    std::vector<double> v(dim);
+    int status = 0;
+    if (g && !g->master())
+    {
+      status = g->serve(v);
+    }
+    else
+    {
+      min->Minimize();
 
-    std::cout << "minimum chi-squared = " << min->MinValue() << std::endl;
+      std::cout << "minimum chi-squared = " << min->MinValue() << std::endl;
 
-    const double *best_fit_hypercube = min->X();
-    for (int i = 0; i < dim; i++)
-    {
-      std::cout << "best-fit hypercube " << i << " = "
-                << best_fit_hypercube[i] << std::endl;
+      const double *best_fit_hypercube = min->X();
+      std::copy(best_fit_hypercube, best_fit_hypercube + dim, v.begin());
+      status = min->Status();
+      if (g)
+      {
+        g->finish(v, status);
+      }
     }
 
-    // convert result to physical parameters
-    std::vector<double> v;
     for (int i = 0; i < dim; i++)
     {
-      v.push_back(best_fit_hypercube[i]);
+      std::cout << "best-fit hypercube " << i << " = " << v[i] << std::endl;
     }
 
+    // convert result to physical parameters
     for (auto &&par : model->transform(v))
     {
       std::cout << "best-fit physical " << par.first << " = " << par.second << std::endl;
     }
 
     // whether successful
-    const int status = min->Status();
     switch (status) {
       case 0:
         break;
@@ -20,6 +20,8 @@
 #include "gambit/Utils/end_ignore_warnings.hpp"
 #endif
 
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -27,6 +29,7 @@
 #include <sstream>
 
 #include "gambit/ScannerBit/scanner_plugin.hpp"
+#include "gambit/ScannerBit/index_scheduler.hpp"
 
 inline std::vector<std::unordered_set<std::string>> parse_sames(const std::vector<std::string> &params)
 {
@@ -61,19 +64,9 @@ scanner_plugin(grid, version(1, 0, 0))
     int plugin_main()
     {
         int ma = get_dimension();
-        int numtasks;
-        int rank;
-        
-#ifdef WITH_MPI
-        MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-#else
-        numtasks = 1;
-        rank = 0;
-#endif
 
         std::vector<int> N = get_inifile_value<std::vector<int>>("grid_pts");
-        int NTot = 1;
+        std::uint64_t NTot = 1;
 
         for (auto it = N.begin(), end = N.end(); it != end; it++)
         {
@@ -81,6 +74,9 @@ scanner_plugin(grid, version(1, 0, 0))
                 *it = -*it;
             else if (*it == 0)
                 *it= 1;
+
+            if (NTot > std::numeric_limits<std::uint64_t>::max() / *it)
+                scan_err << "Grid Scanner:  The total number of grid points exceeds 2^64." << scan_end;
             NTot *= *it;
         }
 
@@ -141,9 +137,12 @@ scanner_plugin(grid, version(1, 0, 0))
         LogLike = get_purpose(get_inifile_value<std::string>("like"));
         std::vector<double> vec(ma, 0.0);
 
-        for (int i = rank, end = NTot; i < end; i+=numtasks)
+        bool dynamic = get_inifile_value<bool>("dynamic_schedule", false);
+        unsigned long long chunk = get_inifile_value<unsigned long long>("chunk_size", 1);
+
+        Gambit::Scanner::for_each_index(NTot, dynamic, chunk, [&](unsigned long long i)
         {
-            int n = i;
+            std::uint64_t n = i;
             for (int j = 0; j < ma; j++)
             {
                 if (N[j] == 1)
@@ -155,7 +154,7 @@ scanner_plugin(grid, version(1, 0, 0))
             }
 
             LogLike(vec);
-        }
+        }, [&]{ LogLike->getPrinter().poll(); });
 
         return 0;
     }
@@ -0,0 +1,105 @@
+//  GAMBIT: Global and Modular BSM Inference Tool
+//  *********************************************
+///  \file
+///
+///  Quasi-random sampler (scrambled Sobol,
+///  Halton and Latin hypercube designs).
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifdef WITH_MPI
+#include "gambit/Utils/begin_ignore_warnings_mpi.hpp"
+#include "mpi.h"
+#include "gambit/Utils/end_ignore_warnings.hpp"
+#endif
+
+#include <cstdint>
+#include <vector>
+#include <string>
+#include <iostream>
+
+#include "gambit/ScannerBit/scanner_plugin.hpp"
+#include "gambit/ScannerBit/index_scheduler.hpp"
+#include "gambit/ScannerBit/scanners/simple/quasi_random.hpp"
+#include "gambit/Utils/threadsafe_rng.hpp"
+
+scanner_plugin(quasi_random, version(1, 0, 0))
+{
+    like_ptr LogLike;
+    std::uint64_t num, seed;
+    std::string type;
+    bool scramble, dynamic;
+    unsigned long long chunk;
+    int dim, numtasks, rank;
+
+    plugin_constructor
+    {
+        LogLike = get_purpose(get_inifile_value<std::string>("like"));
+        num = get_inifile_value<std::uint64_t>("point_number", 1000);
+        type = get_inifile_value<std::string>("sequence", "sobol");
+        scramble = get_inifile_value<bool>("scramble", true);
+        long long seed_in = get_inifile_value<long long>("seed", -1);
+        dim = get_dimension();
+        dynamic = get_inifile_value<bool>("dynamic_schedule", false);
+        chunk = get_inifile_value<unsigned long long>("chunk_size", 1);
+
+#ifdef WITH_MPI
+        MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#else
+        numtasks = 1;
+        rank = 0;
+#endif
+
+        // All processes must scramble with the same seed, so draw it on the master and share it
+        seed = seed_in < 0 ? std::uint64_t(Gambit::Random::draw()*9007199254740992.0) : std::uint64_t(seed_in);
+#ifdef WITH_MPI
+        MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+#endif
+
+        if (type != "sobol" && type != "halton" && type != "lhs")
+            scan_err << "Quasi-random Scanner:  Unknown sequence \"" << type << "\".  Choose sobol, halton or lhs." << scan_end;
+
+        if (type == "sobol" && dim > Gambit::Scanner::QuasiRandom::sobol_sequence::max_dimension)
+            scan_err << "Quasi-random Scanner:  Sobol sequences are only available in up to "
+                     << Gambit::Scanner::QuasiRandom::sobol_sequence::max_dimension << " dimensions (got " << dim
+                     << ").  Use the halton or lhs sequence instead." << scan_end;
+    }
+
+    int plugin_main ()
+    {
+        auto seq = Gambit::Scanner::QuasiRandom::make_sequence(type, dim, scramble, seed, num);
+
+        if (num > seq->max_points())
+            scan_err << "Quasi-random Scanner:  point_number (" << num << ") exceeds the length of the "
+                     << type << " sequence (" << seq->max_points() << ")." << scan_end;
+
+        if (rank == 0)
+            std::cout << "Entering quasi-random sampler (" << type << (scramble ? ", scrambled" : "") << ", seed " << seed << ")."
+                      << "\n\tnumber of points to calculate:  " << num << std::endl;
+
+        std::vector<double> a(dim);
+
+        // Processes take interleaved (or, dynamically, consecutive) sequence indices, so the points
+        // finished at any time (e.g. when a run is interrupted) are close to a prefix of the sequence
+        Gambit::Scanner::for_each_index(num, dynamic, chunk, [&](unsigned long long k)
+        {
+            seq->point(k, a);
+            LogLike(a);
+
+            // Only rank 0 reports.  Statically it takes every numtasks-th index, so this is every 1000 of its
+            // points; with dynamic_schedule it only coordinates, and reports nothing.
+            if (rank == 0 && k%(1000ULL*numtasks) == 0)
+                std::cout << "points:  " << k << " / " << num << std::endl;
+        }, [&]{ LogLike->getPrinter().poll(); });
+
+        return 0;
+    }
+}
@@ -25,18 +25,23 @@
 #include <iostream>
 
 #include "gambit/ScannerBit/scanner_plugin.hpp"
+#include "gambit/ScannerBit/index_scheduler.hpp"
 #include "gambit/Utils/threadsafe_rng.hpp"
   
 scanner_plugin(random, version(1, 0, 0))
 {
     like_ptr LogLike;
     int num, dim, numtasks, rank;
+    bool dynamic;
+    unsigned long long chunk;
     
     plugin_constructor
     {
         LogLike = get_purpose(get_inifile_value<std::string>("like"));
         num = get_inifile_value<int>("point_number", 10);
         dim = get_dimension();
+        dynamic = get_inifile_value<bool>("dynamic_schedule", false);
+        chunk = get_inifile_value<unsigned long long>("chunk_size", 1);
         
 #ifdef WITH_MPI
         MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
@@ -51,19 +56,25 @@ scanner_plugin(random, version(1, 0, 0))
     {
         std::vector<double> a(dim);
 
-        std::cout << "Entering random sampler." << "\n\tnumber of points to calculate:  " << num << std::endl;
-        
-        for (int k = 0; k < num; k++)
+        if (rank == 0)
+            std::cout << "Entering random sampler." << "\n\tnumber of points to calculate:  " << num << std::endl;
+
+        // point_number points per process, as in the static schedule
+        const unsigned long long total = (unsigned long long)num*numtasks;
+
+        Gambit::Scanner::for_each_index(total, dynamic, chunk, [&](unsigned long long k)
         {
-            for (int i = rank; i < dim; i+=numtasks)
+            for (int i = 0; i < dim; i++)
             {
                 a[i] = Gambit::Random::draw();
             }
             LogLike(a);
             
-            if (k%1000 == 0)
-                std::cout << "points:  " << k << " / " << num << std::endl;
-        }
+            // Only rank 0 reports.  Statically it takes every numtasks-th index, so this is every 1000 of its
+            // points; with dynamic_schedule it only coordinates, and reports nothing.
+            if (rank == 0 && k%(1000ULL*numtasks) == 0)
+                std::cout << "points:  " << k << " / " << total << std::endl;
+        }, [&]{ LogLike->getPrinter().poll(); });
         
         return 0;
     }
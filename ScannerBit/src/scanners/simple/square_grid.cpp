@@ -20,6 +20,8 @@
 #include "gambit/Utils/end_ignore_warnings.hpp"
 #endif
 
+#include <cstdint>
+#include <limits>
 #include <vector>
 #include <string>
 #include <cmath>
@@ -28,30 +30,33 @@
 #include <sstream>
 
 #include "gambit/ScannerBit/scanner_plugin.hpp"
+#include "gambit/ScannerBit/index_scheduler.hpp"
 
 scanner_plugin(square_grid, version(1, 0, 0))
 {
     int plugin_main()
     {
-        int rank, numtasks;
         int N = std::abs(get_inifile_value<int>("grid_pts", 2));
         if (N == 0) N = 1;
         int ma = get_dimension();
         
-#ifdef WITH_MPI
-        MPI_Comm_size(MPI_COMM_WORLD, &numtasks);
-        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-#else
-        numtasks = 1;
-        rank = 0;
-#endif
-        
         like_ptr LogLike = get_purpose(get_inifile_value<std::string>("like"));
         std::vector<double> vec(ma, 0.0);
 
-        for (int i = rank, end = std::pow(N, ma); i < end; i+=numtasks)
+        std::uint64_t NTot = 1;
+        for (int j = 0; j < ma; j++)
+        {
+            if (NTot > std::numeric_limits<std::uint64_t>::max() / N)
+                scan_err << "Square Grid Scanner:  The total number of grid points exceeds 2^64." << scan_end;
+            NTot *= N;
+        }
+
+        bool dynamic = get_inifile_value<bool>("dynamic_schedule", false);
+        unsigned long long chunk = get_inifile_value<unsigned long long>("chunk_size", 1);
+
+        Gambit::Scanner::for_each_index(NTot, dynamic, chunk, [&](unsigned long long i)
         {
-            int n = i;
+            std::uint64_t n = i;
             for (int j = 0; j < ma; j++)
             {
                 if (N == 1)
@@ -63,7 +68,7 @@ scanner_plugin(square_grid, version(1, 0, 0))
             }
 
             LogLike(vec);
-        }
+        }, [&]{ LogLike->getPrinter().poll(); });
 
         return 0;
     }
@@ -28,6 +28,7 @@
 #include <sstream>
 
 #include "gambit/ScannerBit/scanner_plugin.hpp"
+#include "gambit/ScannerBit/population_evaluator.hpp"
 #include "gambit/Utils/threadsafe_rng.hpp"
 
 scanner_plugin(toy_mcmc, version(1, 0, 0))
@@ -79,59 +80,48 @@ scanner_plugin(toy_mcmc, version(1, 0, 0))
 
         chisq = -LogLike(a);
         id = LogLike->getPtID();
-#ifdef WITH_MPI
         if (numtasks > 1) 
         {
-            int countsofar = 0, idnext;
-            MPI_Status stat;
-            std::vector<unsigned long long int> buffer_ids(N);
-            std::vector<double> buffer_chisqs(N);
+            // Proposals are independent of the current point, so they are drawn and evaluated
+            // in populations; rank 0 then runs the accept/reject chain over them.
+            Gambit::Scanner::population_evaluator evaluator(LogLike, get_inifile_value<bool>("dynamic_schedule", false));
+            std::vector<std::vector<double>> batch;
+            std::vector<double> likes;
+            std::vector<unsigned long long int> ids;
+            std::vector<int> ranks;
+            int idrank = rank;
             
             do
             {
-                int countsofarnext = N-count;
-                if (countsofarnext < numtasks)
-                    countsofarnext = numtasks;
-                
-                if (countsofarnext != countsofar)
-                {
-                    countsofar = countsofarnext;
-                    buffer_ids.resize(countsofar);
-                    buffer_chisqs.resize(countsofar);
-                }
+                int countsofar = N-count;
+                if (countsofar < numtasks)
+                    countsofar = numtasks;
                 
                 total += countsofar;
-                for (int i = rank, end = countsofar; i < end; i+=numtasks)
+                if (rank == 0)
                 {
-                    for (auto &&val : a)
+                    batch.resize(countsofar);
+                    for (auto &&pt : batch)
                     {
-                        val = Gambit::Random::draw();
+                        pt.resize(ma);
+                        for (auto &&val : pt)
+                            val = Gambit::Random::draw();
                     }
-
-                    buffer_chisqs[i] = -LogLike(a);
-                    buffer_ids[i] = LogLike->getPtID();
                 }
                 
+                evaluator.evaluate(batch, likes, ids, ranks);
+                
                 if (rank == 0)
                 {
-                    for (int i = 0, end = countsofar; i < end; i++)
-                    {
-                        int tag = i%numtasks;
-                        if (tag != 0)
-                        {
-                            MPI_Recv (&buffer_ids[i], 1, MPI_UNSIGNED_LONG_LONG, tag, tag, MPI_COMM_WORLD, &stat);
-                            MPI_Recv (&buffer_chisqs[i], 1, MPI_DOUBLE, tag, tag, MPI_COMM_WORLD, &stat);
-                        }
-                    }
-                
-                    for (auto &&iter : zip(buffer_ids, buffer_chisqs))
+                    for (int i = 0; i < countsofar; i++)
                     {
-                        boost::tie(idnext, chisqnext) = iter;
+                        chisqnext = -likes[i];
                         ans = chisqnext - chisq;
                         if ((ans <= 0.0)||(-std::log(Gambit::Random::draw()) >= ans))
                         {
-                            out_stream->print(mult, "mult", rank, id);
-                            id = idnext;
+                            out_stream->print(mult, "mult", idrank, id);
+                            id = ids[i];
+                            idrank = ranks[i];
                             chisq = chisqnext;
                             mult = 1;
                             count++;
@@ -144,18 +134,11 @@ scanner_plugin(toy_mcmc, version(1, 0, 0))
                     
                     std::cout << "points = " << count << "; accept ratio = " << (double)count/(double)total << std::endl;
                 }
-                else
-                {
-                    for (int i = rank, end = countsofar; i < end; i+=numtasks)
-                    {
-                        MPI_Send (&buffer_ids[i], 1, MPI_UNSIGNED_LONG_LONG, 0, rank, MPI_COMM_WORLD);
-                        MPI_Send (&buffer_chisqs[i], 1, MPI_DOUBLE, 0, rank, MPI_COMM_WORLD);
-                    }
-                }
+                
+                evaluator.broadcast(count);
             }
             while(count < N); 
         } else
-#endif
         do
         {
             total++;
@@ -24,6 +24,8 @@
 #include "gambit/Utils/end_ignore_warnings.hpp"
 #endif
 
+#include <cstring>
+
 #include "plugin_interface.hpp"
 #include "scanner_plugin.hpp"
 #include "twalk.hpp"
@@ -88,6 +90,117 @@ namespace Gambit
             unsigned long long int id;
         };
 
+#ifdef WITH_MPI
+        /// State of a chain as exchanged between processes; followed in the exchange buffer by the chain's point
+        struct chain_state
+        {
+            unsigned long long int id;
+            double chisq;
+            int chain;
+            int mult;
+            int count;
+            int rank;
+        };
+
+        /**
+        * @brief Shares the chains updated by every process with a single MPI_Allgatherv.
+        *
+        * Each process packs one contiguous block: {quit, stop} flags, then a chain_state and
+        * point for every chain it updated, then (optionally) control data as ints.  The block
+        * sizes follow from the numbers of chains and ints that each process sends, which all
+        * processes know in advance, so no sizes need to be exchanged.
+        */
+        class chain_exchange
+        {
+        private:
+            int dim;
+            int chain_bytes;
+            std::vector<char> sendbuf, recvbuf;
+            std::vector<int> displs;
+
+            template <typename T>
+            void append(const T *data, std::size_t n)
+            {
+                const char *p = reinterpret_cast<const char *>(data);
+                sendbuf.insert(sendbuf.end(), p, p + n*sizeof(T));
+            }
+
+            const char *block(int r, int nchains) const
+            {
+                return &recvbuf[displs[r] + 2*sizeof(int) + nchains*chain_bytes];
+            }
+
+        public:
+            chain_exchange(int dim, int numtasks) : dim(dim), chain_bytes(sizeof(chain_state) + dim*sizeof(double)), displs(numtasks) {}
+
+            /// Size of a block holding nchains chains and nints ints
+            int block_size(int nchains, int nints) const
+            {
+                return 2*sizeof(int) + nchains*chain_bytes + nints*sizeof(int);
+            }
+
+            /// Start a new block
+            void begin(bool quit, bool stop)
+            {
+                int flags[2] = {quit, stop};
+                sendbuf.clear();
+                append(flags, 2);
+            }
+
+            void add_chain(const chain_state &state, const std::vector<double> &a)
+            {
+                append(&state, 1);
+                append(a.data(), dim);
+            }
+
+            void add_ints(const std::vector<int> &ints)
+            {
+                append(ints.data(), ints.size());
+            }
+
+            /// Share the blocks; sizes[r] is the size of the block of process r.  Collective.
+            void exchange(const std::vector<int> &sizes)
+            {
+                int total = 0;
+                for (int r = 0, end = sizes.size(); r < end; r++)
+                {
+                    displs[r] = total;
+                    total += sizes[r];
+                }
+                recvbuf.resize(total);
+                MPI_Allgatherv(sendbuf.data(), sendbuf.size(), MPI_BYTE, recvbuf.data(), sizes.data(), displs.data(), MPI_BYTE, MPI_COMM_WORLD);
+            }
+
+            bool quit(int r) const
+            {
+                int flag;
+                std::memcpy(&flag, &recvbuf[displs[r]], sizeof(int));
+                return flag;
+            }
+
+            bool stop(int r) const
+            {
+                int flag;
+                std::memcpy(&flag, &recvbuf[displs[r] + sizeof(int)], sizeof(int));
+                return flag;
+            }
+
+            /// Read the k-th chain of the block of process r
+            void chain(int r, int k, chain_state &state, std::vector<double> &a) const
+            {
+                const char *p = block(r, k);
+                std::memcpy(&state, p, sizeof(chain_state));
+                std::memcpy(a.data(), p + sizeof(chain_state), dim*sizeof(double));
+            }
+
+            /// Read ints, starting offset ints after the nchains chains of the block of process r
+            void ints(int r, int nchains, std::vector<int> &out, int offset = 0) const
+            {
+                std::memcpy(out.data(), block(r, nchains) + offset*sizeof(int), out.size()*sizeof(int));
+            }
+        };
+#endif
+
         void TWalk(Gambit::Scanner::like_ptr LogLike,
                    Gambit::Scanner::printer_interface &printer,
                    Gambit::Scanner::resume_params_func set_resume_params,
@@ -159,6 +272,76 @@ namespace Gambit
                 gDev.push_back(new RanNumGen(proj, dimension, din, alim, alimt, div, rand));
             }
 
+            #ifdef WITH_MPI
+                chain_exchange exchange(dimension, numtasks);
+                chain_state state;
+
+                // Pack the state of chain i
+                auto add_chain = [&](int i)
+                {
+                    state = {ids[i], chisq[i], i, mult[i], count[i], ranks[i]};
+                    exchange.add_chain(state, a0[i]);
+                };
+
+                // Unpack the chains of every process, the quit flags, and the chain assignments from rank 0
+                auto read_chains = [&](const std::vector<int> &nchains)
+                {
+                    for (int r = 0; r < numtasks; r++)
+                    {
+                        quit = quit or exchange.quit(r);
+                        for (int k = 0; k < nchains[r]; k++)
+                        {
+                            exchange.chain(r, k, state, aNext);
+                            int c = state.chain;
+                            a0[c] = aNext;
+                            chisq[c] = state.chisq;
+                            mult[c] = state.mult;
+                            count[c] = state.count;
+                            ranks[c] = state.rank;
+                            ids[c] = state.id;
+                        }
+                    }
+                    exchange.ints(0, nchains[0], talls);
+                    exchange.ints(0, nchains[0], tints, talls.size());
+                };
+
+                // Choose the chains to update in the next step (on rank 0): numtasks distinct chains
+                // in talls[0..numtasks), partner chains in talls[numtasks..), the rest at the start of tints
+                auto assign_chains = [&]()
+                {
+                    int j = NChains;
+                    for(int i = 0; i < numtasks; i++)
+                    {
+                        int temp = int((j--)*gDev[0]->Doub());
+                        talls[i] = tints[temp];
+                        tints[temp] = tints[j];
+                        tints[j] = talls[i];
+                    }
+
+                    for(int i = numtasks, end = talls.size(); i < end; i++)
+                    {
+                        talls[i] = tints[int(j*gDev[0]->Doub())];
+                    }
+                };
+
+                // Rank 0 also sends the chain assignments for the next step
+                const int nctrl = talls.size() + tints.size();
+                auto add_control = [&]()
+                {
+                    if (rank == 0)
+                    {
+                        assign_chains();
+                        exchange.add_ints(talls);
+                        exchange.add_ints(tints);
+                    }
+                };
+
+                // In the main loop, every process sends the one chain it updated
+                std::vector<int> step_chains(numtasks, 1), step_sizes(numtasks);
+                for (int r = 0; r < numtasks; r++)
+                    step_sizes[r] = exchange.block_size(1, r == 0 ? nctrl : 0);
+            #endif
+
             // Try opening the temporary file for saving the mutliplicities etc.
             std::ofstream temp_file_out;
             std::string filename = set_resume_params.get_temp_file_name("temp");
@@ -170,16 +353,32 @@ namespace Gambit
                     scan_err << "Problem opening temp file " << filename << " in TWalk!" << scan_end;
                 
                 #ifdef WITH_MPI
-                    for (int i = 0; i < numtasks; i++)
+                    // Share the chain each process was updating when the run stopped
+                    exchange.begin(false, false);
+                    add_chain(talls[rank]);
+                    add_control();
+                    exchange.exchange(step_sizes);
+                    read_chains(step_chains);
+
+                    // The convergence statistics are tracked on every process, but take rank 0's
+                    // in case the run was saved when only rank 0 kept them
+                    std::vector<double> stats;
+                    if (rank == 0)
                     {
-                        MPI_Barrier(MPI_COMM_WORLD);
-                        MPI_Bcast (c_ptr(a0[talls[i]]), a0[talls[i]].size(), MPI_DOUBLE, i, MPI_COMM_WORLD);
-                        MPI_Bcast (&chisq[talls[i]], 1, MPI_DOUBLE, i, MPI_COMM_WORLD);
-                        MPI_Bcast (&mult[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                        MPI_Bcast (&count[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                        MPI_Bcast (&ranks[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                        MPI_Bcast (&ids[talls[i]], 1, MPI_UNSIGNED_LONG_LONG, i, MPI_COMM_WORLD);
+                        for (auto &&row : covT) stats.insert(stats.end(), row.begin(), row.end());
+                        for (auto &&row : avgT) stats.insert(stats.end(), row.begin(), row.end());
+                        stats.insert(stats.end(), W.begin(), W.end());
+                        stats.insert(stats.end(), avgTot.begin(), avgTot.end());
+                        stats.push_back(ttotal);
                     }
+                    stats.resize(2*(NChains + 1)*dimension + 1);
+                    MPI_Bcast (c_ptr(stats), stats.size(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+                    auto it = stats.begin();
+                    for (auto &&row : covT) for (auto &&x : row) x = *it++;
+                    for (auto &&row : avgT) for (auto &&x : row) x = *it++;
+                    for (auto &&x : W) x = *it++;
+                    for (auto &&x : avgTot) x = *it++;
+                    ttotal = int(*it);
                 #endif
             }
             else
@@ -231,10 +430,18 @@ namespace Gambit
                 };
                 
                 #ifdef WITH_MPI
-                    bool quit_buf;
-                    MPI_Barrier(MPI_COMM_WORLD);
-                    MPI_Allreduce (&quit, &quit_buf, 1, MPI_C_BOOL, MPI_LOR, MPI_COMM_WORLD);
-                    quit = quit_buf;
+                    // Share the initial chains and any quit signals
+                    std::vector<int> init_chains(numtasks, 0), init_sizes(numtasks);
+                    for (int i = 0; i < NChains; i++) init_chains[loop_ranks[i]]++;
+                    for (int r = 0; r < numtasks; r++)
+                        init_sizes[r] = exchange.block_size(init_chains[r], r == 0 ? nctrl : 0);
+
+                    exchange.begin(quit, false);
+                    for (int i = 0; i < NChains; i++)
+                        if (loop_ranks[i] == rank) add_chain(i);
+                    add_control();
+                    exchange.exchange(init_sizes);
+                    read_chains(init_chains);
                 #endif
                 
                 if(quit)
@@ -249,17 +456,6 @@ namespace Gambit
                     resumed = true;
                 
                 //std::cout << loop_ranks << std::endl;
-                
-#ifdef WITH_MPI
-                for (int i = 0; i < NChains; i++)
-                {
-                    MPI_Barrier(MPI_COMM_WORLD);
-                    MPI_Bcast (c_ptr(a0[i]), a0[i].size(), MPI_DOUBLE, loop_ranks[i], MPI_COMM_WORLD);
-                    MPI_Bcast (&chisq[i], 1, MPI_DOUBLE, loop_ranks[i], MPI_COMM_WORLD);
-                    MPI_Bcast (&ranks[i], 1, MPI_INT, loop_ranks[i], MPI_COMM_WORLD);
-                    MPI_Bcast (&ids[i], 1, MPI_UNSIGNED_LONG_LONG, loop_ranks[i], MPI_COMM_WORLD);
-                }
-#endif
             }
 
 /*#ifdef WITH_MPI
@@ -271,30 +467,14 @@ namespace Gambit
 
             std::cout << "Metropolis Hastings/TWalk Algorithm Started"  << std::endl;
 
+            // Time the steps of this run, for the time per step reported at the end
+            const auto startSteps = std::chrono::steady_clock::now();
+            const int firstStep = total;
+
             while (not converged and not quit)
             {
                 #ifdef WITH_MPI
-                    if (rank == 0)
-                    {
-                        int j = NChains;
-                        for(int i = 0; i < numtasks; i++)
-                        {
-                            int temp = int((j--)*gDev[0]->Doub());
-                            talls[i] = tints[temp];
-                            tints[temp] = tints[j];
-                            tints[j] = talls[i];
-                        }
-
-                        for(int i = numtasks, end = talls.size(); i < end; i++)
-                        {
-                            talls[i] = tints[int(j*gDev[0]->Doub())];
-                        }
-                    }
-
-                    MPI_Barrier(MPI_COMM_WORLD);
-                    MPI_Bcast (c_ptr(talls), talls.size(), MPI_INT, 0, MPI_COMM_WORLD);
-                    MPI_Bcast (c_ptr(tints), tints.size(), MPI_INT, 0, MPI_COMM_WORLD);
-
+                    // The chain assignments for this step arrived with the last exchange
                     t = talls[rank];
                     tt = talls[rank + numtasks];
                     double logZ = gDev[t]->Dev(aNext, a0, t, tt, NChains - numtasks, tints);// t -> 0
@@ -333,17 +513,30 @@ namespace Gambit
                     }
                 }
 
+                // Check if the requested maximum runtime has been reached.
+                bool timeout = false;
+                if (mins_max > 0 and rank == 0)
+                {
+                    std::chrono::duration<double> runtime = std::chrono::system_clock::now() - startTWalk;
+                    double runtime_ms = std::chrono::duration_cast<std::chrono::milliseconds>(runtime).count();
+                    if (runtime_ms / 60e3 >= mins_max)
+                    {
+                       std::cout << "TWalk reached requested time limit of " << mins_max << " minutes.  Finalising run now." << std::endl;
+                       timeout = true;
+                    }
+                }
+
+                quit = Gambit::Scanner::Plugins::plugin_info.early_shutdown_in_progress();
+
                 #ifdef WITH_MPI
-                  for (int i = 0; i < numtasks; i++)
-                  {
-                      MPI_Barrier(MPI_COMM_WORLD);
-                      MPI_Bcast (c_ptr(a0[talls[i]]), a0[talls[i]].size(), MPI_DOUBLE, i, MPI_COMM_WORLD);
-                      MPI_Bcast (&chisq[talls[i]], 1, MPI_DOUBLE, i, MPI_COMM_WORLD);
-                      MPI_Bcast (&mult[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                      MPI_Bcast (&count[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                      MPI_Bcast (&ranks[talls[i]], 1, MPI_INT, i, MPI_COMM_WORLD);
-                      MPI_Bcast (&ids[talls[i]], 1, MPI_UNSIGNED_LONG_LONG, i, MPI_COMM_WORLD);
-                  }
+                    // One exchange per step: the updated chains, quit and timeout signals, and the
+                    // chain assignments for the next step
+                    exchange.begin(quit, timeout);
+                    add_chain(t);
+                    add_control();
+                    exchange.exchange(step_sizes);
+                    timeout = exchange.stop(0);
+                    read_chains(step_chains);
                 #endif
 
                 for (int l = 0; l < NChains; l++) mult[l]++;
@@ -356,7 +549,7 @@ namespace Gambit
                     //out_stream->reset();
                 }
 
-                if (rank == 0)
+                // Every process holds all chains, so all track the convergence statistics identically
                 {
                     int cnt = 0;
                     for (auto it = count.begin(); it != count.end(); ++it)
@@ -407,20 +600,10 @@ namespace Gambit
                         }
                     }
 
-                    // Check if the requested maximum runtime has been reached.
-                    if (mins_max > 0)
-                    {
-                        std::chrono::duration<double> runtime = std::chrono::system_clock::now() - startTWalk;
-                        double runtime_ms = std::chrono::duration_cast<std::chrono::milliseconds>(runtime).count();
-                        if (runtime_ms / 60e3 >= mins_max)
-                        {
-                           std::cout << "TWalk reached requested time limit of " << mins_max << " minutes.  Finalising run now." << std::endl;
-                           converged = true;
-                        }
-                    }
+                    if (timeout) converged = true;
 
                     // Print out progress to stdout
-                    if (converged or cnt % 100 == 0)
+                    if (rank == 0 and (converged or cnt % 100 == 0))
                     {
                         std::cout << "Points = " << cnt  << " (" << cnt/double(NChains) << " per chain)" << std::endl;
                         std::cout << "\tAcceptance ratio = " << (double)cnt/(double)total/(double)numtasks << std::endl;
@@ -430,21 +613,6 @@ namespace Gambit
 
                 }
 
-                quit = Gambit::Scanner::Plugins::plugin_info.early_shutdown_in_progress();
-                /*#ifdef WITH_MPI
-                    MPI_Barrier(MPI_COMM_WORLD);
-                    MPI_Bcast (&converged, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
-                    MPI_Bcast (&quit, 1, MPI_UNSIGNED, 0, MPI_COMM_WORLD);
-                #endif*/
-                    
-                #ifdef WITH_MPI
-                    bool quit_buf;
-                    MPI_Barrier(MPI_COMM_WORLD);
-                    MPI_Bcast (&converged, 1, MPI_C_BOOL, 0, MPI_COMM_WORLD);
-                    MPI_Allreduce (&quit, &quit_buf, 1, MPI_C_BOOL, MPI_LOR, MPI_COMM_WORLD);
-                    quit = quit_buf;
-                #endif
-                
                 if(quit)
                 {
                    std::cout
@@ -455,6 +623,13 @@ namespace Gambit
                 }
             }
 
+            if (rank == 0 and total > firstStep)
+            {
+                std::chrono::duration<double> stepsTime = std::chrono::steady_clock::now() - startSteps;
+                std::cout << "TWalk took " << total - firstStep << " steps with " << numtasks << " processes in " << stepsTime.count()
+                          << " s (" << 1e3*stepsTime.count()/(total - firstStep) << " ms per step)." << std::endl;
+            }
+
             if(quit)
             {
                 std::cout
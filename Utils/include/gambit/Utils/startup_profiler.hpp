@@ -0,0 +1,123 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Wall-clock profiler for the phases of GAMBIT
+///  start-up (plugin loading, backend loading,
+///  dependency resolution, etc.).
+///
+///  Phases may be nested, and are recorded as a
+///  timing tree.  Recording is always on, as it
+///  only costs a couple of clock reads per phase;
+///  the tree is only reported when GAMBIT is run
+///  with --profile-startup.
+///
+///  Usage:
+///
+///   {
+///     Utils::profile_phase phase("Dependency resolution");
+///     /* Do things. Nested profile_phase objects
+///        become children of this phase. */
+///   }
+///   cout << Utils::startupProfiler().report();
+///
+///  A phase that sets up objects that must outlive
+///  it is closed early with profile_phase::end().
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#ifndef __startup_profiler_hpp__
+#define __startup_profiler_hpp__
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "gambit/Utils/export_symbols.hpp"
+
+namespace Gambit
+{
+  namespace Utils
+  {
+
+    /// Timing tree of start-up phases
+    class startup_profiler
+    {
+      public:
+
+        /// Constructor
+        startup_profiler();
+
+        /// Open a new phase, as a child of the innermost phase currently open
+        void begin(const std::string&);
+
+        /// Close the innermost phase currently open
+        void end();
+
+        /// Return the timing tree as a formatted table
+        std::string report() const;
+
+      private:
+
+        typedef std::chrono::time_point<std::chrono::steady_clock> time_point;
+
+        /// A single phase in the tree
+        struct phase
+        {
+          std::string name;
+          int parent;
+          time_point start;
+          double seconds;
+          bool open;
+        };
+
+        /// All phases, in the order that they were opened
+        std::vector<phase> phases;
+
+        /// Indices of the phases currently open, innermost last
+        std::vector<int> stack;
+
+        /// Time at which the profiler was created
+        const time_point created;
+
+        /// Mutex protecting the tree, in case phases are opened from more than one thread
+        mutable std::mutex mtx;
+
+    };
+
+    /// Accessor for the global start-up profiler
+    EXPORT_SYMBOLS startup_profiler& startupProfiler();
+
+    /// Times a start-up phase for the lifetime of the object, or until end() is called
+    /// (for phases that set up objects that must outlive them)
+    class profile_phase
+    {
+      public:
+        profile_phase(const std::string& name) : open(true) { startupProfiler().begin(name); }
+        ~profile_phase() { end(); }
+        profile_phase(const profile_phase&) = delete;
+        profile_phase& operator=(const profile_phase&) = delete;
+
+        /// Close the phase now
+        void end()
+        {
+          if (open) startupProfiler().end();
+          open = false;
+        }
+
+      private:
+        bool open;
+    };
+
+  }
+}
+
+#endif
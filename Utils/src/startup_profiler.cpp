@@ -0,0 +1,97 @@
+//   GAMBIT: Global and Modular BSM Inference Tool
+//   *********************************************
+///  \file
+///
+///  Wall-clock profiler for the phases of GAMBIT
+///  start-up.
+///
+///  *********************************************
+///
+///  Authors (add name and date if you modify):
+///
+///  \author The GAMBIT Collaboration
+///  \date 2026 Oct
+///
+///  *********************************************
+
+#include <iomanip>
+#include <sstream>
+
+#include "gambit/Utils/startup_profiler.hpp"
+
+namespace Gambit
+{
+  namespace Utils
+  {
+
+    /// Constructor
+    startup_profiler::startup_profiler() : created(std::chrono::steady_clock::now()) {}
+
+    /// Open a new phase, as a child of the innermost phase currently open
+    void startup_profiler::begin(const std::string& name)
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      int parent = (stack.empty() ? -1 : stack.back());
+      phases.push_back(phase{name, parent, std::chrono::steady_clock::now(), 0.0, true});
+      stack.push_back(phases.size()-1);
+    }
+
+    /// Close the innermost phase currently open
+    void startup_profiler::end()
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      if (stack.empty()) return;
+      phase& p = phases[stack.back()];
+      p.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - p.start).count();
+      p.open = false;
+      stack.pop_back();
+    }
+
+    /// Return the timing tree as a formatted table
+    std::string startup_profiler::report() const
+    {
+      std::lock_guard<std::mutex> lock(mtx);
+      const double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - created).count();
+      const int width = 60;
+
+      // Work out the depth of each phase (parents always precede their children)
+      std::vector<int> depth(phases.size(), 0);
+      for (size_t i = 0; i < phases.size(); ++i)
+      {
+        if (phases[i].parent >= 0) depth[i] = depth[phases[i].parent] + 1;
+      }
+
+      // Print each phase directly after its parent, in depth-first order
+      std::ostringstream ss;
+      ss << std::fixed << std::setprecision(3);
+      ss << std::left << std::setw(width) << "Start-up phase" << "  Wall time [s]" << std::endl;
+      ss << std::string(width + 15, '-') << std::endl;
+      std::vector<int> to_print;
+      for (int i = phases.size() - 1; i >= 0; --i) if (phases[i].parent < 0) to_print.push_back(i);
+      while (not to_print.empty())
+      {
+        int i = to_print.back();
+        to_print.pop_back();
+        const phase& p = phases[i];
+        std::string label = std::string(2*depth[i], ' ') + p.name;
+        if (label.size() > size_t(width)) label = label.substr(0, width);
+        ss << std::left << std::setw(width) << label << "  " << std::right << std::setw(13);
+        if (p.open) ss << "(running)";
+        else ss << p.seconds;
+        ss << std::endl;
+        for (int j = phases.size() - 1; j > i; --j) if (phases[j].parent == i) to_print.push_back(j);
+      }
+      ss << std::string(width + 15, '-') << std::endl;
+      ss << std::left << std::setw(width) << "Total since start-up" << "  " << std::right << std::setw(13) << total << std::endl;
+      return ss.str();
+    }
+
+    /// Accessor for the global start-up profiler
+    startup_profiler& startupProfiler()
+    {
+      static startup_profiler local;
+      return local;
+    }
+
+  }
+}
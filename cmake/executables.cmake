@@ -49,6 +49,11 @@ if(EXISTS "${PROJECT_SOURCE_DIR}/Core/")
   )
   set_target_properties(gambit PROPERTIES EXCLUDE_FROM_ALL 0)
 
+  # Make sure that the executable carries a build ID, which identifies it in the dependency resolution cache
+  if(CMAKE_SYSTEM_NAME STREQUAL "Linux")
+    target_link_options(gambit PRIVATE "LINKER:--build-id")
+  endif()
+
   # EXPERIMENTAL: Linking against Electric Fence for heap corruption debugging
   #target_link_libraries(gambit PUBLIC efence) # just segfaults. Be good if it could be made to work though.
 endif()
@@ -69,3 +74,94 @@ if(HDF5_FOUND)
 endif()
 
 
+
+# Add the benchmarks and consistency checks of individual components. These are not built by
+# default; 'make benchmarks' and 'make checks' build them all in the build directory.
+add_custom_target(benchmarks)
+add_custom_target(checks)
+if(EXISTS "${PROJECT_SOURCE_DIR}/Elements/")
+  add_gambit_executable(benchmark_functor_calculate "${gambit_XTRA}"
+                        SOURCES ${PROJECT_SOURCE_DIR}/Elements/standalone/benchmark_functor_calculate.cpp
+                                ${PROJECT_SOURCE_DIR}/Core/src/functors_with_signals.cpp
+                                ${GAMBIT_ALL_COMMON_OBJECTS}
+                                $<TARGET_OBJECTS:Printers>
+  )
+  set_target_properties(benchmark_functor_calculate PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_dependencies(benchmarks benchmark_functor_calculate)
+endif()
+if(HDF5_FOUND AND EXISTS "${PROJECT_SOURCE_DIR}/Printers/")
+  add_gambit_executable(benchmark_hdf5printer_v2 ${HDF5_LIBRARIES}
+                        SOURCES ${PROJECT_SOURCE_DIR}/Printers/standalone/benchmark_hdf5printer_v2.cpp
+                                $<TARGET_OBJECTS:Printers>
+                                ${GAMBIT_BASIC_COMMON_OBJECTS}
+  )
+  set_target_properties(benchmark_hdf5printer_v2 PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_dependencies(benchmarks benchmark_hdf5printer_v2)
+  if(WITH_MPI AND MPIEXEC_EXECUTABLE)
+    # With MPI, the benchmark also checks that every way of writing the output of several processes gives the same file
+    add_custom_target(run_check_hdf5printer_v2_mpi COMMAND ${MPIEXEC_EXECUTABLE} ${MPIEXEC_NUMPROC_FLAG} 4 ${MPIEXEC_PREFLAGS} $<TARGET_FILE:benchmark_hdf5printer_v2> 40000 ${MPIEXEC_POSTFLAGS})
+    add_dependencies(run_check_hdf5printer_v2_mpi benchmark_hdf5printer_v2)
+    add_dependencies(checks run_check_hdf5printer_v2_mpi)
+  endif()
+  add_gambit_executable(check_hdf5printer_v2_bits ${HDF5_LIBRARIES}
+                        SOURCES ${PROJECT_SOURCE_DIR}/Printers/standalone/check_hdf5printer_v2_bits.cpp
+                                $<TARGET_OBJECTS:Printers>
+                                ${GAMBIT_BASIC_COMMON_OBJECTS}
+  )
+  set_target_properties(check_hdf5printer_v2_bits PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_custom_target(run_check_hdf5printer_v2_bits COMMAND $<TARGET_FILE:check_hdf5printer_v2_bits>)
+  add_dependencies(run_check_hdf5printer_v2_bits check_hdf5printer_v2_bits)
+  add_dependencies(checks run_check_hdf5printer_v2_bits)
+endif()
+if(EXISTS "${PROJECT_SOURCE_DIR}/Printers/")
+  add_gambit_executable(check_arrowipc "${HDF5_LIBRARIES}"
+                        SOURCES ${PROJECT_SOURCE_DIR}/Printers/standalone/check_arrowipc.cpp
+                                $<TARGET_OBJECTS:Printers>
+                                ${GAMBIT_BASIC_COMMON_OBJECTS}
+  )
+  set_target_properties(check_arrowipc PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_custom_target(run_check_arrowipc COMMAND $<TARGET_FILE:check_arrowipc>)
+  add_dependencies(run_check_arrowipc check_arrowipc)
+  add_dependencies(checks run_check_arrowipc)
+endif()
+if(SQLite3_FOUND AND EXISTS "${PROJECT_SOURCE_DIR}/Printers/")
+  add_gambit_executable(benchmark_sqliteprinter "${HDF5_LIBRARIES}"
+                        SOURCES ${PROJECT_SOURCE_DIR}/Printers/standalone/benchmark_sqliteprinter.cpp
+                                $<TARGET_OBJECTS:Printers>
+                                ${GAMBIT_BASIC_COMMON_OBJECTS}
+  )
+  set_target_properties(benchmark_sqliteprinter PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_dependencies(benchmarks benchmark_sqliteprinter)
+endif()
+if(EXISTS "${PROJECT_SOURCE_DIR}/ScannerBit/")
+  add_gambit_executable(benchmark_cholesky ""
+                        SOURCES ${PROJECT_SOURCE_DIR}/ScannerBit/standalone/benchmark_cholesky.cpp
+  )
+  set_target_properties(benchmark_cholesky PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_dependencies(benchmarks benchmark_cholesky)
+  add_gambit_executable(check_prior_math ""
+                        SOURCES ${PROJECT_SOURCE_DIR}/ScannerBit/standalone/check_prior_math.cpp
+  )
+  set_target_properties(check_prior_math PROPERTIES RUNTIME_OUTPUT_DIRECTORY "${CMAKE_BINARY_DIR}")
+  add_custom_target(run_check_prior_math COMMAND $<TARGET_FILE:check_prior_math>)
+  add_dependencies(run_check_prior_math check_prior_math)
+  add_dependencies(checks run_check_prior_math)
+endif()
+if(EXISTS "${PROJECT_SOURCE_DIR}/Core/")
+  add_custom_target(check_incremental_recomputation
+                    COMMAND ${PYTHON_EXECUTABLE} ${PROJECT_SOURCE_DIR}/Core/scripts/check_incremental_recomputation.py $<TARGET_FILE:${PROJECT_NAME}>
+                    WORKING_DIRECTORY ${PROJECT_SOURCE_DIR})
+  add_dependencies(check_incremental_recomputation ${PROJECT_NAME})
+  add_dependencies(checks check_incremental_recomputation)
+endif()
+if(WITH_MPI AND MPIEXEC_EXECUTABLE AND EXISTS "${PROJECT_SOURCE_DIR}/ScannerBit/")
+  # Runs up to 512 processes, so it is not part of the benchmarks target; set TWALK_RANKS to choose the numbers of processes
+  if(NOT TWALK_RANKS)
+    set(TWALK_RANKS "8,16,32,64,128,256,512")
+  endif()
+  add_custom_target(benchmark_twalk_scaling
+                    COMMAND ${PYTHON_EXECUTABLE} ${PROJECT_SOURCE_DIR}/ScannerBit/scripts/benchmark_twalk_scaling.py $<TARGET_FILE:${PROJECT_NAME}>
+                            --ranks ${TWALK_RANKS} --mpiexec "${MPIEXEC_EXECUTABLE} ${MPIEXEC_PREFLAGS}"
+                    WORKING_DIRECTORY ${PROJECT_SOURCE_DIR})
+  add_dependencies(benchmark_twalk_scaling ${PROJECT_NAME})
+endif()
@@ -228,6 +228,9 @@ if(HDF5_FOUND)
       set(CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DH5_USE_110_API")
   endif()
   message("   Found HDF5 libraries: ${HDF5_LIBRARIES}")
+  if(HDF5_IS_PARALLEL)
+    message("   HDF5 library supports parallel I/O; the hdf5 printer can use collective writes.")
+  endif()
   if(VERBOSE)
     message(STATUS ${HDF5_INCLUDE_DIRS} ${HDF5_INCLUDE_DIR})
   endif()